@@ -0,0 +1,168 @@
+#ifndef AFFINE_3X4_H_INCLUDED
+#define AFFINE_3X4_H_INCLUDED
+
+#include <Vec3.h>
+#include <Vec4.h>
+#include <Mat4.h>
+#include <Transform.h>
+
+#define AFFINE_EPSILON 0.000001f
+
+// A Mat4 without its bottom row, which is always (0, 0, 0, 1) for
+// rotation, scale and translation. Stored row by row, so each row is a
+// vec4 and an array uploads as GLSL mat3x4 (three vec4 columns) with
+// no transpose; multiply as vec4(p, 1.0) * m in the shader.
+struct Affine3x4
+{
+    union {
+        float v[12];
+        struct {
+            Vec4 row0;
+            Vec4 row1;
+            Vec4 row2;
+        } rows;
+        // row-column notation; column 3 is the translation
+        struct {
+            float r0c0; float r0c1; float r0c2; float r0c3;
+            float r1c0; float r1c1; float r1c2; float r1c3;
+            float r2c0; float r2c1; float r2c2; float r2c3;
+        };
+    };
+
+    // defaults to identity
+    inline Affine3x4() :
+        r0c0(1), r0c1(0), r0c2(0), r0c3(0),
+        r1c0(0), r1c1(1), r1c2(0), r1c3(0),
+        r2c0(0), r2c1(0), r2c2(1), r2c3(0)
+    {}
+
+    inline Affine3x4(float* fv) :
+        r0c0(fv[0]), r0c1(fv[1]), r0c2(fv[2]),  r0c3(fv[3]),
+        r1c0(fv[4]), r1c1(fv[5]), r1c2(fv[6]),  r1c3(fv[7]),
+        r2c0(fv[8]), r2c1(fv[9]), r2c2(fv[10]), r2c3(fv[11])
+    {}
+
+    inline Affine3x4(float in00, float in01, float in02, float in03,
+                     float in10, float in11, float in12, float in13,
+                     float in20, float in21, float in22, float in23) :
+        r0c0(in00), r0c1(in01), r0c2(in02), r0c3(in03),
+        r1c0(in10), r1c1(in11), r1c2(in12), r1c3(in13),
+        r2c0(in20), r2c1(in21), r2c2(in22), r2c3(in23)
+    {}
+};
+
+// conversions; mat4ToAffine drops the bottom row
+inline Affine3x4 mat4ToAffine(const Mat4& m) {
+    return Affine3x4(m.r0c0, m.r0c1, m.r0c2, m.r0c3,
+                     m.r1c0, m.r1c1, m.r1c2, m.r1c3,
+                     m.r2c0, m.r2c1, m.r2c2, m.r2c3);
+}
+inline Mat4 affineToMat4(const Affine3x4& a) {
+    return Mat4(a.r0c0, a.r1c0, a.r2c0, 0.0f,
+                a.r0c1, a.r1c1, a.r2c1, 0.0f,
+                a.r0c2, a.r1c2, a.r2c2, 0.0f,
+                a.r0c3, a.r1c3, a.r2c3, 1.0f);
+}
+// same basis as transformToMat4
+inline Affine3x4 transformToAffine(const Transform& t) {
+    Vec3 x = t.rotation * Vec3(1,0,0) * t.scale.x;
+    Vec3 y = t.rotation * Vec3(0,1,0) * t.scale.y;
+    Vec3 z = t.rotation * Vec3(0,0,1) * t.scale.z;
+    Vec3 p = t.position;
+    return Affine3x4(x.x, y.x, z.x, p.x,
+                     x.y, y.y, z.y, p.y,
+                     x.z, y.z, z.z, p.z);
+}
+
+// comparison
+inline bool operator==(const Affine3x4& lhs, const Affine3x4& rhs) {
+    for (int i = 0; i < 12; i++) {
+        if (fabsf(lhs.v[i] - rhs.v[i]) > AFFINE_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+inline bool operator!=(const Affine3x4& lhs, const Affine3x4& rhs) {
+    return !(lhs == rhs);
+}
+
+// component-wise operations, for blending skin matrices
+inline Affine3x4 operator+(const Affine3x4& lhs, const Affine3x4& rhs) {
+    Affine3x4 out;
+    for (int i = 0; i < 12; i++) {
+        out.v[i] = lhs.v[i] + rhs.v[i];
+    }
+    return out;
+}
+inline Affine3x4 operator*(const Affine3x4& m, float f) {
+    Affine3x4 out;
+    for (int i = 0; i < 12; i++) {
+        out.v[i] = m.v[i] * f;
+    }
+    return out;
+}
+
+// each row of the result is b's rows weighted by a row of a, plus a's
+// translation; b's implicit bottom row only adds that translation, so
+// this is 36 multiplies instead of Mat4's 64
+inline Affine3x4 operator*(const Affine3x4& a, const Affine3x4& b) {
+    Affine3x4 out;
+    for (int row = 0; row < 3; ++row) {
+        const float* ar = &a.v[row * 4];
+        float* outRow = &out.v[row * 4];
+        for (int col = 0; col < 4; ++col) {
+            outRow[col] = ar[0] * b.v[0 * 4 + col] +
+                          ar[1] * b.v[1 * 4 + col] +
+                          ar[2] * b.v[2 * 4 + col];
+        }
+        outRow[3] += ar[3];
+    }
+    return out;
+}
+
+inline Vec3 transformVector(const Affine3x4& m, const Vec3& v) {
+    return Vec3(m.r0c0 * v.x + m.r0c1 * v.y + m.r0c2 * v.z,
+                m.r1c0 * v.x + m.r1c1 * v.y + m.r1c2 * v.z,
+                m.r2c0 * v.x + m.r2c1 * v.y + m.r2c2 * v.z);
+}
+inline Vec3 transformPoint(const Affine3x4& m, const Vec3& v) {
+    return Vec3(m.r0c0 * v.x + m.r0c1 * v.y + m.r0c2 * v.z + m.r0c3,
+                m.r1c0 * v.x + m.r1c1 * v.y + m.r1c2 * v.z + m.r1c3,
+                m.r2c0 * v.x + m.r2c1 * v.y + m.r2c2 * v.z + m.r2c3);
+}
+
+// inverts the 3x3 part and moves the translation back through it;
+// a singular matrix returns the identity, like inverse(Mat4)
+inline Affine3x4 inverse(const Affine3x4& m) {
+    // cofactors of the 3x3 part
+    float c00 = m.r1c1 * m.r2c2 - m.r1c2 * m.r2c1;
+    float c01 = m.r1c2 * m.r2c0 - m.r1c0 * m.r2c2;
+    float c02 = m.r1c0 * m.r2c1 - m.r1c1 * m.r2c0;
+    float det = m.r0c0 * c00 + m.r0c1 * c01 + m.r0c2 * c02;
+    if (det == 0.0f) {
+        return Affine3x4();
+    }
+    float inv = 1.0f / det;
+
+    Affine3x4 out(
+        c00 * inv,
+        (m.r0c2 * m.r2c1 - m.r0c1 * m.r2c2) * inv,
+        (m.r0c1 * m.r1c2 - m.r0c2 * m.r1c1) * inv,
+        0.0f,
+        c01 * inv,
+        (m.r0c0 * m.r2c2 - m.r0c2 * m.r2c0) * inv,
+        (m.r0c2 * m.r1c0 - m.r0c0 * m.r1c2) * inv,
+        0.0f,
+        c02 * inv,
+        (m.r0c1 * m.r2c0 - m.r0c0 * m.r2c1) * inv,
+        (m.r0c0 * m.r1c1 - m.r0c1 * m.r1c0) * inv,
+        0.0f);
+    Vec3 t = transformVector(out, Vec3(m.r0c3, m.r1c3, m.r2c3));
+    out.r0c3 = -t.x;
+    out.r1c3 = -t.y;
+    out.r2c3 = -t.z;
+    return out;
+}
+
+#endif // AFFINE_3X4_H_INCLUDED
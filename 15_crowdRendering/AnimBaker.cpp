@@ -1,26 +1,208 @@
 #include <AnimBaker.h>
+#include <TypedClip.h>
+#include <iostream>
 
-void BakeAnimationTexture(Skeleton& skel, Clip& clip, AnimTexture& outTex)
+void BakeAnimationTexture(const Skeleton& skel, const Clip& clip, AnimTexture& outTex)
 {
-    Pose& bindPose = skel.GetBindPose();
-    Pose pose = bindPose;
+    BakeAnimationData(skel, clip, outTex);
+    outTex.UploadToGPU();
+}
+
+// runs bake over [0, count), split across jobs if there are any
+static void BakeColumns(JobSystem* jobs, const char* name, unsigned int count,
+                        const JobSystem::RangeTask& bake)
+{
+    if (jobs != nullptr) {
+        jobs->ParallelFor(name, count, 0, bake);
+    } else {
+        bake(0, count);
+    }
+}
+
+void BakeAnimationData(const Skeleton& skel, const Clip& clip, AnimTexture& outTex, JobSystem* jobs)
+{
+    // one sample per column; the typed clip has no per track dispatch
+    TypedClip typed;
+    typed.Set(clip);
+    unsigned int texWidth = outTex.GetSize();
+    BakeColumns(jobs, "BakeAnimationData", texWidth, [&](unsigned int begin, unsigned int end) {
+        Pose pose = skel.GetBindPose();
+        for (unsigned int x = begin; x < end; ++x)
+        {
+            float t = (float)x / (float)(texWidth - 1);
+            float start = clip.GetStartTime();
+            float time = start + clip.GetDuration() * t;
+            typed.Sample(pose, time);
+
+            for (unsigned int y = 0; y < pose.GetSize() * 3; y += 3)
+            {
+                Transform node = pose.GetGlobalTransform(y / 3);
+                outTex.SetTexel(x, y+0, node.position);
+                outTex.SetTexel(x, y+1, node.rotation);
+                outTex.SetTexel(x, y+2, node.scale);
+            }
+        }
+    });
+}
+
+void BakeSkinMatrixTexture(const Skeleton& skel, const Clip& clip, AnimTexture& outTex)
+{
+    BakeSkinMatrixData(skel, clip, outTex);
+    outTex.UploadToGPU();
+}
+
+void BakeSkinMatrixData(const Skeleton& skel, const Clip& clip, AnimTexture& outTex, JobSystem* jobs)
+{
+    TypedClip typed;
+    typed.Set(clip);
+    std::vector<Affine3x4> invBindPose;
+    skel.GetInvBindPose(invBindPose);
     unsigned int texWidth = outTex.GetSize();
-    for (unsigned int x = 0; x < texWidth; ++x)
-    {
-        float t = (float)x / (float)(texWidth - 1);
-        float start = clip.GetStartTime();
-        float time = start + clip.GetDuration() * t;
-        clip.Sample(pose, time);
-
-        for (unsigned int y = 0; y < pose.GetSize() * 3; y += 3)
+    BakeColumns(jobs, "BakeSkinMatrixData", texWidth, [&](unsigned int begin, unsigned int end) {
+        Pose pose = skel.GetBindPose();
+        std::vector<Affine3x4> palette;
+        for (unsigned int x = begin; x < end; ++x)
         {
-            Transform node = pose.GetGlobalTransform(y / 3);
-            outTex.SetTexel(x, y+0, node.position);
-            outTex.SetTexel(x, y+1, node.rotation);
-            outTex.SetTexel(x, y+2, node.scale);
+            float t = (float)x / (float)(texWidth - 1);
+            float start = clip.GetStartTime();
+            float time = start + clip.GetDuration() * t;
+            typed.Sample(pose, time);
+            pose.GetAffinePalette(palette);
+
+            for (unsigned int y = 0; y < pose.GetSize() * 3; y += 3)
+            {
+                // one row per texel; the bottom row is always (0, 0, 0, 1)
+                Affine3x4 skin = palette[y / 3] * invBindPose[y / 3];
+                outTex.SetTexel(x, y+0, skin.rows.row0);
+                outTex.SetTexel(x, y+1, skin.rows.row1);
+                outTex.SetTexel(x, y+2, skin.rows.row2);
+            }
+        }
+    });
+}
+
+Mat4 SampleSkinMatrix(AnimTexture& tex, unsigned int joint, float column)
+{
+    unsigned int last = tex.GetSize() - 1;
+    if (column < 0.0f) { column = 0.0f; }
+    if (column > (float)last) { column = (float)last; }
+    unsigned int x0 = (unsigned int)column;
+    unsigned int x1 = (x0 < last) ? x0 + 1 : last;
+    float t = column - (float)x0;
+
+    Vec4 rows[3];
+    for (unsigned int r = 0; r < 3; ++r) {
+        Vec4 a = tex.GetTexel(x0, joint * 3 + r);
+        Vec4 b = tex.GetTexel(x1, joint * 3 + r);
+        rows[r] = Vec4(a.x + (b.x - a.x) * t,
+                       a.y + (b.y - a.y) * t,
+                       a.z + (b.z - a.z) * t,
+                       a.w + (b.w - a.w) * t);
+    }
+
+    return Mat4(rows[0].x, rows[1].x, rows[2].x, 0.0f,
+                rows[0].y, rows[1].y, rows[2].y, 0.0f,
+                rows[0].z, rows[1].z, rows[2].z, 0.0f,
+                rows[0].w, rows[1].w, rows[2].w, 1.0f);
+}
+
+void SkinVertexBaked(AnimTexture& tex, float column,
+                     const Vec3& position, const Vec3& normal,
+                     const Vec4& weights, const iVec4& joints,
+                     Vec3& outPosition, Vec3& outNormal)
+{
+    // skin matrices are blended directly, as in Mesh::CPUSkin
+    Mat4 skin = SampleSkinMatrix(tex, joints.x, column) * weights.x +
+                SampleSkinMatrix(tex, joints.y, column) * weights.y +
+                SampleSkinMatrix(tex, joints.z, column) * weights.z +
+                SampleSkinMatrix(tex, joints.w, column) * weights.w;
+
+    outPosition = transformPoint(skin, position);
+    outNormal = transformVector(skin, normal);
+}
+
+#define VAT_MAX_TEXTURE_SIZE 8192
+
+unsigned int GetVertexAnimationTextureSize(unsigned int numVertices,
+                                           unsigned int numFrames)
+{
+    for (unsigned int size = 64; size <= VAT_MAX_TEXTURE_SIZE; size *= 2) {
+        unsigned int numBlocks = size / numFrames;
+        if (numBlocks * (size / 2) >= numVertices) {
+            return size;
         }
     }
+    return 0;
+}
 
+void BakeVertexAnimationTexture(const Skeleton& skel, const Clip& clip, Mesh& mesh,
+                                unsigned int numFrames, AnimTexture& outTex)
+{
+    BakeVertexAnimationData(skel, clip, mesh, numFrames, outTex);
     outTex.UploadToGPU();
 }
 
+void BakeVertexAnimationData(const Skeleton& skel, const Clip& clip, Mesh& mesh,
+                             unsigned int numFrames, AnimTexture& outTex,
+                             JobSystem* jobs)
+{
+    unsigned int numVerts = mesh.GetVertexCount();
+    unsigned int texSize = outTex.GetSize();
+    if (numFrames < 2 || numFrames > texSize) {
+        std::cout << __func__ << ": can't fit " << numFrames
+                  << " frames in a texture of size " << texSize << std::endl;
+        return;
+    }
+    unsigned int vertsPerBlock = texSize / 2;
+    if ((texSize / numFrames) * vertsPerBlock < numVerts) {
+        std::cout << __func__ << ": " << numVerts << " vertices don't fit, "
+                  << "use a texture of size "
+                  << GetVertexAnimationTextureSize(numVerts, numFrames)
+                  << std::endl;
+        return;
+    }
+
+    // bind pose inputs are decoded once instead of once per frame
+    std::vector<Vec3> positions(numVerts);
+    std::vector<Vec3> normals(numVerts);
+    std::vector<Vec4> weights(numVerts);
+    std::vector<iVec4> joints(numVerts);
+    for (unsigned int v = 0; v < numVerts; ++v) {
+        mesh.GetSkinningInput(v, positions[v], normals[v], weights[v], joints[v]);
+    }
+
+    TypedClip typed;
+    typed.Set(clip);
+    std::vector<Affine3x4> invBindPose;
+    skel.GetInvBindPose(invBindPose);
+    BakeColumns(jobs, "BakeVertexAnimationData", numFrames, [&](unsigned int begin, unsigned int end) {
+        Pose pose = skel.GetBindPose();
+        std::vector<Affine3x4> palette;
+        for (unsigned int f = begin; f < end; ++f)
+        {
+            float t = (float)f / (float)(numFrames - 1);
+            float time = clip.GetStartTime() + clip.GetDuration() * t;
+            typed.Sample(pose, time);
+            pose.GetAffinePalette(palette);
+            for (unsigned int i = 0, size = (unsigned int)palette.size(); i < size; ++i) {
+                palette[i] = palette[i] * invBindPose[i];
+            }
+
+            // same math as Mesh::CPUSkin
+            for (unsigned int v = 0; v < numVerts; ++v)
+            {
+                const iVec4& joint = joints[v];
+                const Vec4& weight = weights[v];
+                Affine3x4 skin = palette[joint.x] * weight.x +
+                                 palette[joint.y] * weight.y +
+                                 palette[joint.z] * weight.z +
+                                 palette[joint.w] * weight.w;
+
+                unsigned int x = (v / vertsPerBlock) * numFrames + f;
+                unsigned int y = (v % vertsPerBlock) * 2;
+                outTex.SetTexel(x, y+0, transformPoint(skin, positions[v]));
+                outTex.SetTexel(x, y+1, transformVector(skin, normals[v]));
+            }
+        }
+    });
+}
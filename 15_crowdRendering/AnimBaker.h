@@ -4,8 +4,54 @@
 #include <Skeleton.h>
 #include <Clip.h>
 #include <AnimTexture.h>
+#include <Mat4.h>
+#include <Mesh.h>
+#include <JobSystem.h>
 
-void BakeAnimationTexture(Skeleton& skel, Clip& clip, AnimTexture& outTex);
+// The Data bakers split their columns (frames for vertex animation)
+// across the threads of jobs when one is given; the result is the same.
 
-#endif // ANIM_BAKER_H_INCLUDED
+void BakeAnimationTexture(const Skeleton& skel, const Clip& clip, AnimTexture& outTex);
+// same as above without the GPU upload, so it can run on any thread
+void BakeAnimationData(const Skeleton& skel, const Clip& clip, AnimTexture& outTex,
+                       JobSystem* jobs = nullptr);
+
+// Bakes the skin matrix of each joint (global pose * inverse bind pose)
+// instead of its position, rotation and scale. The top three rows of the
+// matrix go into three texels, so the shader needs no invBindPose uniform
+// and no quaternion to matrix conversion. Used by Shaders/crowdSkinMatrix.vert
+void BakeSkinMatrixTexture(const Skeleton& skel, const Clip& clip, AnimTexture& outTex);
+void BakeSkinMatrixData(const Skeleton& skel, const Clip& clip, AnimTexture& outTex,
+                        JobSystem* jobs = nullptr);
+
+// CPU reference of what crowdSkinMatrix.vert reads and computes.
+// column is a fractional texture column; neighbouring columns are blended
+// the way the GPU's linear filter does.
+Mat4 SampleSkinMatrix(AnimTexture& tex, unsigned int joint, float column);
+void SkinVertexBaked(AnimTexture& tex, float column,
+                     const Vec3& position, const Vec3& normal,
+                     const Vec4& weights, const iVec4& joints,
+                     Vec3& outPosition, Vec3& outNormal);
 
+// Vertex animation texture: the mesh is skinned on the CPU at numFrames
+// evenly spaced times and the resulting position and normal of every
+// vertex are stored, so Shaders/crowdVAT.vert needs no skeleton at all.
+// Meant for small, far away LOD meshes since the texture grows with the
+// vertex count. Vertex v of frame f is at
+//   x = (v / (size / 2)) * numFrames + f
+//   y = (v % (size / 2)) * 2 (+1 for the normal)
+// Doesn't touch the GPU and gives the same result on every run, so it can
+// be used by offline tools. Play it back with Crowd::Update(dt, clip, numFrames).
+// Sample doesn't draw with it yet: it has no far LOD mesh, and the full
+// Woman.gltf mesh needs a 1024 x 1024 texture for 32 frames. main --vat N
+// checks the bake against Mesh::CPUSkin headless.
+void BakeVertexAnimationTexture(const Skeleton& skel, const Clip& clip, Mesh& mesh,
+                                unsigned int numFrames, AnimTexture& outTex);
+void BakeVertexAnimationData(const Skeleton& skel, const Clip& clip, Mesh& mesh,
+                             unsigned int numFrames, AnimTexture& outTex,
+                             JobSystem* jobs = nullptr);
+// smallest power of two texture size that fits the mesh, 0 if none does
+unsigned int GetVertexAnimationTextureSize(unsigned int numVertices,
+                                           unsigned int numFrames);
+
+#endif // ANIM_BAKER_H_INCLUDED
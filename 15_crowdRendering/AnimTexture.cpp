@@ -6,14 +6,14 @@ AnimTexture::AnimTexture()
 {
     data = nullptr;
     size = 0;
-    glGenTextures(1, &id);
+    id = 0;
 }
 
 AnimTexture::AnimTexture(const AnimTexture& other)
 {
     data = nullptr;
     size = 0;
-    glGenTextures(1, &id);
+    id = 0;
     *this = other;
 }
 
@@ -22,7 +22,9 @@ AnimTexture::~AnimTexture()
     if (data != nullptr) {
         delete[] data;
     }
-    glDeleteTextures(1, &id);
+    if (id != 0) {
+        glDeleteTextures(1, &id);
+    }
 }
 
 AnimTexture& AnimTexture::operator=(const AnimTexture& other)
@@ -60,21 +62,34 @@ void AnimTexture::Save(const char* path)
 }
 
 void AnimTexture::Load(const char* path)
+{
+    if (LoadData(path)) {
+        UploadToGPU();
+    }
+}
+
+bool AnimTexture::LoadData(const char* path)
 {
     std::ifstream file(path, std::ios::in | std::ios::binary);
     if (!file.is_open()) {
         std::cerr << __func__ << ": failed to open " << path << std::endl;
-        return;
+        return false;
+    }
+    if (data != nullptr) {
+        delete[] data;
     }
     file >> size;
     data = new float[size * size * 4];
     file.read((char*)data, sizeof(float) * size * size * 4);
     file.close();
-    UploadToGPU();
+    return true;
 }
 
 void AnimTexture::UploadToGPU()
 {
+    if (id == 0) {
+        glGenTextures(1, &id);
+    }
     glBindTexture(GL_TEXTURE_2D, id);
     glTexImage2D(GL_TEXTURE_2D,
                  0,
@@ -136,6 +151,15 @@ void AnimTexture::SetTexel(unsigned int x, unsigned int y, const Quat& q)
     data[index + 3] = q.w;
 }
 
+void AnimTexture::SetTexel(unsigned int x, unsigned int y, const Vec4& v)
+{
+    unsigned int index = (y * size * 4) + (x * 4);
+    data[index + 0] = v.x;
+    data[index + 1] = v.y;
+    data[index + 2] = v.z;
+    data[index + 3] = v.w;
+}
+
 Vec4 AnimTexture::GetTexel(unsigned int x, unsigned int y)
 {
     unsigned int index = (y * size * 4) + (x * 4);
@@ -1,7 +1,7 @@
 #ifndef ANIM_TEXTURE_H_INCLUDED
 #define ANIM_TEXTURE_H_INCLUDED
 
-#include <GL/glew.h>
+#include <GLBackend.h>
 #include <stb_image.h>
 
 #include <Vec3.h>
@@ -18,9 +18,13 @@ public:
 
     AnimTexture& operator=(const AnimTexture&);
 
+    // LoadData + UploadToGPU
     void Load(const char* path);
+    // reads the file into CPU memory; doesn't need a GL context
+    bool LoadData(const char* path);
     void Save(const char* path);
 
+    // creates the GL texture on first use
     void UploadToGPU();
 
     void Resize(unsigned int newSize);
@@ -31,6 +35,7 @@ public:
 
     void SetTexel(unsigned int x, unsigned int y, const Vec3& v);
     void SetTexel(unsigned int x, unsigned int y, const Quat& q);
+    void SetTexel(unsigned int x, unsigned int y, const Vec4& v);
     Vec4  GetTexel(unsigned int x, unsigned int y);
 
     void Bind(unsigned int uniform, unsigned int texture);
@@ -0,0 +1,325 @@
+#include <AnimationWorld.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+static float MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count();
+}
+
+AnimationWorld::AnimationWorld() :
+    numJoints(0)
+{
+    stats.numCharacters = 0;
+    stats.numFading = 0;
+    stats.advanceMs = 0.0f;
+    stats.sampleMs = 0.0f;
+    stats.blendMs = 0.0f;
+    stats.globalMs = 0.0f;
+    stats.paletteMs = 0.0f;
+}
+
+void AnimationWorld::SetSkeleton(const Skeleton& skeleton)
+{
+    const Pose& restPose = skeleton.GetRestPose();
+    numJoints = restPose.GetSize();
+    parents.resize(numJoints);
+    restPositions.resize(numJoints);
+    restRotations.resize(numJoints);
+    restScales.resize(numJoints);
+    for (unsigned int j = 0; j < numJoints; ++j) {
+        parents[j] = restPose.GetParent(j);
+        Transform local = restPose.GetLocalTransform(j);
+        restPositions[j] = local.position;
+        restRotations[j] = local.rotation;
+        restScales[j] = local.scale;
+    }
+    skeleton.GetInvBindPose(invBindPose);
+
+    // glTF doesn't order parents before children, so find an order that
+    // does once instead of walking up the hierarchy for every joint
+    order.clear();
+    order.reserve(numJoints);
+    std::vector<bool> placed(numJoints, false);
+    while (order.size() < numJoints) {
+        unsigned int numPlaced = (unsigned int)order.size();
+        for (unsigned int j = 0; j < numJoints; ++j) {
+            if (!placed[j] && (parents[j] < 0 || placed[parents[j]])) {
+                order.push_back(j);
+                placed[j] = true;
+            }
+        }
+        if (order.size() == numPlaced) {
+            std::cout << __func__ << ": the joint hierarchy has a cycle" << std::endl;
+            numJoints = 0;
+            order.clear();
+            break;
+        }
+    }
+
+    clips.clear();
+    clipIds.clear();
+    times.clear();
+    fadeClipIds.clear();
+    fadeTimes.clear();
+    fadeDurations.clear();
+    fadeElapsed.clear();
+    blendWeights.clear();
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+    fadePositions.clear();
+    fadeRotations.clear();
+    fadeScales.clear();
+    globals.clear();
+    palettes.clear();
+}
+
+unsigned int AnimationWorld::AddClip(const Clip& clip, float rate)
+{
+    ResampledClip resampled;
+    ResampleReport report = resampled.Set(clip, rate);
+    for (unsigned int c = 0, size = resampled.GetNumJoints(); c < size; ++c) {
+        if (resampled.GetJoint(c) >= numJoints) {
+            std::cout << __func__ << ": " << clip.GetName() << " animates joint "
+                      << resampled.GetJoint(c) << " of a " << numJoints
+                      << " joint skeleton" << std::endl;
+            return ANIMATION_WORLD_INVALID;
+        }
+    }
+    if (report.maxPositionError > ANIMATION_WORLD_RESAMPLE_TOLERANCE ||
+        report.maxRotationError > ANIMATION_WORLD_RESAMPLE_TOLERANCE ||
+        report.maxScaleError > ANIMATION_WORLD_RESAMPLE_TOLERANCE) {
+        std::cout << __func__ << ": " << clip.GetName() << " is resampled coarsely, "
+                  << report << std::endl;
+    }
+    clips.push_back(resampled);
+    return (unsigned int)clips.size() - 1;
+}
+
+unsigned int AnimationWorld::AddCharacter(unsigned int clip, float time)
+{
+    if (clip >= clips.size()) {
+        std::cout << __func__ << ": no clip " << clip << std::endl;
+        return ANIMATION_WORLD_INVALID;
+    }
+
+    clipIds.push_back(clip);
+    times.push_back(time);
+    fadeClipIds.push_back(ANIMATION_WORLD_INVALID);
+    fadeTimes.push_back(0.0f);
+    fadeDurations.push_back(0.0f);
+    fadeElapsed.push_back(0.0f);
+    blendWeights.push_back(0.0f);
+
+    positions.insert(positions.end(), restPositions.begin(), restPositions.end());
+    rotations.insert(rotations.end(), restRotations.begin(), restRotations.end());
+    scales.insert(scales.end(), restScales.begin(), restScales.end());
+    fadePositions.insert(fadePositions.end(), restPositions.begin(), restPositions.end());
+    fadeRotations.insert(fadeRotations.end(), restRotations.begin(), restRotations.end());
+    fadeScales.insert(fadeScales.end(), restScales.begin(), restScales.end());
+    globals.resize(globals.size() + numJoints);
+    palettes.resize(palettes.size() + numJoints);
+    return (unsigned int)times.size() - 1;
+}
+
+void AnimationWorld::Play(unsigned int character, unsigned int clip, float time)
+{
+    if (clip >= clips.size()) {
+        std::cout << __func__ << ": no clip " << clip << std::endl;
+        return;
+    }
+    clipIds[character] = clip;
+    times[character] = time;
+    fadeClipIds[character] = ANIMATION_WORLD_INVALID;
+    blendWeights[character] = 0.0f;
+}
+
+void AnimationWorld::FadeTo(unsigned int character, unsigned int clip, float fadeTime)
+{
+    if (clip >= clips.size()) {
+        std::cout << __func__ << ": no clip " << clip << std::endl;
+        return;
+    }
+    if (fadeTime <= 0.0f) {
+        Play(character, clip, clips[clip].GetStartTime());
+        return;
+    }
+    // already playing or fading to it
+    if (clipIds[character] == clip && fadeClipIds[character] == ANIMATION_WORLD_INVALID) {
+        return;
+    }
+    if (fadeClipIds[character] == clip) {
+        return;
+    }
+    fadeClipIds[character] = clip;
+    fadeTimes[character] = clips[clip].GetStartTime();
+    fadeDurations[character] = fadeTime;
+    fadeElapsed[character] = 0.0f;
+    blendWeights[character] = 0.0f;
+}
+
+void AnimationWorld::Update(float dt, JobSystem* jobs)
+{
+    unsigned int numCharacters = GetNumCharacters();
+    stats.numCharacters = numCharacters;
+    stats.advanceMs = RunStage(jobs, "AnimationWorld::Advance", [this, dt](unsigned int begin, unsigned int end) {
+        Advance(dt, begin, end);
+    });
+    stats.numFading = (unsigned int)(numCharacters -
+        std::count(fadeClipIds.begin(), fadeClipIds.end(), (unsigned int)ANIMATION_WORLD_INVALID));
+    stats.sampleMs = RunStage(jobs, "AnimationWorld::SampleClips", [this](unsigned int begin, unsigned int end) {
+        SampleClips(begin, end);
+    });
+    stats.blendMs = RunStage(jobs, "AnimationWorld::CrossFade", [this](unsigned int begin, unsigned int end) {
+        CrossFade(begin, end);
+    });
+    stats.globalMs = RunStage(jobs, "AnimationWorld::BuildGlobalPose", [this](unsigned int begin, unsigned int end) {
+        BuildGlobalPose(begin, end);
+    });
+    stats.paletteMs = RunStage(jobs, "AnimationWorld::BuildPalette", [this](unsigned int begin, unsigned int end) {
+        BuildPalette(begin, end);
+    });
+}
+
+Transform AnimationWorld::GetLocalTransform(unsigned int character, unsigned int joint) const
+{
+    unsigned int i = character * numJoints + joint;
+    return Transform(positions[i], rotations[i], scales[i]);
+}
+
+// same order of events as CrossFadeController::Update
+void AnimationWorld::Advance(float dt, unsigned int begin, unsigned int end)
+{
+    for (unsigned int c = begin; c < end; ++c) {
+        if (fadeClipIds[c] != ANIMATION_WORLD_INVALID && fadeElapsed[c] >= fadeDurations[c]) {
+            clipIds[c] = fadeClipIds[c];
+            times[c] = fadeTimes[c];
+            fadeClipIds[c] = ANIMATION_WORLD_INVALID;
+            blendWeights[c] = 0.0f;
+        }
+
+        times[c] += dt;
+        if (fadeClipIds[c] != ANIMATION_WORLD_INVALID) {
+            fadeTimes[c] += dt;
+            fadeElapsed[c] += dt;
+            float t = fadeElapsed[c] / fadeDurations[c];
+            blendWeights[c] = (t > 1.0f) ? 1.0f : t;
+        }
+    }
+}
+
+void AnimationWorld::SampleClips(unsigned int begin, unsigned int end)
+{
+    for (unsigned int c = begin; c < end; ++c) {
+        unsigned int base = c * numJoints;
+        times[c] = SampleInto(clips[clipIds[c]], times[c],
+                              &positions[base], &rotations[base], &scales[base]);
+        if (fadeClipIds[c] != ANIMATION_WORLD_INVALID) {
+            fadeTimes[c] = SampleInto(clips[fadeClipIds[c]], fadeTimes[c],
+                                      &fadePositions[base], &fadeRotations[base], &fadeScales[base]);
+        }
+    }
+}
+
+float AnimationWorld::SampleInto(const ResampledClip& clip, float time,
+                                 Vec3* outPositions, Quat* outRotations, Vec3* outScales) const
+{
+    // channels the clip doesn't animate stay at rest, as they do when
+    // CrossFadeController samples over the rest pose
+    std::copy(restPositions.begin(), restPositions.end(), outPositions);
+    std::copy(restRotations.begin(), restRotations.end(), outRotations);
+    std::copy(restScales.begin(), restScales.end(), outScales);
+    if (clip.GetNumFrames() == 0) {
+        return time;
+    }
+
+    unsigned int frame = 0;
+    float t = 0.0f;
+    time = clip.Locate(time, frame, t);
+    const Transform* thisRow = clip.GetFrame(frame);
+    const Transform* nextRow = clip.GetFrame(frame + 1);
+    for (unsigned int c = 0, size = clip.GetNumJoints(); c < size; ++c) {
+        unsigned int j = clip.GetJoint(c);
+        unsigned char mask = clip.GetChannels(c);
+        if (mask & RESAMPLED_CHANNEL_POSITION) {
+            outPositions[j] = lerp(thisRow[c].position, nextRow[c].position, t);
+        }
+        if (mask & RESAMPLED_CHANNEL_ROTATION) {
+            outRotations[j] = nlerp(thisRow[c].rotation, nextRow[c].rotation, t);
+        }
+        if (mask & RESAMPLED_CHANNEL_SCALE) {
+            outScales[j] = lerp(thisRow[c].scale, nextRow[c].scale, t);
+        }
+    }
+    return time;
+}
+
+// the math of mix(Transform, Transform, float)
+void AnimationWorld::CrossFade(unsigned int begin, unsigned int end)
+{
+    for (unsigned int c = begin; c < end; ++c) {
+        if (fadeClipIds[c] == ANIMATION_WORLD_INVALID) {
+            continue;
+        }
+        float t = blendWeights[c];
+        for (unsigned int i = c * numJoints, last = i + numJoints; i < last; ++i) {
+            positions[i] = lerp(positions[i], fadePositions[i], t);
+            Quat to = fadeRotations[i];
+            if (dot(rotations[i], to) < 0.0f) {
+                to = -to;
+            }
+            rotations[i] = nlerp(rotations[i], to, t);
+            scales[i] = lerp(scales[i], fadeScales[i], t);
+        }
+    }
+}
+
+// the math of Pose::GetAffinePalette
+void AnimationWorld::BuildGlobalPose(unsigned int begin, unsigned int end)
+{
+    for (unsigned int c = begin; c < end; ++c) {
+        unsigned int base = c * numJoints;
+        for (unsigned int k = 0; k < numJoints; ++k) {
+            unsigned int j = order[k];
+            unsigned int i = base + j;
+            Affine3x4 global = transformToAffine(Transform(positions[i], rotations[i], scales[i]));
+            if (parents[j] >= 0) {
+                global = globals[base + parents[j]] * global;
+            }
+            globals[i] = global;
+        }
+    }
+}
+
+void AnimationWorld::BuildPalette(unsigned int begin, unsigned int end)
+{
+    for (unsigned int c = begin; c < end; ++c) {
+        unsigned int base = c * numJoints;
+        for (unsigned int j = 0; j < numJoints; ++j) {
+            palettes[base + j] = globals[base + j] * invBindPose[j];
+        }
+    }
+}
+
+float AnimationWorld::RunStage(JobSystem* jobs, const char* name, const JobSystem::RangeTask& stage)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    if (jobs != nullptr) {
+        jobs->ParallelFor(name, GetNumCharacters(), 0, stage);
+    } else {
+        stage(0, GetNumCharacters());
+    }
+    return MillisecondsSince(start);
+}
+
+std::ostream& operator<<(std::ostream& os, const AnimationWorldStats& stats)
+{
+    os << stats.numCharacters << " characters (" << stats.numFading << " fading), "
+       << "advance " << stats.advanceMs << " ms, sample " << stats.sampleMs << " ms, "
+       << "cross fade " << stats.blendMs << " ms, global pose " << stats.globalMs << " ms, "
+       << "palette " << stats.paletteMs << " ms";
+    return os;
+}
@@ -0,0 +1,135 @@
+#ifndef ANIMATION_WORLD_H_INCLUDED
+#define ANIMATION_WORLD_H_INCLUDED
+
+#include <vector>
+#include <ostream>
+
+#include <Vec3.h>
+#include <Quat.h>
+#include <Transform.h>
+#include <Affine3x4.h>
+#include <Clip.h>
+#include <Skeleton.h>
+#include <ResampledClip.h>
+#include <JobSystem.h>
+
+// no clip (a character that isn't fading) or a failed add
+#define ANIMATION_WORLD_INVALID 0xffffffff
+// AddClip warns about a resampled clip further off its source than this,
+// in position or scale units or radians
+#define ANIMATION_WORLD_RESAMPLE_TOLERANCE 0.01f
+
+// milliseconds the stages of the last Update took, on the calling thread
+struct AnimationWorldStats
+{
+    unsigned int numCharacters;
+    unsigned int numFading;
+    float advanceMs;
+    float sampleMs;
+    float blendMs;
+    float globalMs;
+    float paletteMs;
+};
+
+std::ostream& operator<<(std::ostream& os, const AnimationWorldStats& stats);
+
+// Owns the animation state of many characters that share one skeleton,
+// stored as arrays indexed by character (playback times, clip ids, blend
+// weights) or by character * joints + joint (local pose, global pose and
+// skin palette). Update runs one stage at a time across every character:
+//
+//   advance times -> sample clips -> cross fade -> global pose -> palette
+//
+// so each stage's loop streams through contiguous arrays instead of
+// hopping between per character objects. Clips are resampled to dense
+// tables when added; a character plays one clip and can cross fade to
+// one other, like a CrossFadeController with a single target.
+class AnimationWorld
+{
+public:
+
+    AnimationWorld();
+
+    // removes every clip and character
+    void SetSkeleton(const Skeleton& skeleton);
+    // returns the clip's id; the clip has to animate this skeleton. It's
+    // resampled at the rate, by default from its keys
+    unsigned int AddClip(const Clip& clip, float rate = RESAMPLED_CLIP_KEY_RATE);
+    // returns the character's index; it starts in the rest pose
+    unsigned int AddCharacter(unsigned int clip, float time);
+
+    void Play(unsigned int character, unsigned int clip, float time);
+    // fading again before a fade ends restarts it from the current clip
+    void FadeTo(unsigned int character, unsigned int clip, float fadeTime);
+
+    // with jobs, each stage is split across its threads and the caller
+    // calls jobs->WaitAll to recycle them
+    void Update(float dt, JobSystem* jobs = nullptr);
+
+    inline unsigned int GetNumCharacters() const { return (unsigned int)times.size(); }
+    inline unsigned int GetNumJoints() const { return numJoints; }
+    inline unsigned int GetNumClips() const { return (unsigned int)clips.size(); }
+    inline const ResampledClip& GetClip(unsigned int clip) const { return clips[clip]; }
+
+    inline unsigned int GetClipId(unsigned int character) const { return clipIds[character]; }
+    inline float GetTime(unsigned int character) const { return times[character]; }
+    inline float GetBlendWeight(unsigned int character) const { return blendWeights[character]; }
+    Transform GetLocalTransform(unsigned int character, unsigned int joint) const;
+    // GetNumJoints() matrices, model space and pose * inverse bind pose
+    inline const Affine3x4* GetGlobalPose(unsigned int character) const {
+        return &globals[character * numJoints];
+    }
+    inline const Affine3x4* GetPalette(unsigned int character) const {
+        return &palettes[character * numJoints];
+    }
+
+    inline const AnimationWorldStats& GetStats() const { return stats; }
+
+protected:
+
+    // shared by every character
+    unsigned int numJoints;
+    std::vector<int> parents;
+    std::vector<unsigned int> order; // joints with parents before children
+    std::vector<Vec3> restPositions;
+    std::vector<Quat> restRotations;
+    std::vector<Vec3> restScales;
+    std::vector<Affine3x4> invBindPose;
+    std::vector<ResampledClip> clips;
+
+    // per character
+    std::vector<unsigned int> clipIds;
+    std::vector<float> times;
+    std::vector<unsigned int> fadeClipIds;
+    std::vector<float> fadeTimes;
+    std::vector<float> fadeDurations;
+    std::vector<float> fadeElapsed;
+    std::vector<float> blendWeights; // of the fade clip
+
+    // per character and joint
+    std::vector<Vec3> positions;
+    std::vector<Quat> rotations;
+    std::vector<Vec3> scales;
+    std::vector<Vec3> fadePositions;
+    std::vector<Quat> fadeRotations;
+    std::vector<Vec3> fadeScales;
+    std::vector<Affine3x4> globals;
+    std::vector<Affine3x4> palettes;
+
+    AnimationWorldStats stats;
+
+    // the stages, over characters [begin, end)
+    void Advance(float dt, unsigned int begin, unsigned int end);
+    void SampleClips(unsigned int begin, unsigned int end);
+    void CrossFade(unsigned int begin, unsigned int end);
+    void BuildGlobalPose(unsigned int begin, unsigned int end);
+    void BuildPalette(unsigned int begin, unsigned int end);
+
+    // fills one character's joints with the clip at time, over the rest
+    // pose; returns the adjusted time
+    float SampleInto(const ResampledClip& clip, float time,
+                     Vec3* outPositions, Quat* outRotations, Vec3* outScales) const;
+    float RunStage(JobSystem* jobs, const char* name, const JobSystem::RangeTask& stage);
+};
+
+#endif // ANIMATION_WORLD_H_INCLUDED
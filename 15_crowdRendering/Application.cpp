@@ -2,7 +2,8 @@
 
 Application::Application() :
     window(nullptr),
-    quit(false)
+    quit(false),
+    headless(false)
 {
 }
 
@@ -13,6 +14,10 @@ Application::Application() :
 
  bool Application::Initialize(const char* title, const int width, const int height)
 {
+    if (headless) {
+        return true;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << __func__ << ": failed to init SDL: " << SDL_GetError() << std::endl;
         return false;
@@ -50,6 +55,10 @@ Application::Application() :
 
 void Application::Update(float inDeltaTime)
 {
+    if (headless) {
+        return;
+    }
+
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         if (e.type == SDL_QUIT) {
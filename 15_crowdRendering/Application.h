@@ -20,6 +20,11 @@ public:
     virtual void Shutdown();
     
     inline virtual bool ShouldQuit() const { return quit; }
+
+    // no window or context; for running with GLRecorder installed.
+    // Set before Initialize
+    inline void SetHeadless(bool value) { headless = value; }
+    inline bool IsHeadless() const { return headless; }
     
 private:
 
@@ -30,6 +35,7 @@ private:
     SDL_Window* window;
     SDL_GLContext gc;
     bool quit;
+    bool headless;
 };
 
 #endif // APPLICATION_H_INCLUDED
@@ -0,0 +1,123 @@
+#include <AssetLoader.h>
+
+AssetLoader::AssetLoader(unsigned int numWorkers) :
+    numPending(0),
+    quit(false)
+{
+    if (numWorkers == 0) {
+        unsigned int numCores = std::thread::hardware_concurrency();
+        numWorkers = (numCores > 1) ? numCores - 1 : 1;
+    }
+    workers.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::thread(&AssetLoader::WorkerLoop, this));
+    }
+}
+
+AssetLoader::~AssetLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+        jobs.clear();
+    }
+    jobSignal.notify_all();
+    for (unsigned int i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+
+void AssetLoader::Submit(const Task& work, const Task& complete)
+{
+    Job job;
+    job.work = work;
+    job.complete = complete;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+        ++numPending;
+    }
+    jobSignal.notify_one();
+}
+
+unsigned int AssetLoader::Drain(unsigned int maxCompletions)
+{
+    unsigned int numRun = 0;
+    while (maxCompletions == 0 || numRun < maxCompletions)
+    {
+        Task complete;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (completions.empty()) {
+                break;
+            }
+            complete = completions.front();
+            completions.pop_front();
+        }
+
+        // completions may submit more work, so run them unlocked
+        if (complete) {
+            complete();
+        }
+        ++numRun;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --numPending;
+        }
+        completionSignal.notify_all();
+    }
+    return numRun;
+}
+
+void AssetLoader::Flush()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (numPending > 0 && completions.empty()) {
+                completionSignal.wait(lock);
+            }
+            if (numPending == 0) {
+                return;
+            }
+        }
+        Drain();
+    }
+}
+
+unsigned int AssetLoader::GetNumPending()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return numPending;
+}
+
+void AssetLoader::WorkerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!quit && jobs.empty()) {
+                jobSignal.wait(lock);
+            }
+            if (quit) {
+                return;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+        }
+
+        if (job.work) {
+            job.work();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completions.push_back(job.complete);
+        }
+        completionSignal.notify_all();
+    }
+}
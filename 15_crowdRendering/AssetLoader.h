@@ -0,0 +1,65 @@
+#ifndef ASSET_LOADER_H_INCLUDED
+#define ASSET_LOADER_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// Runs loading work (file I/O, parsing, decoding, baking) on worker threads.
+// Each piece of work can have a completion which is queued once the work
+// finishes and runs on whichever thread calls Drain, normally the main
+// thread; GL uploads belong there. Passing no completion (or a stub) keeps
+// everything off the GPU, e.g. when loading headlessly.
+class AssetLoader
+{
+public:
+
+    typedef std::function<void()> Task;
+
+    // 0 workers picks one less than the number of cores (at least one)
+    AssetLoader(unsigned int numWorkers = 0);
+    // waits for running work; queued work and completions are dropped
+    ~AssetLoader();
+
+    void Submit(const Task& work, const Task& complete = Task());
+
+    // runs up to maxCompletions finished completions (0 for all of them)
+    // on the calling thread and returns how many ran
+    unsigned int Drain(unsigned int maxCompletions = 0);
+    // blocks until everything submitted, including work submitted by
+    // completions, has finished and been drained
+    void Flush();
+
+    // submitted work whose completion hasn't run yet
+    unsigned int GetNumPending();
+    inline unsigned int GetNumWorkers() const { return (unsigned int)workers.size(); }
+
+protected:
+
+    struct Job
+    {
+        Task work;
+        Task complete;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Job> jobs;
+    std::deque<Task> completions;
+    unsigned int numPending;
+    bool quit;
+
+    std::mutex mutex;
+    std::condition_variable jobSignal;
+    std::condition_variable completionSignal;
+
+    void WorkerLoop();
+
+private:
+    AssetLoader(const AssetLoader&);
+    AssetLoader& operator=(const AssetLoader&);
+};
+
+#endif // ASSET_LOADER_H_INCLUDED
@@ -2,6 +2,7 @@
 #include <Vec2.h>
 #include <Vec3.h>
 #include <Vec4.h>
+#include <PackedVertex.h>
 
 template class Attribute<int>;
 template class Attribute<float>;
@@ -9,6 +10,7 @@ template class Attribute<Vec2>;
 template class Attribute<Vec3>;
 template class Attribute<Vec4>;
 template class Attribute<iVec4>;
+template class Attribute<PackedVertex>;
 
 template<typename T>
 Attribute<T>::Attribute()
@@ -54,6 +56,13 @@ void Attribute<iVec4>::SetAttribPointer(unsigned int slot)
     glVertexAttribIPointer(slot, 4, GL_INT, 0, (void*)0);
 }
 
+// plain binding of a packed buffer uses the position
+template<>
+void Attribute<PackedVertex>::SetAttribPointer(unsigned int slot)
+{
+    glVertexAttribPointer(slot, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), 0);
+}
+
 template<typename T>
 void Attribute<T>::Set(T* inputArray, unsigned int length)
 {
@@ -79,6 +88,22 @@ void Attribute<T>::BindTo(unsigned int slot)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+template<typename T>
+void Attribute<T>::BindTo(unsigned int slot, const AttributeFormat& format)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    glEnableVertexAttribArray(slot);
+    if (format.integer) {
+        glVertexAttribIPointer(slot, format.size, format.type, format.stride,
+                               (void*)(size_t)format.offset);
+    } else {
+        glVertexAttribPointer(slot, format.size, format.type,
+                              format.normalized ? GL_TRUE : GL_FALSE,
+                              format.stride, (void*)(size_t)format.offset);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 template<typename T>
 void Attribute<T>::UnbindFrom(unsigned int slot)
 {
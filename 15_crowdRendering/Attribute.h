@@ -5,6 +5,18 @@
 
 #include <GL/glew.h>
 
+// how a shader input is read from a buffer; used for interleaved vertices
+// and normalized integer data
+struct AttributeFormat
+{
+    int size;            // number of components
+    unsigned int type;   // GL_FLOAT, GL_SHORT, GL_UNSIGNED_BYTE, GL_HALF_FLOAT...
+    bool normalized;     // integers map to [0,1] or [-1,1]
+    bool integer;        // read as an integer vector in the shader
+    unsigned int stride; // bytes between vertices
+    unsigned int offset; // bytes from the start of the vertex
+};
+
 template<typename T>
 class Attribute
 {
@@ -19,6 +31,7 @@ public:
     void Set(std::vector<T>& input);
 
     void BindTo(unsigned int slot);
+    void BindTo(unsigned int slot, const AttributeFormat& format);
     void UnbindFrom(unsigned int slot);
 
     unsigned int Count()     const { return count; }
@@ -1,6 +1,8 @@
 #ifndef BEZIER_H_INCLUDED
 #define BEZIER_H_INCLUDED
 
+#include <CubicPolynomial.h>
+
 // represents Bezier curve generated by lerp'ing
 // between these four points multiple times and 
 // connecting the result point dots; the lines 
@@ -40,6 +42,17 @@ inline T Interpolate(Bezier<T>& curve, float t) {
            curve.P2 * (t*t*t);                          // curve 4
 }
 
+// the same curve in power basis, to Evaluate many points of it
+template <typename T>
+inline CubicPolynomial<T> ToPolynomial(const Bezier<T>& curve) {
+    CubicPolynomial<T> result;
+    result.a = curve.P1;
+    result.b = (curve.C1 - curve.P1) * 3.0f;
+    result.c = (curve.P1 - curve.C1 * 2.0f + curve.C2) * 3.0f;
+    result.d = curve.P2 - curve.P1 + (curve.C1 - curve.C2) * 3.0f;
+    return result;
+}
+
 // example usage
 // Bezier<Vec3> curve;
 // curve.P1 = Vec3(-5, 0, 0);
@@ -0,0 +1,146 @@
+#include <CharacterAnimator.h>
+#include <Blending.h>
+
+CharacterRig::CharacterRig() :
+    mesh(nullptr),
+    clip(nullptr),
+    additiveClip(nullptr)
+{
+    // joint names of the sample models
+    leftLeg[0] = "LeftUpLeg";
+    leftLeg[1] = "LeftLeg";
+    leftLeg[2] = "LeftFoot";
+    leftLeg[3] = "LeftToeBase";
+    rightLeg[0] = "RightUpLeg";
+    rightLeg[1] = "RightLeg";
+    rightLeg[2] = "RightFoot";
+    rightLeg[3] = "RightToeBase";
+    // the sample models' knees bend around their local -X, from straight to
+    // the 156 degrees PickUp crouches to
+    kneeAxis = Vec3(-1, 0, 0);
+    kneeMinAngle = 0.0f;
+    kneeMaxAngle = 160.0f;
+}
+
+void CharacterRig::Set(const Skeleton& inSkeleton, const Mesh& inMesh,
+                       const Clip& inClip, const Clip& inAdditiveClip)
+{
+    skeleton = inSkeleton;
+    mesh = &inMesh;
+    clip = &inClip;
+    additiveClip = &inAdditiveClip;
+    additiveBase = MakeAdditivePose(skeleton, inAdditiveClip);
+    skeleton.GetInvBindPose(invBindPose);
+}
+
+CharacterAnimator::CharacterAnimator() :
+    rig(nullptr),
+    groundHeight(0.0f),
+    time(0.0f),
+    additiveTime(0.0f)
+{
+}
+
+void CharacterAnimator::Set(CharacterRig& inRig, const Transform& inModel, float startTime)
+{
+    rig = &inRig;
+    model = inModel;
+    time = startTime;
+    additiveTime = startTime;
+
+    basePose = rig->skeleton.GetRestPose();
+    additivePose = basePose;
+    pose = basePose;
+    leftLeg = IKLeg(rig->skeleton, rig->leftLeg[0], rig->leftLeg[1],
+                    rig->leftLeg[2], rig->leftLeg[3]);
+    rightLeg = IKLeg(rig->skeleton, rig->rightLeg[0], rig->rightLeg[1],
+                     rig->rightLeg[2], rig->rightLeg[3]);
+    leftLeg.SetKneeConstraint(rig->kneeAxis, rig->kneeMinAngle, rig->kneeMaxAngle);
+    rightLeg.SetKneeConstraint(rig->kneeAxis, rig->kneeMinAngle, rig->kneeMaxAngle);
+
+    unsigned int numVerts = rig->mesh->GetVertexCount();
+    skinnedPositions.resize(numVerts);
+    skinnedNormals.resize(numVerts);
+}
+
+void CharacterAnimator::SampleBase(float dt)
+{
+    time = rig->clip->Sample(basePose, time + dt);
+}
+
+void CharacterAnimator::SampleAdditive(float dt)
+{
+    additiveTime = rig->additiveClip->Sample(additivePose, additiveTime + dt);
+}
+
+void CharacterAnimator::Blend()
+{
+    Add(pose, basePose, additivePose, rig->additiveBase, -1);
+}
+
+void CharacterAnimator::SolveLeg(IKLeg& leg)
+{
+    // pins the ankle where it is unless that is below the ground
+    Vec3 target = combine(model, pose.GetGlobalTransform(leg.Ankle())).position;
+    if (target.y < groundHeight) {
+        target.y = groundHeight;
+    }
+    leg.SolveForLeg(model, pose, target);
+    pose = leg.GetAdjustedPose();
+}
+
+void CharacterAnimator::SolveLegs()
+{
+    SolveLeg(leftLeg);
+    SolveLeg(rightLeg);
+}
+
+void CharacterAnimator::BuildPalette()
+{
+    pose.GetAffinePalette(palette);
+    for (unsigned int i = 0, size = (unsigned int)palette.size(); i < size; ++i) {
+        palette[i] = palette[i] * rig->invBindPose[i];
+    }
+}
+
+void CharacterAnimator::Skin()
+{
+    if (skinnedPositions.size() == 0) {
+        return;
+    }
+    rig->mesh->CPUSkin(palette, &skinnedPositions[0], &skinnedNormals[0]);
+}
+
+void CharacterAnimator::Update(float dt)
+{
+    SampleBase(dt);
+    SampleAdditive(dt);
+    Blend();
+    SolveLegs();
+    BuildPalette();
+    Skin();
+}
+
+JobSystem::Job* CharacterAnimator::Schedule(JobSystem& jobs, float dt)
+{
+    JobSystem::Job* sampleBase = jobs.Create("SampleBase", [this, dt]() { SampleBase(dt); });
+    JobSystem::Job* sampleAdditive = jobs.Create("SampleAdditive", [this, dt]() { SampleAdditive(dt); });
+    JobSystem::Job* blend = jobs.Create("Blend", [this]() { Blend(); });
+    JobSystem::Job* legs = jobs.Create("SolveLegs", [this]() { SolveLegs(); });
+    JobSystem::Job* buildPalette = jobs.Create("BuildPalette", [this]() { BuildPalette(); });
+    JobSystem::Job* skin = jobs.Create("Skin", [this]() { Skin(); });
+
+    jobs.AddDependency(sampleBase, blend);
+    jobs.AddDependency(sampleAdditive, blend);
+    jobs.AddDependency(blend, legs);
+    jobs.AddDependency(legs, buildPalette);
+    jobs.AddDependency(buildPalette, skin);
+
+    jobs.Submit(sampleBase);
+    jobs.Submit(sampleAdditive);
+    jobs.Submit(blend);
+    jobs.Submit(legs);
+    jobs.Submit(buildPalette);
+    jobs.Submit(skin);
+    return skin;
+}
@@ -0,0 +1,96 @@
+#ifndef CHARACTER_ANIMATOR_H_INCLUDED
+#define CHARACTER_ANIMATOR_H_INCLUDED
+
+#include <vector>
+#include <string>
+
+#include <Vec3.h>
+#include <Transform.h>
+#include <Affine3x4.h>
+#include <Pose.h>
+#include <Clip.h>
+#include <Skeleton.h>
+#include <Mesh.h>
+#include <IKLeg.h>
+#include <JobSystem.h>
+
+// what every character of one kind shares; read only while animating
+struct CharacterRig
+{
+    Skeleton skeleton;
+    const Mesh* mesh;
+    const Clip* clip;         // base motion
+    const Clip* additiveClip; // layered over it with Add
+    Pose additiveBase;
+    std::vector<Affine3x4> invBindPose;
+
+    // legs are named hip, knee, ankle, toe
+    std::string leftLeg[4];
+    std::string rightLeg[4];
+    // knee hinge of both legs, axis in the knee's local space, in degrees
+    Vec3 kneeAxis;
+    float kneeMinAngle;
+    float kneeMaxAngle;
+
+    CharacterRig();
+    // sets up the additive base and bind pose from the clips and skeleton
+    void Set(const Skeleton& inSkeleton, const Mesh& inMesh,
+             const Clip& inClip, const Clip& inAdditiveClip);
+};
+
+// The per frame animation of one character, split into the stages the
+// job system runs as dependent jobs; the two samples run side by side:
+//
+//   SampleBase, SampleAdditive --> Blend --> SolveLegs --> BuildPalette --> Skin
+//
+// Each stage only touches this character and the read only rig, so any
+// number of characters can be scheduled at once.
+class CharacterAnimator
+{
+public:
+
+    CharacterAnimator();
+
+    void Set(CharacterRig& inRig, const Transform& inModel, float startTime);
+    // feet are kept at or above this height
+    inline void SetGroundHeight(float height) { groundHeight = height; }
+
+    void SampleBase(float dt);
+    void SampleAdditive(float dt);
+    void Blend();
+    void SolveLegs();
+    void BuildPalette();
+    void Skin();
+
+    // every stage in order on the calling thread
+    void Update(float dt);
+    // queues every stage; returns the skinning job, which finishes last
+    JobSystem::Job* Schedule(JobSystem& jobs, float dt);
+
+    inline const Pose& GetPose() const { return pose; }
+    // pose * inverse bind pose, from BuildPalette
+    inline const std::vector<Affine3x4>& GetPalette() const { return palette; }
+    inline const std::vector<Vec3>& GetSkinnedPositions() const { return skinnedPositions; }
+    inline const std::vector<Vec3>& GetSkinnedNormals() const { return skinnedNormals; }
+
+protected:
+
+    CharacterRig* rig;
+    Transform model;
+    float groundHeight;
+    float time;
+    float additiveTime;
+
+    Pose basePose;
+    Pose additivePose;
+    Pose pose;
+    IKLeg leftLeg;
+    IKLeg rightLeg;
+    std::vector<Affine3x4> palette;
+    std::vector<Vec3> skinnedPositions;
+    std::vector<Vec3> skinnedNormals;
+
+    void SolveLeg(IKLeg& leg);
+};
+
+#endif // CHARACTER_ANIMATOR_H_INCLUDED
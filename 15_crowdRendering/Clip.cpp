@@ -15,7 +15,7 @@ TClip<TRACK>::TClip()
 }
 
 template<typename TRACK>
-float TClip<TRACK>::Sample(Pose& outPose, float inTime)
+float TClip<TRACK>::Sample(Pose& outPose, float inTime) const
 {
     if (GetDuration() == 0.0f) {
         return 0.0f;
@@ -50,6 +50,17 @@ TRACK& TClip<TRACK>::operator[](unsigned int index)
     return tracks[tracks.size()-1];
 }
 
+template<typename TRACK>
+const TRACK* TClip<TRACK>::FindTrack(unsigned int joint) const
+{
+    for (unsigned int i = 0, size = (unsigned int)tracks.size(); i < size; ++i) {
+        if (tracks[i].GetId() == joint) {
+            return &tracks[i];
+        }
+    }
+    return nullptr;
+}
+
 template<typename TRACK>
 void TClip<TRACK>::RecalculateDuration()
 {
@@ -75,7 +86,7 @@ void TClip<TRACK>::RecalculateDuration()
 }
 
 template<typename TRACK>
-float TClip<TRACK>::AdjustTimeToFitRange(float inTime)
+float TClip<TRACK>::AdjustTimeToFitRange(float inTime) const
 {
     // modulate between start and end
     if (looping) {
@@ -116,3 +127,17 @@ FastClip OptimizeClip(Clip& input)
     result.RecalculateDuration();
     return result;
 }
+
+size_t GetClipBytes(const Clip& clip)
+{
+    size_t bytes = sizeof(Clip) + clip.GetName().capacity();
+    unsigned int numTracks = clip.GetSize();
+    for (unsigned int i = 0; i < numTracks; ++i) {
+        const TransformTrack& track = clip.GetTrackAtIndex(i);
+        bytes += sizeof(TransformTrack);
+        bytes += track.GetPositionTrack().GetSize() * sizeof(VectorFrame);
+        bytes += track.GetRotationTrack().GetSize() * sizeof(QuaternionFrame);
+        bytes += track.GetScaleTrack().GetSize() * sizeof(VectorFrame);
+    }
+    return bytes;
+}
@@ -22,17 +22,25 @@ public:
 
     inline unsigned int GetSize() const { return (unsigned int)tracks.size(); }
 
-    // fills in outPose and returns the adjusted time for that pose
-    float Sample(Pose& outPose, float inTime);
+    // fills in outPose and returns the adjusted time for that pose; the
+    // clip isn't modified, so many threads can sample one clip at once
+    float Sample(Pose& outPose, float inTime) const;
     
-    // get the transform track at the index; if it doesn't exist, a default is returned
+    // get the transform track at the index; if it doesn't exist, a default is
+    // added and returned, so this is for building clips only. It's not
+    // const, so Sample can't reach it; code that looks tracks up while
+    // other threads sample uses FindTrack instead
     TRACK& operator[](unsigned int index);
+    // read only lookups; null if the joint has no track
+    const TRACK* FindTrack(unsigned int joint) const;
+    inline const TRACK& GetTrackAtIndex(unsigned int index) const { return tracks[index]; }
 
     // sets the start/end time of the clip based on the internal tracks
     // finds the min and max start and end time within the tracks and uses those
     void RecalculateDuration();
 
     inline std::string& GetName()                             { return name;                }
+    inline const std::string& GetName() const                 { return name;                }
     inline void         SetName(const std::string& inNewName) { name = inNewName;           }
     inline float        GetDuration() const                   { return endTime - startTime; }
     inline float        GetStartTime() const                  { return startTime;           }
@@ -49,7 +57,7 @@ protected:
     float endTime;
     bool looping; // this would normally be forwarded to a further animation step such as animation component or similar
 
-    float AdjustTimeToFitRange(float inTime);
+    float AdjustTimeToFitRange(float inTime) const;
 };
 
 typedef TClip<TransformTrack> Clip;
@@ -58,5 +66,8 @@ typedef TClip<FastTransformTrack> FastClip;
 // convert a Clip to a FastClip
 FastClip OptimizeClip(Clip& input);
 
+// memory held by the clip and its keyframes
+size_t GetClipBytes(const Clip& clip);
+
 #endif // CLIP_H_INCLUDED
 
@@ -0,0 +1,286 @@
+#include <ClipManager.h>
+#include <GLTFLoader.h>
+#include <iostream>
+#include <sstream>
+
+ClipManager::ClipManager() :
+    data(nullptr),
+    memoryBudget(16 * 1024 * 1024),
+    useCounter(0),
+    streaming(false)
+{
+    ResetStats();
+    stats.numResident = 0;
+    stats.bytesResident = 0;
+}
+
+ClipManager::~ClipManager()
+{
+    Clear();
+}
+
+void ClipManager::Register(cgltf_data* inData)
+{
+    Clear();
+    if (inData == nullptr) {
+        std::cout << __func__ << ": given null data" << std::endl;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    data = inData;
+    unsigned int numClips = data->animations_count;
+    entries.resize(numClips);
+    for (unsigned int i = 0; i < numClips; ++i) {
+        Entry& entry = entries[i];
+        if (data->animations[i].name != nullptr) {
+            entry.name = data->animations[i].name;
+        } else {
+            std::stringstream ss;
+            ss << "Clip" << i;
+            entry.name = ss.str();
+        }
+        entry.clip = nullptr;
+        entry.bytes = 0;
+        entry.pins = 0;
+        entry.lastUse = 0;
+        entry.loading = false;
+
+        // keep the first clip if names repeat
+        if (nameToIndex.find(entry.name) == nameToIndex.end()) {
+            nameToIndex[entry.name] = i;
+        }
+    }
+}
+
+void ClipManager::Clear()
+{
+    StopStreaming();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (unsigned int i = 0; i < entries.size(); ++i) {
+        if (entries[i].pins > 0) {
+            std::cout << __func__ << ": warning: clip " << entries[i].name
+                      << " is still in use" << std::endl;
+        }
+        delete entries[i].clip;
+    }
+    entries.clear();
+    nameToIndex.clear();
+    clipToIndex.clear();
+    stats.numResident = 0;
+    stats.bytesResident = 0;
+
+    if (data != nullptr) {
+        FreeGLTFFile(data);
+        data = nullptr;
+    }
+}
+
+int ClipManager::GetIndex(const std::string& name) const
+{
+    std::map<std::string, unsigned int>::const_iterator it = nameToIndex.find(name);
+    if (it == nameToIndex.end()) {
+        return -1;
+    }
+    return (int)it->second;
+}
+
+const Clip* ClipManager::Acquire(const std::string& name)
+{
+    int index = GetIndex(name);
+    if (index < 0) {
+        std::cout << __func__ << ": unknown clip " << name << std::endl;
+        return nullptr;
+    }
+    return Acquire((unsigned int)index);
+}
+
+const Clip* ClipManager::Acquire(unsigned int index)
+{
+    if (index >= entries.size()) {
+        std::cout << __func__ << ": invalid clip index " << index << std::endl;
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    Entry& entry = entries[index];
+    if (entry.clip == nullptr && !entry.loading) {
+        ++stats.misses;
+    } else {
+        ++stats.hits;
+    }
+    MakeResident(index, lock);
+    ++entry.pins;
+    entry.lastUse = ++useCounter;
+    Evict();
+    return entry.clip;
+}
+
+void ClipManager::Release(const Clip* clip)
+{
+    if (clip == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<const Clip*, unsigned int>::iterator it = clipToIndex.find(clip);
+    if (it == clipToIndex.end()) {
+        std::cout << __func__ << ": clip is not owned by this manager" << std::endl;
+        return;
+    }
+    Entry& entry = entries[it->second];
+    if (entry.pins == 0) {
+        std::cout << __func__ << ": clip " << entry.name << " released too many times" << std::endl;
+        return;
+    }
+    --entry.pins;
+    entry.lastUse = ++useCounter;
+    Evict();
+}
+
+void ClipManager::Prefetch(const std::string& name)
+{
+    int index = GetIndex(name);
+    if (index < 0) {
+        std::cout << __func__ << ": unknown clip " << name << std::endl;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (streaming) {
+        streamQueue.push_back((unsigned int)index);
+        streamSignal.notify_one();
+        return;
+    }
+    MakeResident((unsigned int)index, lock);
+    entries[index].lastUse = ++useCounter;
+    Evict();
+}
+
+void ClipManager::StartStreaming()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (streaming) {
+        return;
+    }
+    streaming = true;
+    streamThread = std::thread(&ClipManager::StreamLoop, this);
+}
+
+void ClipManager::StopStreaming()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!streaming) {
+            return;
+        }
+        streaming = false;
+        streamQueue.clear();
+    }
+    streamSignal.notify_all();
+    streamThread.join();
+}
+
+void ClipManager::SetMemoryBudget(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memoryBudget = bytes;
+    Evict();
+}
+
+ClipManagerStats ClipManager::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void ClipManager::ResetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.hits = 0;
+    stats.misses = 0;
+    stats.evictions = 0;
+}
+
+void ClipManager::MakeResident(unsigned int index, std::unique_lock<std::mutex>& lock)
+{
+    Entry& entry = entries[index];
+
+    // another thread is already loading this clip
+    while (entry.loading) {
+        loaded.wait(lock);
+    }
+    if (entry.clip != nullptr) {
+        return;
+    }
+
+    // convert without holding the lock so other clips stay available
+    entry.loading = true;
+    lock.unlock();
+    Clip* clip = new Clip(LoadAnimationClip(data, index));
+    size_t bytes = GetClipBytes(*clip);
+    lock.lock();
+
+    entry.clip = clip;
+    entry.bytes = bytes;
+    entry.loading = false;
+    clipToIndex[clip] = index;
+    ++stats.numResident;
+    stats.bytesResident += bytes;
+    loaded.notify_all();
+}
+
+void ClipManager::Evict()
+{
+    while (stats.bytesResident > memoryBudget)
+    {
+        // least recently used clip that isn't pinned
+        int oldest = -1;
+        for (unsigned int i = 0; i < entries.size(); ++i) {
+            Entry& entry = entries[i];
+            if (entry.clip == nullptr || entry.loading || entry.pins > 0) {
+                continue;
+            }
+            if (oldest < 0 || entry.lastUse < entries[oldest].lastUse) {
+                oldest = (int)i;
+            }
+        }
+        if (oldest < 0) {
+            // everything resident is in use
+            break;
+        }
+
+        Entry& entry = entries[oldest];
+        clipToIndex.erase(entry.clip);
+        delete entry.clip;
+        entry.clip = nullptr;
+        --stats.numResident;
+        stats.bytesResident -= entry.bytes;
+        entry.bytes = 0;
+        ++stats.evictions;
+    }
+}
+
+void ClipManager::StreamLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        while (streaming && streamQueue.empty()) {
+            streamSignal.wait(lock);
+        }
+        if (!streaming) {
+            break;
+        }
+
+        unsigned int index = streamQueue.front();
+        streamQueue.pop_front();
+        if (entries[index].clip != nullptr || entries[index].loading) {
+            continue;
+        }
+        MakeResident(index, lock);
+        entries[index].lastUse = ++useCounter;
+        Evict();
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef CLIP_MANAGER_H_INCLUDED
+#define CLIP_MANAGER_H_INCLUDED
+
+#include <vector>
+#include <string>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <cgltf.h>
+#include <Clip.h>
+
+struct ClipManagerStats
+{
+    unsigned int hits;      // Acquire calls that found the clip resident
+    unsigned int misses;    // Acquire calls that had to load the clip
+    unsigned int evictions;
+    unsigned int numResident;
+    size_t bytesResident;
+};
+
+// Registers every animation of a glTF file by name, but only converts it
+// into a Clip the first time it is acquired. Clips that are not in use are
+// evicted least recently used first once the resident clips go over the
+// memory budget. Acquired clips are pinned and stay valid until released.
+// They are handed out const, so any number of threads can sample them.
+class ClipManager
+{
+public:
+
+    ClipManager();
+    ~ClipManager();
+
+    // takes ownership of the file data; it is kept to load clips on demand
+    // and freed by Clear() or the destructor
+    void Register(cgltf_data* data);
+    void Clear();
+
+    inline unsigned int GetNumClips() const { return (unsigned int)entries.size(); }
+    inline const std::string& GetName(unsigned int index) const { return entries[index].name; }
+    // returns -1 if there is no clip with the given name
+    int GetIndex(const std::string& name) const;
+
+    // loads the clip if needed and pins it; returns nullptr for unknown names
+    const Clip* Acquire(const std::string& name);
+    const Clip* Acquire(unsigned int index);
+    void        Release(const Clip* clip);
+
+    // queues the clip to be loaded by the streaming thread, or loads it
+    // right away if the thread isn't running
+    void Prefetch(const std::string& name);
+    void StartStreaming();
+    void StopStreaming();
+
+    inline size_t GetMemoryBudget() const { return memoryBudget; }
+    void SetMemoryBudget(size_t bytes);
+
+    ClipManagerStats GetStats();
+    void ResetStats();
+
+protected:
+
+    struct Entry
+    {
+        std::string name;
+        const Clip* clip;
+        size_t bytes;
+        unsigned int pins;
+        unsigned int lastUse;
+        bool loading;
+    };
+
+    cgltf_data* data;
+    std::vector<Entry> entries;
+    std::map<std::string, unsigned int> nameToIndex;
+    std::map<const Clip*, unsigned int> clipToIndex;
+    size_t memoryBudget;
+    unsigned int useCounter;
+    ClipManagerStats stats;
+
+    std::mutex mutex;
+    std::condition_variable loaded;
+
+    std::thread streamThread;
+    std::deque<unsigned int> streamQueue;
+    std::condition_variable streamSignal;
+    bool streaming;
+
+    // both expect the mutex to be locked by the caller
+    void MakeResident(unsigned int index, std::unique_lock<std::mutex>& lock);
+    void Evict();
+
+    void StreamLoop();
+
+private:
+    ClipManager(const ClipManager&);
+    ClipManager& operator=(const ClipManager&);
+};
+
+#endif // CLIP_MANAGER_H_INCLUDED
@@ -5,17 +5,20 @@ CrossFadeController::CrossFadeController()
     clip = nullptr;
     time = 0.0f;
     wasSkeletonSet = false;
+    clipManager = nullptr;
 }
 
 CrossFadeController::CrossFadeController(Skeleton& skeleton)
 {
     clip = nullptr;
     time = 0.0f;
+    clipManager = nullptr;
     SetSkeleton(skeleton);
 }
 
 CrossFadeController::~CrossFadeController()
 {
+    SetClipManager(nullptr);
 }
 
 void CrossFadeController::SetSkeleton(Skeleton& skeleton)
@@ -25,15 +28,16 @@ void CrossFadeController::SetSkeleton(Skeleton& skeleton)
     wasSkeletonSet = true;
 }
 
-void CrossFadeController::Play(Clip* target)
+void CrossFadeController::Play(const Clip* target)
 {
     targets.clear();
     clip = target;
     pose = skeleton.GetRestPose();
     time = target->GetStartTime();
+    ReleaseUnusedClips();
 }
 
-void CrossFadeController::FadeTo(Clip* target, float fadeTime)
+void CrossFadeController::FadeTo(const Clip* target, float fadeTime)
 {
     if (clip == nullptr) {
         Play(target);
@@ -41,7 +45,7 @@ void CrossFadeController::FadeTo(Clip* target, float fadeTime)
     }
     
     if (targets.size() >= 1) {
-        Clip* tmpClip = targets[targets.size()-1].clip;
+        const Clip* tmpClip = targets[targets.size()-1].clip;
         if (tmpClip == target) {
             return;
         }
@@ -69,6 +73,7 @@ void CrossFadeController::Update(float dt)
             time = targets[i].time;
             pose = targets[i].pose;
             targets.erase(targets.begin() + i);
+            ReleaseUnusedClips();
             break;
         }
     }
@@ -87,4 +92,70 @@ void CrossFadeController::Update(float dt)
     }
 }
 
+void CrossFadeController::SetClipManager(ClipManager* manager)
+{
+    if (clipManager != nullptr) {
+        // anything still playing must not outlive the manager's pin
+        targets.clear();
+        clip = nullptr;
+        ReleaseUnusedClips();
+    }
+    clipManager = manager;
+}
+
+bool CrossFadeController::Play(const std::string& name)
+{
+    if (clipManager == nullptr) {
+        std::cout << __func__ << ": no clip manager set" << std::endl;
+        return false;
+    }
+    const Clip* target = clipManager->Acquire(name);
+    if (target == nullptr) {
+        return false;
+    }
+    KeepAcquired(target);
+    Play(target);
+    return true;
+}
+
+bool CrossFadeController::FadeTo(const std::string& name, float fadeTime)
+{
+    if (clipManager == nullptr) {
+        std::cout << __func__ << ": no clip manager set" << std::endl;
+        return false;
+    }
+    const Clip* target = clipManager->Acquire(name);
+    if (target == nullptr) {
+        return false;
+    }
+    KeepAcquired(target);
+    FadeTo(target, fadeTime);
+    return true;
+}
+
+void CrossFadeController::KeepAcquired(const Clip* acquired)
+{
+    // hold a single pin per clip
+    for (unsigned int i = 0; i < acquiredClips.size(); ++i) {
+        if (acquiredClips[i] == acquired) {
+            clipManager->Release(acquired);
+            return;
+        }
+    }
+    acquiredClips.push_back(acquired);
+}
 
+void CrossFadeController::ReleaseUnusedClips()
+{
+    for (unsigned int i = (unsigned int)acquiredClips.size(); i-- > 0;) {
+        const Clip* acquired = acquiredClips[i];
+        bool inUse = (acquired == clip);
+        for (unsigned int j = 0; j < targets.size() && !inUse; ++j) {
+            inUse = (targets[j].clip == acquired);
+        }
+        if (!inUse) {
+            clipManager->Release(acquired);
+            acquiredClips.erase(acquiredClips.begin() + i);
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <CrossFadeTarget.h>
 #include <Clip.h>
+#include <ClipManager.h>
 #include <Skeleton.h>
 
 class CrossFadeController
@@ -14,20 +15,36 @@ public:
     ~CrossFadeController();
     
     void SetSkeleton(Skeleton& skeleton);
-    void Play(Clip* target);
-    void FadeTo(Clip* target, float fadeTime);
+    void Play(const Clip* target);
+    void FadeTo(const Clip* target, float fadeTime);
     void Update(float dt);
+
+    // clips played by name are acquired from the manager and released
+    // once they are no longer playing or fading in
+    void SetClipManager(ClipManager* manager);
+    bool Play(const std::string& name);
+    bool FadeTo(const std::string& name, float fadeTime);
     
     inline Pose& GetCurrentPose() { return pose; }
-    inline Clip* GetCurrentClip() { return clip; }
+    inline const Clip* GetCurrentClip() { return clip; }
 
 protected:
     std::vector<CrossFadeTarget> targets;
-    Clip*       clip;
+    const Clip* clip;
     float       time;
     Pose        pose;
     Skeleton    skeleton;
     bool        wasSkeletonSet;
+
+    ClipManager*       clipManager;
+    std::vector<const Clip*> acquiredClips;
+
+    void KeepAcquired(const Clip* acquired);
+    void ReleaseUnusedClips();
+
+private:
+    CrossFadeController(const CrossFadeController&);
+    CrossFadeController& operator=(const CrossFadeController&);
 };
 
 #endif // CROSS_FADE_CONTROLLER
@@ -7,7 +7,7 @@
 struct CrossFadeTarget
 {
     Pose pose;
-    Clip* clip;
+    const Clip* clip;
     float time;
     float duration;
     float elapsed;
@@ -19,7 +19,7 @@ struct CrossFadeTarget
         elapsed(0.0f)
     {}
     
-    inline CrossFadeTarget(Clip* inTarget, Pose& inPose, float inDuration) :
+    inline CrossFadeTarget(const Clip* inTarget, Pose& inPose, float inDuration) :
         pose(inPose),
         clip(inTarget),
         time(inTarget->GetStartTime()),
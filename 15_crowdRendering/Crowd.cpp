@@ -94,7 +94,7 @@ void Crowd::UpdateInterpolationTimes(float start, float duration, unsigned int t
     }
 }
 
-void Crowd::Update(float deltaTime, Clip& clip, unsigned int texWidth)
+void Crowd::Update(float deltaTime, const Clip& clip, unsigned int texWidth)
 {
     bool looping = clip.GetLooping();
     float start = clip.GetStartTime();
@@ -115,7 +115,29 @@ void Crowd::SetUniforms(Shader* shader)
     Uniform<float>::Set(shader->GetUniform("time"), times);
 }
 
-void Crowd::RandomizeTimes(Clip& clip)
+void Crowd::SetUniforms(RenderQueue& queue, unsigned int draw, const CrowdUniforms& uniforms)
+{
+    unsigned int size = GetSize();
+    if (size == 0) {
+        return;
+    }
+    queue.SetUniform(draw, uniforms.modelPos, &positions[0], size);
+    queue.SetUniform(draw, uniforms.modelRot, &rotations[0], size);
+    queue.SetUniform(draw, uniforms.modelScl, &scales[0], size);
+    queue.SetUniform(draw, uniforms.frames, &frames[0], size);
+    queue.SetUniform(draw, uniforms.time, &times[0], size);
+}
+
+void CrowdUniforms::Resolve(Shader* shader)
+{
+    modelPos = shader->GetUniform("model_pos");
+    modelRot = shader->GetUniform("model_rot");
+    modelScl = shader->GetUniform("model_scl");
+    frames = shader->GetUniform("frames");
+    time = shader->GetUniform("time");
+}
+
+void Crowd::RandomizeTimes(const Clip& clip)
 {
     float start = clip.GetStartTime();
     float duration = clip.GetDuration();
@@ -10,9 +10,22 @@
 #include <Clip.h>
 #include <Shader.h>
 #include <Uniform.h>
+#include <RenderQueue.h>
 
 #define CROWD_MAX_ACTORS 80
 
+// uniform locations of a crowd shader, looked up once
+struct CrowdUniforms
+{
+    unsigned int modelPos;
+    unsigned int modelRot;
+    unsigned int modelScl;
+    unsigned int frames;
+    unsigned int time;
+
+    void Resolve(Shader* shader);
+};
+
 class Crowd
 {
 public:
@@ -23,10 +36,11 @@ public:
     Transform GetActor(unsigned int index);
     void SetActor(unsigned int index, const Transform& t);
 
-    void Update(float deltaTime, Clip& clip, unsigned int texWidth);
+    void Update(float deltaTime, const Clip& clip, unsigned int texWidth);
     void SetUniforms(Shader* shader);
+    void SetUniforms(RenderQueue& queue, unsigned int draw, const CrowdUniforms& uniforms);
     
-    void RandomizeTimes(Clip& clip);
+    void RandomizeTimes(const Clip& clip);
     void RandomizePositions(std::vector<Vec3>& existing, const Vec3& min, const Vec3& max, float radius);
 
 private:
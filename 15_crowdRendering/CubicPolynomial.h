@@ -0,0 +1,33 @@
+#ifndef CUBIC_POLYNOMIAL_H_INCLUDED
+#define CUBIC_POLYNOMIAL_H_INCLUDED
+
+// A cubic curve in power basis, a + b*t + c*t^2 + d*t^3. Hermite and
+// Bezier curves convert to it once; evaluating is then three multiply
+// adds per component instead of rebuilding four basis weights.
+template<typename T>
+struct CubicPolynomial
+{
+    T a;
+    T b;
+    T c;
+    T d;
+};
+
+// Horner's rule
+template<typename T>
+inline T Evaluate(const CubicPolynomial<T>& curve, float t) {
+    return curve.a + (curve.b + (curve.c + curve.d * t) * t) * t;
+}
+
+// same curve as Hermite(t, p1, s1, p2, s2)
+template<typename T>
+inline CubicPolynomial<T> HermiteToPolynomial(const T& p1, const T& s1, const T& p2, const T& s2) {
+    CubicPolynomial<T> result;
+    result.a = p1;
+    result.b = s1;
+    result.c = (p2 - p1) * 3.0f - s1 * 2.0f - s2;
+    result.d = (p1 - p2) * 2.0f + s1 + s2;
+    return result;
+}
+
+#endif // CUBIC_POLYNOMIAL_H_INCLUDED
@@ -2,51 +2,59 @@
 #include "Uniform.h"
 #include "Draw.h"
 
+// every DebugDraw uses the same program; for many objects prefer
+// DebugRenderer, which also batches the draw calls
+static Shader* sShader = nullptr;
+static unsigned int sShaderUsers = 0;
+
+static Shader* AcquireShader()
+{
+    if (sShader == nullptr) {
+        sShader = new Shader(
+            "#version 330 core\n"
+            "uniform mat4 mvp;\n"
+            "in vec3 position;\n"
+            "void main() {\n"
+            "   gl_Position = mvp * vec4(position, 1.0);\n"
+            "}"
+            ,
+            "#version 330 core\n"
+            "uniform vec3 color;\n"
+            "out vec4 FragColor;\n"
+            "void main() {\n"
+            "   FragColor = vec4(color, 1);\n"
+            "}"
+        );
+    }
+    ++sShaderUsers;
+    return sShader;
+}
+
+static void ReleaseShader()
+{
+    if (--sShaderUsers == 0) {
+        delete sShader;
+        sShader = nullptr;
+    }
+}
+
 DebugDraw::DebugDraw() {
     mAttribs = new Attribute<Vec3>();
 
-    mShader = new Shader(
-        "#version 330 core\n"
-        "uniform mat4 mvp;\n"
-        "in vec3 position;\n"
-        "void main() {\n"
-        "   gl_Position = mvp * vec4(position, 1.0);\n"
-        "}"
-        ,
-        "#version 330 core\n"
-        "uniform vec3 color;\n"
-        "out vec4 FragColor;\n"
-        "void main() {\n"
-        "   FragColor = vec4(color, 1);\n"
-        "}"
-    );
+    mShader = AcquireShader();
 }
 
 DebugDraw::DebugDraw(unsigned int size) {
     mAttribs = new Attribute<Vec3>();
 
-    mShader = new Shader(
-        "#version 330 core\n"
-        "uniform mat4 mvp;\n"
-        "in vec3 position;\n"
-        "void main() {\n"
-        "   gl_Position = mvp * vec4(position, 1.0);\n"
-        "}"
-        ,
-        "#version 330 core\n"
-        "uniform vec3 color;\n"
-        "out vec4 FragColor;\n"
-        "void main() {\n"
-        "   FragColor = vec4(color, 1);\n"
-        "}"
-    );
+    mShader = AcquireShader();
 
     Resize(size);
 }
 
 DebugDraw::~DebugDraw() {
     delete mAttribs;
-    delete mShader;
+    ReleaseShader();
 }
 
 unsigned int DebugDraw::Size() {
@@ -0,0 +1,218 @@
+#include <DebugRenderer.h>
+#include <Uniform.h>
+#include <Draw.h>
+#include <atomic>
+
+void DebugBatch::Line(const Vec3& from, const Vec3& to, const Vec3& color)
+{
+    DebugVertex v;
+    v.color = color;
+    v.position = from;
+    lines.push_back(v);
+    v.position = to;
+    lines.push_back(v);
+}
+
+void DebugBatch::Point(const Vec3& position, const Vec3& color)
+{
+    DebugVertex v;
+    v.position = position;
+    v.color = color;
+    points.push_back(v);
+}
+
+void DebugBatch::FromPose(Pose& pose, const Vec3& color)
+{
+    for (unsigned int i = 0, size = pose.GetSize(); i < size; ++i) {
+        int parent = pose.GetParent(i);
+        if (parent < 0) {
+            continue;
+        }
+        Line(pose.GetGlobalTransform(i).position,
+             pose.GetGlobalTransform(parent).position,
+             color);
+    }
+}
+
+void DebugBatch::FromIKSolver(CCDSolver& solver, const Vec3& color)
+{
+    for (unsigned int i = 0, size = solver.GetSize(); i < size; ++i) {
+        Vec3 joint = solver.GetGlobalTransform(i).position;
+        if (i + 1 < size) {
+            Line(joint, solver.GetGlobalTransform(i + 1).position, color);
+        }
+        Point(joint, color);
+    }
+}
+
+void DebugBatch::FromIKSolver(FABRIKSolver& solver, const Vec3& color)
+{
+    for (unsigned int i = 0, size = solver.GetSize(); i < size; ++i) {
+        Vec3 joint = solver.GetGlobalTransform(i).position;
+        if (i + 1 < size) {
+            Line(joint, solver.GetGlobalTransform(i + 1).position, color);
+        }
+        Point(joint, color);
+    }
+}
+
+void DebugBatch::Append(const DebugBatch& other)
+{
+    lines.insert(lines.end(), other.lines.begin(), other.lines.end());
+    points.insert(points.end(), other.points.begin(), other.points.end());
+}
+
+void DebugBatch::Clear()
+{
+    // keeps the capacity for the next frame
+    lines.clear();
+    points.clear();
+}
+
+static std::atomic<unsigned int> sNextRendererId(1);
+
+// GL objects are created on the first Flush so the CPU side works
+// without a context
+DebugRenderer::DebugRenderer()
+{
+    id = sNextRendererId++;
+    shader = nullptr;
+    positions = nullptr;
+    colors = nullptr;
+    vertexArray = 0;
+    mvpUniform = 0;
+    colorAttrib = 0;
+    stats.drawCalls = 0;
+    stats.numLines = 0;
+    stats.numPoints = 0;
+}
+
+DebugRenderer::~DebugRenderer()
+{
+    for (std::map<std::thread::id, DebugBatch*>::iterator it = batches.begin();
+         it != batches.end(); ++it) {
+        delete it->second;
+    }
+    delete shader;
+    delete positions;
+    delete colors;
+    if (vertexArray != 0) {
+        glDeleteVertexArrays(1, &vertexArray);
+    }
+}
+
+DebugBatch& DebugRenderer::GetBatch()
+{
+    // the last batch each thread used is cached, so the lock is only
+    // taken when a thread switches renderers
+    static thread_local unsigned int cachedId = 0;
+    static thread_local DebugBatch* cachedBatch = nullptr;
+    if (cachedId == id) {
+        return *cachedBatch;
+    }
+
+    std::lock_guard<std::mutex> lock(batchesMutex);
+    DebugBatch*& batch = batches[std::this_thread::get_id()];
+    if (batch == nullptr) {
+        batch = new DebugBatch();
+    }
+    cachedId = id;
+    cachedBatch = batch;
+    return *batch;
+}
+
+void DebugRenderer::Collect(DebugBatch& out)
+{
+    std::lock_guard<std::mutex> lock(batchesMutex);
+    for (std::map<std::thread::id, DebugBatch*>::iterator it = batches.begin();
+         it != batches.end(); ++it) {
+        out.Append(*it->second);
+        it->second->Clear();
+    }
+}
+
+void DebugRenderer::Flush(const Mat4& mvp)
+{
+    frame.Clear();
+    Collect(frame);
+    const std::vector<DebugVertex>& lines = frame.GetLines();
+    const std::vector<DebugVertex>& points = frame.GetPoints();
+    unsigned int numLineVerts = (unsigned int)lines.size();
+    unsigned int numPointVerts = (unsigned int)points.size();
+    unsigned int numVerts = numLineVerts + numPointVerts;
+
+    stats.drawCalls = 0;
+    stats.numLines = numLineVerts / 2;
+    stats.numPoints = numPointVerts;
+    if (numVerts == 0) {
+        return;
+    }
+
+    CreateOpenGLObjects();
+
+    // lines first, then points, in one upload
+    Vec3* outPositions = positions->Map(numVerts);
+    Vec3* outColors = colors->Map(numVerts);
+    if (outPositions == nullptr || outColors == nullptr) {
+        positions->Unmap();
+        colors->Unmap();
+        return;
+    }
+    for (unsigned int i = 0; i < numLineVerts; ++i) {
+        outPositions[i] = lines[i].position;
+        outColors[i] = lines[i].color;
+    }
+    for (unsigned int i = 0; i < numPointVerts; ++i) {
+        outPositions[numLineVerts + i] = points[i].position;
+        outColors[numLineVerts + i] = points[i].color;
+    }
+    positions->Unmap();
+    colors->Unmap();
+
+    glBindVertexArray(vertexArray);
+    shader->Bind();
+    Uniform<Mat4>::Set(mvpUniform, mvp);
+    positions->BindTo(SHADER_ATTRIB_POSITION);
+    colors->BindTo(colorAttrib);
+    // GL_LINES and GL_POINTS can't share a draw; both read the one buffer
+    if (numLineVerts > 0) {
+        ::Draw(0, numLineVerts, DrawMode::Lines);
+        ++stats.drawCalls;
+    }
+    if (numPointVerts > 0) {
+        ::Draw(numLineVerts, numPointVerts, DrawMode::Points);
+        ++stats.drawCalls;
+    }
+    shader->UnBind();
+    glBindVertexArray(0);
+}
+
+void DebugRenderer::CreateOpenGLObjects()
+{
+    if (shader != nullptr) {
+        return;
+    }
+    shader = new Shader(
+        "#version 330 core\n"
+        "uniform mat4 mvp;\n"
+        "in vec3 position;\n"
+        "in vec3 color;\n"
+        "out vec3 vertColor;\n"
+        "void main() {\n"
+        "   vertColor = color;\n"
+        "   gl_Position = mvp * vec4(position, 1.0);\n"
+        "}"
+        ,
+        "#version 330 core\n"
+        "in vec3 vertColor;\n"
+        "out vec4 FragColor;\n"
+        "void main() {\n"
+        "   FragColor = vec4(vertColor, 1);\n"
+        "}"
+    );
+    mvpUniform = shader->GetUniform("mvp");
+    colorAttrib = shader->GetAttribute("color");
+    positions = new StreamAttribute<Vec3>();
+    colors = new StreamAttribute<Vec3>();
+    glGenVertexArrays(1, &vertexArray);
+}
@@ -0,0 +1,111 @@
+#ifndef DEBUG_RENDERER_H_INCLUDED
+#define DEBUG_RENDERER_H_INCLUDED
+
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <Vec3.h>
+#include <Mat4.h>
+#include <Pose.h>
+#include <CCDSolver.h>
+#include <FABRIKSolver.h>
+#include <Shader.h>
+#include <StreamAttribute.h>
+
+struct DebugVertex
+{
+    Vec3 position;
+    Vec3 color;
+};
+
+// Lines and points recorded on the CPU; no GL, so it can be filled on
+// any thread and tested without a context.
+class DebugBatch
+{
+public:
+
+    void Line(const Vec3& from, const Vec3& to, const Vec3& color);
+    void Point(const Vec3& position, const Vec3& color);
+
+    // one line from every joint to its parent
+    void FromPose(Pose& pose, const Vec3& color);
+    // a line between neighbouring joints and a point on each joint
+    void FromIKSolver(CCDSolver& solver, const Vec3& color);
+    void FromIKSolver(FABRIKSolver& solver, const Vec3& color);
+
+    void Append(const DebugBatch& other);
+    void Clear();
+
+    // two vertices per line
+    inline const std::vector<DebugVertex>& GetLines()  const { return lines;  }
+    inline const std::vector<DebugVertex>& GetPoints() const { return points; }
+
+private:
+
+    std::vector<DebugVertex> lines;
+    std::vector<DebugVertex> points;
+};
+
+struct DebugRendererStats
+{
+    unsigned int drawCalls;
+    unsigned int numLines;
+    unsigned int numPoints;
+};
+
+// Immediate mode debug drawing shared by everything in the frame. Each
+// thread pushes into its own batch without locking; Flush gathers them
+// all into one streamed vertex buffer and draws every line and then
+// every point with the one shader, so at most two draw calls are made:
+// a draw call has a single primitive mode, and turning points into line
+// crosses would size them in world units instead of pixels.
+// Flush and Collect must not run while other threads are still pushing.
+class DebugRenderer
+{
+public:
+
+    DebugRenderer();
+    ~DebugRenderer();
+
+    // the calling thread's batch, created on first use
+    DebugBatch& GetBatch();
+    inline void Line(const Vec3& from, const Vec3& to, const Vec3& color) {
+        GetBatch().Line(from, to, color);
+    }
+    inline void Point(const Vec3& position, const Vec3& color) {
+        GetBatch().Point(position, color);
+    }
+
+    // moves every thread's batch into out and clears them; no GL
+    void Collect(DebugBatch& out);
+    // Collect, upload and draw; needs a GL context
+    void Flush(const Mat4& mvp);
+
+    inline const DebugRendererStats& GetStats() const { return stats; }
+
+private:
+
+    unsigned int id; // tells renderers apart in the per-thread cache
+    std::mutex batchesMutex;
+    std::map<std::thread::id, DebugBatch*> batches;
+    DebugBatch frame;
+    DebugRendererStats stats;
+
+    // GL objects, created by the first Flush
+    Shader* shader;
+    StreamAttribute<Vec3>* positions;
+    StreamAttribute<Vec3>* colors;
+    unsigned int vertexArray;
+    unsigned int mvpUniform;
+    unsigned int colorAttrib;
+
+    void CreateOpenGLObjects();
+
+    // disallow copy
+    DebugRenderer(const DebugRenderer&);
+    DebugRenderer& operator=(const DebugRenderer&);
+};
+
+#endif // DEBUG_RENDERER_H_INCLUDED
@@ -33,6 +33,11 @@ void Draw(unsigned int vertexCount, DrawMode mode)
     glDrawArrays(DrawModeToGLEnum(mode), 0, vertexCount);
 }
 
+void Draw(unsigned int firstVertex, unsigned int vertexCount, DrawMode mode)
+{
+    glDrawArrays(DrawModeToGLEnum(mode), firstVertex, vertexCount);
+}
+
 // draw multiple instances of the same object
 void DrawInstanced(IndexBuffer& inIndexBuffer, 
                    DrawMode mode, 
@@ -51,3 +56,9 @@ void DrawInstanced(unsigned int vertexCount,
     glDrawArraysInstanced(DrawModeToGLEnum(mode), 0, vertexCount, instanceCount);
 }
 
+void DrawElementsInstanced(unsigned int indexCount,
+                           DrawMode mode,
+                           unsigned int instanceCount)
+{
+    glDrawElementsInstanced(DrawModeToGLEnum(mode), indexCount, GL_UNSIGNED_INT, 0, instanceCount);
+}
@@ -1,7 +1,7 @@
 #ifndef DRAW_H_INCLUDED
 #define DRAW_H_INCLUDED
 
-#include <GL/glew.h>
+#include <GLBackend.h>
 
 #include <IndexBuffer.h>
 
@@ -18,6 +18,7 @@ enum class DrawMode
 
 void Draw(IndexBuffer& inIndexBuffer, DrawMode mode); // draw via element array
 void Draw(unsigned int vertexCount, DrawMode mode); // draw array
+void Draw(unsigned int firstVertex, unsigned int vertexCount, DrawMode mode);
 
 // draw multiple instances of the same object
 void DrawInstanced(IndexBuffer& inIndexBuffer, 
@@ -26,6 +27,10 @@ void DrawInstanced(IndexBuffer& inIndexBuffer,
 void DrawInstanced(unsigned int vertexCount,
                    DrawMode mode, 
                    unsigned int instanceCount);
+// uses the element array of the bound vertex array object
+void DrawElementsInstanced(unsigned int indexCount,
+                           DrawMode mode,
+                           unsigned int instanceCount);
 
 #endif // DRAW_H_INCLUDED
 
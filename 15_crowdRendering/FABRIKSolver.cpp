@@ -1,10 +1,39 @@
 #include <FABRIKSolver.h>
 
+#define IK_DEG2RAD(deg) ((deg) * 3.14159265359f / 180.0f)
+// how far a straight hinge is bent toward its range before solving
+#define IK_HINGE_START_BEND IK_DEG2RAD(10.0f)
+
 FABRIKSolver::FABRIKSolver() :
     numSteps(15),
-    threshold(0.00001f)
+    threshold(0.00001f),
+    maxStalledSteps(8),
+    lastIterations(0),
+    lastResidual(0.0f)
 {}
 
+void FABRIKSolver::SetBallSocketConstraint(unsigned int index, float limit)
+{
+    IKConstraint& c = constraints[index];
+    c.type = IKConstraintType::BallSocket;
+    c.limit = IK_DEG2RAD(limit);
+}
+
+void FABRIKSolver::SetHingeConstraint(unsigned int index, const Vec3& axis,
+                                      float minAngle, float maxAngle)
+{
+    IKConstraint& c = constraints[index];
+    c.type = IKConstraintType::Hinge;
+    c.axis = normalized(axis);
+    c.minAngle = IK_DEG2RAD(minAngle);
+    c.maxAngle = IK_DEG2RAD(maxAngle);
+}
+
+void FABRIKSolver::ClearConstraint(unsigned int index)
+{
+    constraints[index] = IKConstraint();
+}
+
 Transform FABRIKSolver::GetGlobalTransform(unsigned int index)
 {
     unsigned int size = IKChain.size();
@@ -31,6 +60,16 @@ void FABRIKSolver::IKChainToWorld()
     if (size >= 0) {
         lengths[0] = 0.0f; // difference between root joint and itself
     }
+
+    if (!HasConstraints()) {
+        return;
+    }
+    for (unsigned int i = 0; i < size; ++i) {
+        startDirections[i] = BoneDirection(i);
+        if (constraints[i].type == IKConstraintType::Hinge) {
+            hingeAxes[i] = normalized(GetGlobalTransform(i).rotation * constraints[i].axis);
+        }
+    }
 }
 
 void FABRIKSolver::WorldToIKChain()
@@ -64,8 +103,15 @@ void FABRIKSolver::IterateBackward(const Vec3& goal)
         worldChain[size - 1] = goal;
     }
 
+    bool constrained = HasConstraints();
     for (int i = size - 2; i >= 0; --i) {
         Vec3 direction = normalized(worldChain[i] - worldChain[i+1]);
+        // limit the bone i -> i+1 against the parent bone as it was before
+        // this pass moved joint i
+        if (constrained) {
+            Vec3 parent = (i >= 1) ? BoneDirection(i - 1) : startDirections[0];
+            direction = ApplyConstraint(i, parent, direction * -1.0f) * -1.0f;
+        }
         Vec3 offset = direction * lengths[i+1];
         worldChain[i] = worldChain[i + 1] + offset;
     }
@@ -78,8 +124,13 @@ void FABRIKSolver::IterateForward(const Vec3& base)
         worldChain[0] = base;
     }
 
+    bool constrained = HasConstraints();
     for (int i = 1; i < size; ++i) {
         Vec3 direction = normalized(worldChain[i] - worldChain[i-1]);
+        if (constrained) {
+            Vec3 parent = (i >= 2) ? BoneDirection(i - 2) : startDirections[0];
+            direction = ApplyConstraint(i - 1, parent, direction);
+        }
         Vec3 offset = direction * lengths[i];
         worldChain[i] = worldChain[i - 1] + offset;
     }
@@ -88,66 +139,222 @@ void FABRIKSolver::IterateForward(const Vec3& base)
 bool FABRIKSolver::Solve(const Transform& target)
 {
     unsigned int size = IKChain.size();
+    lastIterations = 0;
+    lastResidual = 0.0f;
     if (size == 0) { return false; }
     unsigned int last = size - 1;
     float threshSqd = threshold * threshold;
 
     IKChainToWorld();
+    bool constrained = HasConstraints();
+    if (constrained) {
+        BendStraightHinges();
+    }
     Vec3 goal = target.position;
     Vec3 base = worldChain[0];
+    float bestResidual = len(worldChain[last] - goal);
+    bestChain = worldChain;
+    unsigned int stalled = 0;
 
     for (unsigned int i = 0; i < numSteps; ++i)
     {
         Vec3 effector = worldChain[last];
         if (lenSq(effector - goal) < threshSqd) {
-            WorldToIKChain();
-            return true;
+            break;
         }
         
         IterateBackward(goal);
         IterateForward(base);
+        if (constrained) {
+            TurnHinges();
+        }
+        lastIterations = i + 1;
+
+        // constrained chains do not always get closer every iteration, so
+        // keep the best result and give up after a few iterations without
+        // progress (goal out of reach or blocked by a constraint)
+        float residual = len(worldChain[last] - goal);
+        if (residual < bestResidual - threshold) {
+            bestResidual = residual;
+            bestChain = worldChain;
+            stalled = 0;
+        } else if (++stalled >= maxStalledSteps) {
+            break;
+        }
+    }
+    if (len(worldChain[last] - goal) > bestResidual) {
+        worldChain = bestChain;
     }
+    // judge convergence on the world chain; turning it back into local
+    // rotations adds float error of about the size of the threshold
+    bool converged = lenSq(worldChain[last] - goal) < threshSqd;
     WorldToIKChain();
     Vec3 effector = GetGlobalTransform(last).position;
-    if (lenSq(effector - goal) < threshSqd) {
-        return true;
-    }
+    lastResidual = sqrtf(lenSq(effector - goal));
+
+    return converged;
+}
 
+bool FABRIKSolver::HasConstraints() const
+{
+    for (unsigned int i = 0, size = constraints.size(); i < size; ++i) {
+        if (constraints[i].type != IKConstraintType::None) {
+            return true;
+        }
+    }
     return false;
 }
 
-#if 0
-void FABRIKSolver::ApplyBallSocketConstraint(int i, float limit)
+// direction of the bone from joint i to joint i + 1 in the world chain
+Vec3 FABRIKSolver::BoneDirection(unsigned int i)
 {
-    Quat parentRot = (i == 0) ? offset.rotation : GetWorldTransform(i - 1).rotation;
-    Quat thisRot = GetWorldTransform(i).rotation;
+    if (i + 1 >= worldChain.size()) {
+        return Vec3(0, 0, 1);
+    }
+    return normalized(worldChain[i + 1] - worldChain[i]);
+}
 
-    Vec3 parentDir = parentRot * Vec3(0,0,1);
-    Vec3 thisDir = thisRot * Vec3(0,0,1);
-    float angle = ::angle(parentDir, thisDir);
+// A straight hinge gives the passes nothing to bend: every direction
+// toward the goal projects back onto the straight line. Turns the parent
+// bone back and the bones after the hinge forward around its axis, toward
+// the middle of its range, so the joint leaves that line on the allowed
+// side while the end of the chain stays close to where it was.
+void FABRIKSolver::BendStraightHinges()
+{
+    unsigned int size = (unsigned int)worldChain.size();
+    for (unsigned int i = 1; i + 1 < size; ++i) {
+        const IKConstraint& c = constraints[i];
+        if (c.type != IKConstraintType::Hinge) {
+            continue;
+        }
+        Vec3 parent = BoneDirection(i - 1);
+        Vec3 child = BoneDirection(i);
+        if (lenSq(cross(parent, child)) > VEC3_EPSILON) {
+            continue;
+        }
+        float middle = (c.minAngle + c.maxAngle) * 0.5f;
+        float bend = (middle > 0.0f) ? IK_HINGE_START_BEND : -IK_HINGE_START_BEND;
+        if (middle == 0.0f || bend < c.minAngle || bend > c.maxAngle) {
+            continue;
+        }
+        Quat back = angleAxis(-bend, hingeAxes[i]);
+        for (unsigned int j = i; j < size; ++j) {
+            worldChain[j] = worldChain[i - 1] + back * (worldChain[j] - worldChain[i - 1]);
+        }
+        Quat forward = angleAxis(bend, hingeAxes[i]);
+        for (unsigned int j = i + 1; j < size; ++j) {
+            worldChain[j] = worldChain[i] + forward * (worldChain[j] - worldChain[i]);
+        }
+    }
+}
 
-#define DEG2RAD(deg) ((deg) * M_PI / 180.0f)
+// The passes only clamp how far a hinge bends; which way it bends is set
+// here. Turns the joints between the hinge's parent joint and the end of
+// the chain around the line joining those two, which keeps every length
+// and the end where it is, until the hinge bends around its axis. For
+// the knee of a leg that is the plane through hip and ankle that faces
+// the knee's axis the most, whichever way the hip has swung.
+void FABRIKSolver::TurnHinges()
+{
+    unsigned int size = (unsigned int)worldChain.size();
+    if (size < 3) { return; }
+    unsigned int last = size - 1;
+    for (unsigned int i = 1; i < last; ++i) {
+        const IKConstraint& c = constraints[i];
+        if (c.type != IKConstraintType::Hinge) {
+            continue;
+        }
+        Vec3 start = worldChain[i - 1];
+        Vec3 line = worldChain[last] - start;
+        if (lenSq(line) < VEC3_EPSILON) {
+            continue;
+        }
+        normalize(line);
+        Vec3 axis = hingeAxes[i] - line * dot(hingeAxes[i], line);
+        Vec3 current = worldChain[i] - start;
+        current = current - line * dot(current, line);
+        if (lenSq(axis) < VEC3_EPSILON || lenSq(current) < VEC3_EPSILON) {
+            continue;
+        }
+        Vec3 wanted = normalized(cross(line, axis));
+        if (c.minAngle < 0.0f && dot(wanted, current) < 0.0f) {
+            wanted = wanted * -1.0f;
+        }
+        Quat turn = fromTo(normalized(current), wanted);
+        for (unsigned int j = i; j < last; ++j) {
+            worldChain[j] = start + turn * (worldChain[j] - start);
+        }
+    }
+}
 
-    // if angle surpassed the socket constraint, hold back
-    if (angle > DEG2RAD(limit)) {
-        Vec3 correction = cross(parentDir, thisDir);
-        Quat worldSpaceRotation = parentRot * angleAxis(DEG2RAD(limit), correction);
-        chain[i].rotation = worldSpaceRotation * inverse(parentRot);
+Vec3 FABRIKSolver::ApplyConstraint(unsigned int i, const Vec3& reference,
+                                   const Vec3& direction)
+{
+    const IKConstraint& c = constraints[i];
+    if (c.type == IKConstraintType::BallSocket) {
+        return ApplyBallSocketConstraint(reference, direction, c.limit);
+    } else if (c.type == IKConstraintType::Hinge) {
+        return ApplyHingeSocketConstraint(reference, direction, hingeAxes[i],
+                                          c.minAngle, c.maxAngle);
     }
-#undef DEG2RAD
+    return direction;
 }
-#endif
 
-#if 0
-void FABRIKSolver::ApplyHingeSocketConstraint(int i, Vec3 axis)
+// keeps direction inside a cone of the given half angle around reference
+Vec3 FABRIKSolver::ApplyBallSocketConstraint(const Vec3& reference,
+                                             const Vec3& direction,
+                                             float limit)
 {
-    Transform joint = GetWorldTransform(i);
-    Transform parent = GetWorldTransform(i - 1);
+    float boneAngle = angle(reference, direction);
+    if (boneAngle <= limit) {
+        return direction;
+    }
+
+    // rotate the reference towards direction, stopping at the cone edge
+    Vec3 correction = cross(reference, direction);
+    if (lenSq(correction) < VEC3_EPSILON) {
+        // opposite directions; any perpendicular axis will do
+        correction = cross(reference, Vec3(1, 0, 0));
+        if (lenSq(correction) < VEC3_EPSILON) {
+            correction = cross(reference, Vec3(0, 1, 0));
+        }
+    }
+    return normalized(angleAxis(limit, correction) * reference);
+}
 
-    Vec3 currentHinge = joint.rotation * axis;
-    Vec3 desiredHinge = parent.rotation * axis;
+// clamps the bend angle from reference to direction into [minAngle,
+// maxAngle], in the plane of the two; the bend is negative when that plane
+// faces away from axis. TurnHinges keeps the plane itself facing the axis
+Vec3 FABRIKSolver::ApplyHingeSocketConstraint(const Vec3& reference,
+                                              const Vec3& direction,
+                                              const Vec3& axis,
+                                              float minAngle,
+                                              float maxAngle)
+{
+    Vec3 ref = normalized(reference);
+    Vec3 dir = normalized(direction);
+    Vec3 hinge = cross(ref, dir);
+    float side = 1.0f;
+    if (lenSq(hinge) < VEC3_EPSILON) {
+        hinge = axis - ref * dot(axis, ref);
+        if (lenSq(hinge) < VEC3_EPSILON) {
+            return direction;
+        }
+    } else if (dot(hinge, axis) < 0.0f) {
+        side = -1.0f;
+    }
+    normalize(hinge);
+    hinge = hinge * side;
 
-    chain[i].rotation = chain[i].rotation * fromToRotation(currentHinge, desiredHinge);
+    float bend = atan2f(dot(cross(ref, dir), hinge), dot(ref, dir));
+    if (bend < minAngle) {
+        bend = minAngle;
+    } else if (bend > maxAngle) {
+        bend = maxAngle;
+    } else {
+        return dir;
+    }
+    return normalized(angleAxis(bend, hinge) * ref);
 }
-#endif
 
+#undef IK_DEG2RAD
@@ -4,6 +4,28 @@
 #include <vector>
 #include <Transform.h>
 
+enum class IKConstraintType {
+    None, BallSocket, Hinge
+};
+
+// limits the bone leaving a joint relative to the bone entering it
+struct IKConstraint
+{
+    IKConstraintType type;
+    float limit;    // ball socket: max angle between the bones (radians)
+    Vec3 axis;      // hinge: rotation axis in the joint's local space
+    float minAngle; // hinge: allowed signed bend range around the axis (radians)
+    float maxAngle;
+
+    inline IKConstraint() :
+        type(IKConstraintType::None),
+        limit(0.0f),
+        axis(Vec3(1, 0, 0)),
+        minAngle(0.0f),
+        maxAngle(0.0f)
+    {}
+};
+
 class FABRIKSolver
 {
 public:
@@ -15,6 +37,9 @@ public:
         IKChain.resize(newSize); 
         worldChain.resize(newSize);
         lengths.resize(newSize);
+        constraints.resize(newSize);
+        hingeAxes.resize(newSize);
+        startDirections.resize(newSize);
     }
 
     inline Transform GetLocalTransform(unsigned int index) { return IKChain[index]; }
@@ -32,8 +57,32 @@ public:
     inline float GetThreshold() const { return threshold; }
     inline void SetThreshold(float newThreshold) { threshold = newThreshold; }
 
+    // Constraints are applied inside the backward and forward passes. The
+    // constraint on joint i limits the bone i -> i+1 relative to the bone
+    // i-1 -> i; for the root joint the reference is the bone's direction in
+    // the input pose. Angles are in degrees. Hinge axes are taken from the
+    // input pose once per Solve and stay fixed in world space while it
+    // iterates; after every iteration the chain is turned so each hinge
+    // bends around its axis again, and a hinge that starts out straight is
+    // bent a little toward its range first so it has a side to bend to.
+    void SetBallSocketConstraint(unsigned int index, float limit);
+    void SetHingeConstraint(unsigned int index, const Vec3& axis,
+                            float minAngle, float maxAngle);
+    void ClearConstraint(unsigned int index);
+    inline const IKConstraint& GetConstraint(unsigned int index) const {
+        return constraints[index];
+    }
+
+    // iterations without getting closer to the goal before giving up
+    inline unsigned int GetMaxStalledSteps() const { return maxStalledSteps; }
+    inline void SetMaxStalledSteps(unsigned int steps) { maxStalledSteps = steps; }
+
     bool Solve(const Transform& target);
 
+    // statistics of the last call to Solve
+    inline unsigned int GetLastIterationCount() const { return lastIterations; }
+    inline float GetLastResidual() const { return lastResidual; } // effector to goal distance
+
 private:
 
     std::vector<Transform> IKChain;
@@ -42,17 +91,27 @@ private:
     std::vector<Vec3> worldChain;
     std::vector<float> lengths;
 
+    std::vector<IKConstraint> constraints;
+    std::vector<Vec3> hingeAxes;       // world space hinge axes of the input pose
+    std::vector<Vec3> startDirections; // bone directions of the input pose
+    std::vector<Vec3> bestChain;       // closest world chain found so far
+    unsigned int maxStalledSteps;
+    unsigned int lastIterations;
+    float lastResidual;
+
     void IKChainToWorld();
     void IterateForward(const Vec3& base);
     void IterateBackward(const Vec3& goal);
     void WorldToIKChain();
-#if 0
-    void ApplyBallSocketConstraint(int i, float limit);
-#endif
 
-#if 0
-    void ApplyHingeSocketConstraint(int i, Vec3 axis);
-#endif
+    bool HasConstraints() const;
+    void BendStraightHinges();
+    void TurnHinges();
+    Vec3 BoneDirection(unsigned int i);
+    Vec3 ApplyConstraint(unsigned int i, const Vec3& reference, const Vec3& direction);
+    Vec3 ApplyBallSocketConstraint(const Vec3& reference, const Vec3& direction, float limit);
+    Vec3 ApplyHingeSocketConstraint(const Vec3& reference, const Vec3& direction,
+                                    const Vec3& axis, float minAngle, float maxAngle);
 
 };
 
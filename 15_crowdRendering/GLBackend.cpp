@@ -0,0 +1,10 @@
+#define GL_BACKEND_NO_MACROS
+#include <GLBackend.h>
+
+GLBackendBindTexture    GLBackend_BindTexture    = glBindTexture;
+GLBackendGenTextures    GLBackend_GenTextures    = glGenTextures;
+GLBackendDeleteTextures GLBackend_DeleteTextures = glDeleteTextures;
+GLBackendTexImage2D     GLBackend_TexImage2D     = glTexImage2D;
+GLBackendTexParameteri  GLBackend_TexParameteri  = glTexParameteri;
+GLBackendDrawArrays     GLBackend_DrawArrays     = glDrawArrays;
+GLBackendDrawElements   GLBackend_DrawElements   = glDrawElements;
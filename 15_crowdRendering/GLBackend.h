@@ -0,0 +1,39 @@
+#ifndef GL_BACKEND_H_INCLUDED
+#define GL_BACKEND_H_INCLUDED
+
+#include <GL/glew.h>
+
+// GLEW calls everything above GL 1.1 through function pointers, which
+// GLRecorder can replace. The GL 1.1 functions the render path uses are
+// exported by the GL library itself, so they get pointers here and the
+// macros below send calls through them.
+typedef void (GLAPIENTRY *GLBackendBindTexture)(GLenum target, GLuint texture);
+typedef void (GLAPIENTRY *GLBackendGenTextures)(GLsizei n, GLuint* textures);
+typedef void (GLAPIENTRY *GLBackendDeleteTextures)(GLsizei n, const GLuint* textures);
+typedef void (GLAPIENTRY *GLBackendTexImage2D)(GLenum target, GLint level, GLint internalFormat,
+                                               GLsizei width, GLsizei height, GLint border,
+                                               GLenum format, GLenum type, const void* pixels);
+typedef void (GLAPIENTRY *GLBackendTexParameteri)(GLenum target, GLenum pname, GLint param);
+typedef void (GLAPIENTRY *GLBackendDrawArrays)(GLenum mode, GLint first, GLsizei count);
+typedef void (GLAPIENTRY *GLBackendDrawElements)(GLenum mode, GLsizei count, GLenum type,
+                                                 const void* indices);
+
+extern GLBackendBindTexture    GLBackend_BindTexture;
+extern GLBackendGenTextures    GLBackend_GenTextures;
+extern GLBackendDeleteTextures GLBackend_DeleteTextures;
+extern GLBackendTexImage2D     GLBackend_TexImage2D;
+extern GLBackendTexParameteri  GLBackend_TexParameteri;
+extern GLBackendDrawArrays     GLBackend_DrawArrays;
+extern GLBackendDrawElements   GLBackend_DrawElements;
+
+#ifndef GL_BACKEND_NO_MACROS
+#define glBindTexture    GLBackend_BindTexture
+#define glGenTextures    GLBackend_GenTextures
+#define glDeleteTextures GLBackend_DeleteTextures
+#define glTexImage2D     GLBackend_TexImage2D
+#define glTexParameteri  GLBackend_TexParameteri
+#define glDrawArrays     GLBackend_DrawArrays
+#define glDrawElements   GLBackend_DrawElements
+#endif
+
+#endif // GL_BACKEND_H_INCLUDED
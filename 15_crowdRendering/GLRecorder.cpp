@@ -0,0 +1,709 @@
+#include <GLRecorder.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <functional>
+#include <cstring>
+#include <sstream>
+
+namespace GLRecorder
+{
+    static GLRecorderStats stats;
+    static bool installed = false;
+    static std::vector<std::function<void()> > restorers;
+
+    static GLuint nextName = 1;
+    static std::map<GLenum, GLuint> boundBuffers;          // by target
+    static std::map<GLuint, std::vector<char> > mappings;  // scratch memory by buffer
+
+    // swaps an entry point and remembers how to put it back
+    template<typename F>
+    static void Replace(F& slot, F recorder)
+    {
+        F original = slot;
+        F* location = &slot;
+        restorers.push_back([location, original]() { *location = original; });
+        slot = recorder;
+    }
+
+    // stand-in for calls that only need counting
+    template<typename F>
+    struct Count;
+
+    template<typename R, typename... Args>
+    struct Count<R (GLAPIENTRY*)(Args...)>
+    {
+        template<unsigned int GLRecorderStats::*Counter>
+        static R GLAPIENTRY Call(Args...)
+        {
+            ++stats.glCalls;
+            ++(stats.*Counter);
+            return R();
+        }
+
+        static R GLAPIENTRY Ignore(Args...)
+        {
+            ++stats.glCalls;
+            return R();
+        }
+    };
+
+#define COUNT(name, counter) Replace(name, &Count<decltype(name)>::Call<&GLRecorderStats::counter>)
+#define IGNORE(name)         Replace(name, &Count<decltype(name)>::Ignore)
+
+    static void GLAPIENTRY GenNames(GLsizei n, GLuint* names)
+    {
+        ++stats.glCalls;
+        for (GLsizei i = 0; i < n; ++i) {
+            names[i] = nextName++;
+        }
+    }
+
+    static GLuint GLAPIENTRY CreateName()
+    {
+        ++stats.glCalls;
+        return nextName++;
+    }
+
+    // Shaders are not compiled, but their top level declarations are
+    // read at link time so programs report the uniforms, attributes and
+    // blocks a driver would, each at its own location.
+    struct RecordedShader
+    {
+        GLenum type;
+        std::string source;
+    };
+
+    struct RecordedVariable
+    {
+        std::string name;
+        GLint size;      // array length, 1 otherwise
+        GLint location;
+    };
+
+    struct RecordedProgram
+    {
+        std::vector<GLuint> shaders;
+        std::map<std::string, GLint> boundAttributes;
+        std::vector<RecordedVariable> attributes;
+        std::vector<RecordedVariable> uniforms;
+        std::vector<std::string> blocks;
+        std::string infoLog; // what failed to link, empty if it linked
+    };
+
+    // #define name -> value, per shader
+    typedef std::map<std::string, std::string> Defines;
+
+    static std::map<GLuint, RecordedShader> shaders;
+    static std::map<GLuint, RecordedProgram> programs;
+
+    static GLuint GLAPIENTRY CreateShader(GLenum type)
+    {
+        GLuint shader = CreateName();
+        shaders[shader].type = type;
+        return shader;
+    }
+
+    static GLuint GLAPIENTRY CreateProgram()
+    {
+        GLuint program = CreateName();
+        programs[program] = RecordedProgram();
+        return program;
+    }
+
+    static void GLAPIENTRY ShaderSource(GLuint shader, GLsizei count, const GLchar* const* strings, const GLint* lengths)
+    {
+        ++stats.glCalls;
+        std::string& source = shaders[shader].source;
+        source.clear();
+        for (GLsizei i = 0; i < count; ++i) {
+            if (lengths != nullptr && lengths[i] >= 0) {
+                source.append(strings[i], (size_t)lengths[i]);
+            } else {
+                source.append(strings[i]);
+            }
+        }
+    }
+
+    static void GLAPIENTRY AttachShader(GLuint program, GLuint shader)
+    {
+        ++stats.glCalls;
+        programs[program].shaders.push_back(shader);
+    }
+
+    static void GLAPIENTRY BindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+    {
+        ++stats.glCalls;
+        programs[program].boundAttributes[name] = (GLint)index;
+    }
+
+    // "layout(location = 0) in vec3 position" -> in, vec3, position
+    static std::vector<std::string> Tokenize(const std::string& declaration)
+    {
+        std::vector<std::string> tokens;
+        std::string token;
+        int parens = 0;
+        for (unsigned int i = 0, size = (unsigned int)declaration.size(); i < size; ++i) {
+            char c = declaration[i];
+            if (c == '(') {
+                ++parens;
+            } else if (c == ')') {
+                --parens;
+            } else if (parens == 0 && (isalnum((unsigned char)c) || c == '_' || c == '[' || c == ']')) {
+                token += c;
+                continue;
+            }
+            if (!token.empty()) {
+                tokens.push_back(token);
+                token.clear();
+            }
+        }
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+        if (!tokens.empty() && tokens[0] == "layout") {
+            tokens.erase(tokens.begin());
+        }
+        return tokens;
+    }
+
+    // "#define MAX_INSTANCES 80" -> MAX_INSTANCES, 80; function like
+    // macros are left out since no array size uses them
+    static void AddDefine(Defines& defines, const std::string& line)
+    {
+        std::istringstream tokens(line.substr(line.find('#') + 1));
+        std::string directive, name, value;
+        tokens >> directive >> name;
+        if (directive != "define" || name.empty() || name.find('(') != std::string::npos) {
+            return;
+        }
+        std::getline(tokens >> std::ws, value);
+        defines[name] = value.substr(0, value.find_last_not_of(" \t\r") + 1);
+    }
+
+    // a literal, or a #define of one (through a few others), as an array
+    // size; -1 if it's neither
+    static GLint ResolveSize(const std::string& size, const Defines& defines)
+    {
+        std::string value = size;
+        for (unsigned int depth = 0; depth < 8; ++depth) {
+            if (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos) {
+                return (GLint)atoi(value.c_str());
+            }
+            Defines::const_iterator define = defines.find(value);
+            if (define == defines.end()) {
+                break;
+            }
+            value = define->second;
+        }
+        return -1;
+    }
+
+    static void AddVariable(RecordedProgram& program, std::vector<RecordedVariable>& variables,
+                            const std::string& declared, const Defines& defines)
+    {
+        RecordedVariable variable;
+        variable.name = declared;
+        variable.size = 1;
+        variable.location = -1;
+        size_t bracket = declared.find('[');
+        if (bracket != std::string::npos) {
+            variable.name = declared.substr(0, bracket);
+            size_t close = declared.find(']', bracket);
+            std::string size = declared.substr(bracket + 1, close == std::string::npos ? close : close - bracket - 1);
+            variable.size = ResolveSize(size, defines);
+            if (variable.size < 0) {
+                // a real driver wouldn't link this either
+                program.infoLog += "can't resolve the array size of " + declared + "\n";
+                return;
+            }
+        }
+        for (unsigned int i = 0, size = (unsigned int)variables.size(); i < size; ++i) {
+            if (variables[i].name == variable.name) {
+                return; // declared by both stages
+            }
+        }
+        variables.push_back(variable);
+    }
+
+    static void ScanDeclarations(RecordedProgram& program, const RecordedShader& shader)
+    {
+        std::string declaration;
+        int depth = 0;
+        Defines defines;
+        const std::string& source = shader.source;
+        for (unsigned int i = 0, size = (unsigned int)source.size(); i < size; ++i) {
+            char c = source[i];
+            if (c == '#' || (c == '/' && i + 1 < size && source[i + 1] == '/')) {
+                // preprocessor lines and comments; array sizes can be #defines
+                unsigned int start = i;
+                while (i < size && source[i] != '\n') {
+                    ++i;
+                }
+                if (c == '#') {
+                    AddDefine(defines, source.substr(start, i - start));
+                }
+                continue;
+            }
+            if (c == '{') {
+                std::vector<std::string> tokens = Tokenize(declaration);
+                if (depth == 0 && tokens.size() >= 2 && tokens[0] == "uniform") {
+                    program.blocks.push_back(tokens[1]);
+                }
+                ++depth;
+                declaration.clear();
+            } else if (c == '}') {
+                --depth;
+                declaration.clear();
+            } else if (c == ';') {
+                std::vector<std::string> tokens = Tokenize(declaration);
+                // qualifiers, then the type, then the name
+                for (unsigned int t = 0; depth == 0 && t + 2 < tokens.size(); ++t) {
+                    if (tokens[t] == "uniform") {
+                        AddVariable(program, program.uniforms, tokens.back(), defines);
+                        break;
+                    } else if (tokens[t] == "in" && shader.type == GL_VERTEX_SHADER) {
+                        AddVariable(program, program.attributes, tokens.back(), defines);
+                        break;
+                    }
+                }
+                declaration.clear();
+            } else {
+                declaration += c;
+            }
+        }
+    }
+
+    static void GLAPIENTRY LinkProgram(GLuint id)
+    {
+        ++stats.glCalls;
+        RecordedProgram& program = programs[id];
+        program.attributes.clear();
+        program.uniforms.clear();
+        program.blocks.clear();
+        program.infoLog.clear();
+        for (unsigned int i = 0, size = (unsigned int)program.shaders.size(); i < size; ++i) {
+            ScanDeclarations(program, shaders[program.shaders[i]]);
+        }
+
+        GLint nextLocation = 0;
+        for (std::map<std::string, GLint>::iterator it = program.boundAttributes.begin();
+             it != program.boundAttributes.end(); ++it) {
+            nextLocation = it->second + 1 > nextLocation ? it->second + 1 : nextLocation;
+        }
+        for (unsigned int i = 0, size = (unsigned int)program.attributes.size(); i < size; ++i) {
+            RecordedVariable& attribute = program.attributes[i];
+            std::map<std::string, GLint>::iterator bound = program.boundAttributes.find(attribute.name);
+            attribute.location = bound != program.boundAttributes.end() ? bound->second : nextLocation++;
+        }
+        nextLocation = 0;
+        for (unsigned int i = 0, size = (unsigned int)program.uniforms.size(); i < size; ++i) {
+            // a zero sized array takes no location
+            RecordedVariable& uniform = program.uniforms[i];
+            uniform.location = uniform.size > 0 ? nextLocation : -1;
+            nextLocation += uniform.size;
+        }
+    }
+
+    static void GLAPIENTRY DeleteShader(GLuint shader)
+    {
+        ++stats.glCalls;
+        shaders.erase(shader);
+    }
+
+    static void GLAPIENTRY DeleteProgram(GLuint program)
+    {
+        ++stats.glCalls;
+        programs.erase(program);
+    }
+
+    static void GLAPIENTRY GetShaderiv(GLuint, GLenum pname, GLint* params)
+    {
+        ++stats.glCalls;
+        // everything compiles
+        *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    static void GLAPIENTRY GetProgramiv(GLuint id, GLenum pname, GLint* params)
+    {
+        ++stats.glCalls;
+        RecordedProgram& program = programs[id];
+        switch (pname) {
+        case GL_LINK_STATUS:       *params = program.infoLog.empty() ? GL_TRUE : GL_FALSE; break;
+        case GL_ACTIVE_ATTRIBUTES: *params = (GLint)program.attributes.size(); break;
+        case GL_ACTIVE_UNIFORMS:   *params = (GLint)program.uniforms.size(); break;
+        default:                   *params = 0; break;
+        }
+    }
+
+    static void GLAPIENTRY GetProgramInfoLog(GLuint id, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        ++stats.glCalls;
+        const std::string& log = programs[id].infoLog;
+        if (bufSize <= 0) {
+            return;
+        }
+        GLsizei written = (GLsizei)log.size() < bufSize - 1 ? (GLsizei)log.size() : bufSize - 1;
+        memcpy(infoLog, log.c_str(), (size_t)written);
+        infoLog[written] = '\0';
+        if (length != nullptr) {
+            *length = written;
+        }
+    }
+
+    static void GetActiveVariable(const std::vector<RecordedVariable>& variables, GLuint index,
+                                  GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        ++stats.glCalls;
+        if (index >= variables.size() || bufSize <= 0) {
+            return;
+        }
+        // arrays are reported by their first element, as drivers do
+        std::string reported = variables[index].name;
+        if (variables[index].size > 1) {
+            reported += "[0]";
+        }
+        GLsizei written = (GLsizei)reported.size() < bufSize - 1 ? (GLsizei)reported.size() : bufSize - 1;
+        memcpy(name, reported.c_str(), (size_t)written);
+        name[written] = '\0';
+        if (length != nullptr) {
+            *length = written;
+        }
+        *size = variables[index].size;
+        *type = GL_FLOAT;
+    }
+
+    static void GLAPIENTRY GetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize,
+                                           GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        GetActiveVariable(programs[program].attributes, index, bufSize, length, size, type, name);
+    }
+
+    static void GLAPIENTRY GetActiveUniform(GLuint program, GLuint index, GLsizei bufSize,
+                                            GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        GetActiveVariable(programs[program].uniforms, index, bufSize, length, size, type, name);
+    }
+
+    // "name", "name[0]" and "name[i]" all resolve, like a driver's lookup
+    static GLint FindLocation(const std::vector<RecordedVariable>& variables, const std::string& name)
+    {
+        ++stats.glCalls;
+        std::string base = name;
+        GLint element = 0;
+        size_t bracket = name.find('[');
+        if (bracket != std::string::npos) {
+            base = name.substr(0, bracket);
+            element = atoi(name.c_str() + bracket + 1);
+        }
+        for (unsigned int i = 0, size = (unsigned int)variables.size(); i < size; ++i) {
+            if (variables[i].name == base) {
+                return element < variables[i].size ? variables[i].location + element : -1;
+            }
+        }
+        return -1;
+    }
+
+    static GLint GLAPIENTRY GetAttribLocation(GLuint program, const GLchar* name)
+    {
+        return FindLocation(programs[program].attributes, name);
+    }
+
+    static GLint GLAPIENTRY GetUniformLocation(GLuint program, const GLchar* name)
+    {
+        return FindLocation(programs[program].uniforms, name);
+    }
+
+    static GLuint GLAPIENTRY GetUniformBlockIndex(GLuint id, const GLchar* name)
+    {
+        ++stats.glCalls;
+        const std::vector<std::string>& blocks = programs[id].blocks;
+        for (unsigned int i = 0, size = (unsigned int)blocks.size(); i < size; ++i) {
+            if (blocks[i] == name) {
+                return i;
+            }
+        }
+        return GL_INVALID_INDEX;
+    }
+
+    static void GLAPIENTRY BindBuffer(GLenum target, GLuint buffer)
+    {
+        ++stats.glCalls;
+        ++stats.bufferBinds;
+        boundBuffers[target] = buffer;
+    }
+
+    static void GLAPIENTRY BindBufferBase(GLenum target, GLuint, GLuint buffer)
+    {
+        BindBuffer(target, buffer);
+    }
+
+    static void GLAPIENTRY BufferData(GLenum, GLsizeiptr size, const void* data, GLenum)
+    {
+        ++stats.glCalls;
+        if (data != nullptr) {
+            stats.bufferBytes += (unsigned long long)size;
+        }
+    }
+
+    static void GLAPIENTRY BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield)
+    {
+        BufferData(target, size, data, 0);
+    }
+
+    static void GLAPIENTRY BufferSubData(GLenum, GLintptr, GLsizeiptr size, const void*)
+    {
+        ++stats.glCalls;
+        stats.bufferBytes += (unsigned long long)size;
+    }
+
+    static void* GLAPIENTRY MapBufferRange(GLenum target, GLintptr, GLsizeiptr length, GLbitfield access)
+    {
+        ++stats.glCalls;
+        if (access & GL_MAP_WRITE_BIT) {
+            stats.bufferBytes += (unsigned long long)length;
+        }
+        std::vector<char>& memory = mappings[boundBuffers[target]];
+        if (memory.size() < (size_t)length) {
+            memory.resize((size_t)length);
+        }
+        return memory.empty() ? nullptr : &memory[0];
+    }
+
+    static GLboolean GLAPIENTRY UnmapBuffer(GLenum)
+    {
+        ++stats.glCalls;
+        return GL_TRUE;
+    }
+
+    static void GLAPIENTRY DeleteBuffers(GLsizei n, const GLuint* buffers)
+    {
+        ++stats.glCalls;
+        for (GLsizei i = 0; i < n; ++i) {
+            mappings.erase(buffers[i]);
+        }
+    }
+
+    static GLsync GLAPIENTRY FenceSync(GLenum, GLbitfield)
+    {
+        ++stats.glCalls;
+        return (GLsync)(size_t)nextName++;
+    }
+
+    static GLenum GLAPIENTRY ClientWaitSync(GLsync, GLbitfield, GLuint64)
+    {
+        ++stats.glCalls;
+        return GL_ALREADY_SIGNALED;
+    }
+
+    // uniform uploads; element size in bytes is a template argument
+    template<typename T, unsigned int Bytes>
+    static void GLAPIENTRY UniformArray(GLint, GLsizei count, const T*)
+    {
+        ++stats.glCalls;
+        stats.uniformBytes += (unsigned long long)count * Bytes;
+    }
+
+    template<unsigned int Bytes>
+    static void GLAPIENTRY UniformMatrix(GLint, GLsizei count, GLboolean, const GLfloat*)
+    {
+        ++stats.glCalls;
+        stats.uniformBytes += (unsigned long long)count * Bytes;
+    }
+
+    static void GLAPIENTRY Uniform1i(GLint, GLint)
+    {
+        ++stats.glCalls;
+        stats.uniformBytes += sizeof(GLint);
+    }
+
+    static void GLAPIENTRY TexImage2D(GLenum, GLint, GLint, GLsizei width, GLsizei height,
+                                      GLint, GLenum format, GLenum type, const void* pixels)
+    {
+        ++stats.glCalls;
+        if (pixels == nullptr) {
+            return;
+        }
+        unsigned int components = 4;
+        switch (format) {
+        case GL_RED: components = 1; break;
+        case GL_RG:  components = 2; break;
+        case GL_RGB: components = 3; break;
+        default: break;
+        }
+        unsigned int componentBytes = 1;
+        switch (type) {
+        case GL_FLOAT:      componentBytes = 4; break;
+        case GL_HALF_FLOAT: componentBytes = 2; break;
+        default: break;
+        }
+        stats.textureBytes += (unsigned long long)width * height * components * componentBytes;
+    }
+
+    static void RecordDraw(GLsizei count, GLsizei instances)
+    {
+        ++stats.glCalls;
+        ++stats.drawCalls;
+        stats.instances += (unsigned long long)instances;
+        stats.vertices += (unsigned long long)count * instances;
+    }
+
+    static void GLAPIENTRY DrawArrays(GLenum, GLint, GLsizei count)
+    {
+        RecordDraw(count, 1);
+    }
+
+    static void GLAPIENTRY DrawElements(GLenum, GLsizei count, GLenum, const void*)
+    {
+        RecordDraw(count, 1);
+    }
+
+    static void GLAPIENTRY DrawArraysInstanced(GLenum, GLint, GLsizei count, GLsizei instances)
+    {
+        RecordDraw(count, instances);
+    }
+
+    static void GLAPIENTRY DrawElementsInstanced(GLenum, GLsizei count, GLenum, const void*, GLsizei instances)
+    {
+        RecordDraw(count, instances);
+    }
+
+    void Install()
+    {
+        if (installed) {
+            return;
+        }
+        installed = true;
+
+        // objects
+        Replace(__glewGenBuffers, GenNames);
+        Replace(__glewGenVertexArrays, GenNames);
+        Replace(GLBackend_GenTextures, GenNames);
+        Replace(__glewCreateProgram, CreateProgram);
+        Replace(__glewCreateShader, CreateShader);
+        Replace(__glewDeleteBuffers, DeleteBuffers);
+        IGNORE(__glewDeleteVertexArrays);
+        IGNORE(GLBackend_DeleteTextures);
+        Replace(__glewDeleteProgram, DeleteProgram);
+        Replace(__glewDeleteShader, DeleteShader);
+
+        // shaders
+        Replace(__glewShaderSource, ShaderSource);
+        IGNORE(__glewCompileShader);
+        Replace(__glewAttachShader, AttachShader);
+        Replace(__glewLinkProgram, LinkProgram);
+        Replace(__glewBindAttribLocation, BindAttribLocation);
+        IGNORE(__glewUniformBlockBinding);
+        IGNORE(__glewGetShaderInfoLog);
+        Replace(__glewGetProgramInfoLog, GetProgramInfoLog);
+        Replace(__glewGetActiveAttrib, GetActiveAttrib);
+        Replace(__glewGetActiveUniform, GetActiveUniform);
+        Replace(__glewGetShaderiv, GetShaderiv);
+        Replace(__glewGetProgramiv, GetProgramiv);
+        Replace(__glewGetAttribLocation, GetAttribLocation);
+        Replace(__glewGetUniformLocation, GetUniformLocation);
+        Replace(__glewGetUniformBlockIndex, GetUniformBlockIndex);
+
+        // buffers
+        Replace(__glewBindBuffer, BindBuffer);
+        Replace(__glewBindBufferBase, BindBufferBase);
+        Replace(__glewBufferData, BufferData);
+        Replace(__glewBufferStorage, BufferStorage);
+        Replace(__glewBufferSubData, BufferSubData);
+        Replace(__glewMapBufferRange, MapBufferRange);
+        Replace(__glewUnmapBuffer, UnmapBuffer);
+        Replace(__glewFenceSync, FenceSync);
+        Replace(__glewClientWaitSync, ClientWaitSync);
+        IGNORE(__glewDeleteSync);
+
+        // state
+        COUNT(__glewUseProgram, programChanges);
+        COUNT(__glewActiveTexture, textureChanges);
+        COUNT(GLBackend_BindTexture, textureChanges);
+        COUNT(__glewBindVertexArray, vertexArrayChanges);
+        COUNT(__glewVertexAttribPointer, attributeChanges);
+        COUNT(__glewVertexAttribIPointer, attributeChanges);
+        COUNT(__glewEnableVertexAttribArray, attributeChanges);
+        COUNT(__glewDisableVertexAttribArray, attributeChanges);
+
+        // textures
+        Replace(GLBackend_TexImage2D, TexImage2D);
+        IGNORE(GLBackend_TexParameteri);
+        IGNORE(__glewGenerateMipmap);
+
+        // uniforms
+        Replace(__glewUniform1i, Uniform1i);
+        Replace(__glewUniform1iv, UniformArray<GLint, 4>);
+        Replace(__glewUniform2iv, UniformArray<GLint, 8>);
+        Replace(__glewUniform4iv, UniformArray<GLint, 16>);
+        Replace(__glewUniform1fv, UniformArray<GLfloat, 4>);
+        Replace(__glewUniform2fv, UniformArray<GLfloat, 8>);
+        Replace(__glewUniform3fv, UniformArray<GLfloat, 12>);
+        Replace(__glewUniform4fv, UniformArray<GLfloat, 16>);
+        Replace(__glewUniformMatrix4fv, UniformMatrix<64>);
+        Replace(__glewUniformMatrix2x4fv, UniformMatrix<32>);
+        Replace(__glewUniformMatrix3x4fv, UniformMatrix<48>);
+
+        // draws
+        Replace(GLBackend_DrawArrays, DrawArrays);
+        Replace(GLBackend_DrawElements, DrawElements);
+        Replace(__glewDrawArraysInstanced, DrawArraysInstanced);
+        Replace(__glewDrawElementsInstanced, DrawElementsInstanced);
+
+        ResetStats();
+    }
+
+#undef COUNT
+#undef IGNORE
+
+    void Uninstall()
+    {
+        for (unsigned int i = 0, size = (unsigned int)restorers.size(); i < size; ++i) {
+            restorers[i]();
+        }
+        restorers.clear();
+        boundBuffers.clear();
+        mappings.clear();
+        shaders.clear();
+        programs.clear();
+        installed = false;
+    }
+
+    bool IsInstalled()
+    {
+        return installed;
+    }
+
+    const GLRecorderStats& GetStats()
+    {
+        return stats;
+    }
+
+    void ResetStats()
+    {
+        memset(&stats, 0, sizeof(stats));
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const GLRecorderStats& stats)
+{
+    unsigned int stateChanges = stats.programChanges + stats.textureChanges +
+                                stats.vertexArrayChanges + stats.bufferBinds +
+                                stats.attributeChanges;
+    os << stats.drawCalls << " draws, "
+       << stats.instances << " instances, "
+       << stats.vertices << " vertices, "
+       << stats.bufferBytes << " buffer bytes, "
+       << stats.uniformBytes << " uniform bytes, "
+       << stats.textureBytes << " texture bytes, "
+       << stateChanges << " state changes ("
+       << stats.programChanges << " program, "
+       << stats.textureChanges << " texture, "
+       << stats.vertexArrayChanges << " vertex array, "
+       << stats.bufferBinds << " buffer, "
+       << stats.attributeChanges << " attribute), "
+       << stats.glCalls << " GL calls";
+    return os;
+}
@@ -0,0 +1,45 @@
+#ifndef GL_RECORDER_H_INCLUDED
+#define GL_RECORDER_H_INCLUDED
+
+#include <ostream>
+
+#include <GLBackend.h>
+
+// what the recorded calls would have cost
+struct GLRecorderStats
+{
+    unsigned int glCalls;
+    unsigned int drawCalls;
+    unsigned long long instances;
+    unsigned long long vertices;      // per instance count times instances
+    unsigned long long bufferBytes;   // buffer data, sub data and mapped ranges
+    unsigned long long uniformBytes;  // glUniform*
+    unsigned long long textureBytes;  // glTexImage2D with pixels
+    // state changes
+    unsigned int programChanges;
+    unsigned int textureChanges;      // glBindTexture and glActiveTexture
+    unsigned int vertexArrayChanges;
+    unsigned int bufferBinds;
+    unsigned int attributeChanges;    // attribute pointers, enables, disables
+};
+
+// Replaces every GL entry point the render path uses (GLEW's pointers
+// and the GLBackend ones) with stand-ins that count calls and bytes
+// instead of issuing them. Needs no GL context: names are handed out
+// from a counter, shaders always compile and mapped buffers point to
+// scratch memory. Install before any GL object is created.
+namespace GLRecorder
+{
+    void Install();
+    // restores the entry points that were there before Install
+    void Uninstall();
+    bool IsInstalled();
+
+    const GLRecorderStats& GetStats();
+    // call at the start of each frame for per frame numbers
+    void ResetStats();
+}
+
+std::ostream& operator<<(std::ostream& os, const GLRecorderStats& stats);
+
+#endif // GL_RECORDER_H_INCLUDED
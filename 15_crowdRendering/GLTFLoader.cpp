@@ -8,6 +8,7 @@
 #include <Clip.h>
 #include <iostream>
 #include <cstring>
+#include <functional>
 
 cgltf_data* LoadGLTFFile(const char* path)
 {
@@ -83,10 +84,9 @@ namespace GLTFHelpers
             return -1;
         }
 
-        for (unsigned int i = 0; i < numNodes; ++i) {
-            if (target == &allNodes[i]) {
-                return (int)i;
-            }
+        // nodes are stored in one array, so the index is the pointer offset
+        if (target >= allNodes && target < allNodes + numNodes) {
+            return (int)(target - allNodes);
         }
 
         std::cout << "Failed to find target node index" << std::endl;
@@ -97,6 +97,29 @@ namespace GLTFHelpers
                         unsigned int compCount,             // num elements per component
                         const cgltf_accessor& inAccessor) {
         out.resize(inAccessor.count * compCount);
+        if (out.empty()) {
+            return;
+        }
+
+        // tightly packed float data can be copied straight from the buffer
+        const cgltf_buffer_view* view = inAccessor.buffer_view;
+        if (!inAccessor.is_sparse &&
+            view != nullptr &&
+            inAccessor.component_type == cgltf_component_type_r_32f &&
+            cgltf_num_components(inAccessor.type) == compCount &&
+            inAccessor.stride == compCount * sizeof(float))
+        {
+            const unsigned char* viewData = (const unsigned char*)view->data;
+            if (viewData == nullptr && view->buffer != nullptr) {
+                viewData = (const unsigned char*)view->buffer->data + view->offset;
+            }
+            cgltf_size numBytes = out.size() * sizeof(float);
+            if (viewData != nullptr && inAccessor.offset + numBytes <= view->size) {
+                memcpy(&out[0], viewData + inAccessor.offset, numBytes);
+                return;
+            }
+        }
+
         for (cgltf_size i = 0; i < inAccessor.count; ++i) {
             cgltf_accessor_read_float(&inAccessor,
                                       i,
@@ -150,11 +173,75 @@ namespace GLTFHelpers
         }
     }
 
+    void GetIndexValues(std::vector<unsigned int>& out,
+                        const cgltf_accessor& inAccessor) {
+        out.resize(inAccessor.count);
+        if (out.empty()) {
+            return;
+        }
+
+        const cgltf_buffer_view* view = inAccessor.buffer_view;
+        if (!inAccessor.is_sparse && view != nullptr) {
+            const unsigned char* viewData = (const unsigned char*)view->data;
+            if (viewData == nullptr && view->buffer != nullptr) {
+                viewData = (const unsigned char*)view->buffer->data + view->offset;
+            }
+            cgltf_size stride = inAccessor.stride;
+            if (viewData != nullptr && 
+                inAccessor.offset + stride * inAccessor.count <= view->size)
+            {
+                const unsigned char* src = viewData + inAccessor.offset;
+                unsigned int count = (unsigned int)inAccessor.count;
+                if (inAccessor.component_type == cgltf_component_type_r_32u && stride == 4) {
+                    memcpy(&out[0], src, count * sizeof(unsigned int));
+                    return;
+                }
+                if (inAccessor.component_type == cgltf_component_type_r_16u && stride == 2) {
+                    const unsigned short* src16 = (const unsigned short*)src;
+                    for (unsigned int i = 0; i < count; ++i) {
+                        out[i] = src16[i];
+                    }
+                    return;
+                }
+            }
+        }
+
+        for (cgltf_size i = 0; i < inAccessor.count; ++i) {
+            out[i] = (unsigned int)cgltf_accessor_read_index(&inAccessor, i);
+        }
+    }
+
+    // maps skin relative joint indices to node indices, built once per skin
+    std::vector<int> GetSkinJointNodes(cgltf_skin* skin,
+                                       cgltf_node* nodes,
+                                       unsigned int nodeCount) {
+        std::vector<int> result(skin->joints_count);
+        for (unsigned int i = 0; i < skin->joints_count; ++i) {
+            // prevent any negative indices
+            result[i] = std::max(0, GetNodeIndex(skin->joints[i], nodes, nodeCount));
+        }
+        return result;
+    }
+
+    // runs func(i) for i in [0, count), split across jobs if there are any
+    void ParallelFor(JobSystem* jobs, const char* name, unsigned int count,
+                     const std::function<void(unsigned int)>& func) {
+        if (jobs == nullptr) {
+            for (unsigned int i = 0; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+        jobs->ParallelFor(name, count, 1, [&func](unsigned int begin, unsigned int end) {
+            for (unsigned int i = begin; i < end; ++i) {
+                func(i);
+            }
+        });
+    }
+
     void MeshFromAttribute(Mesh& outMesh,
                            cgltf_attribute& attribute,
-                           cgltf_skin* skin,
-                           cgltf_node* nodes,
-                           unsigned int nodeCount) {
+                           const std::vector<int>& skinJointNodes) {
         cgltf_attribute_type attribType = attribute.type;
         cgltf_accessor& accessor = *attribute.data;
         
@@ -176,7 +263,18 @@ namespace GLTFHelpers
         std::vector<Vec2>& texCoords = outMesh.GetTexCoords();
         std::vector<iVec4>& influences = outMesh.GetInfluences();
         std::vector<Vec4>& weights = outMesh.GetWeights();
+
+        switch (attribType)
+        {
+        case cgltf_attribute_type_position: positions.reserve(accessorCount); break;
+        case cgltf_attribute_type_texcoord: texCoords.reserve(accessorCount); break;
+        case cgltf_attribute_type_weights: weights.reserve(accessorCount); break;
+        case cgltf_attribute_type_normal: normals.reserve(accessorCount); break;
+        case cgltf_attribute_type_joints: influences.reserve(accessorCount); break;
+        default: break;
+        }
         
+        unsigned int numSkinJoints = skinJointNodes.size();
         for (unsigned int i = 0; i < accessorCount; ++i) {
             int index = i * componentCount;
             switch (attribType)
@@ -209,16 +307,10 @@ namespace GLTFHelpers
                                      (int)(values[index + 2] + 0.5f),
                                      (int)(values[index + 3] + 0.5));
                 // convert from skin relative to joint hierarchy relative
-                joints.x = GetNodeIndex(skin->joints[joints.x], nodes, nodeCount);
-                joints.y = GetNodeIndex(skin->joints[joints.y], nodes, nodeCount);
-                joints.z = GetNodeIndex(skin->joints[joints.z], nodes, nodeCount);
-                joints.w = GetNodeIndex(skin->joints[joints.w], nodes, nodeCount);
-                
-                // prevent any negative indices
-                joints.x = std::max(0, joints.x);
-                joints.y = std::max(0, joints.y);
-                joints.z = std::max(0, joints.z);
-                joints.w = std::max(0, joints.w);
+                for (int c = 0; c < 4; ++c) {
+                    int& joint = joints.v[c];
+                    joint = (joint >= 0 && joint < (int)numSkinJoints) ? skinJointNodes[joint] : 0;
+                }
                 
                 influences.push_back(joints);
                 break;
@@ -321,12 +413,14 @@ Skeleton LoadSkeleton(cgltf_data* data)
                     LoadJointNames(data));                    
 }
 
-std::vector<Mesh> LoadMeshes(cgltf_data* data)
+std::vector<Mesh> LoadMeshes(cgltf_data* data, bool uploadToGPU, JobSystem* jobs)
 {
-    std::vector<Mesh> result;
     cgltf_node* nodes = data->nodes;
     unsigned int nodeCount = data->nodes_count;
-    
+
+    // primitives in glTF can be thought of as sub meshes
+    std::vector<cgltf_primitive*> primitives;
+    std::vector<unsigned int> primitiveSkins;
     for (unsigned int i = 0; i < nodeCount; ++i) {
         cgltf_node* node = &nodes[i];
         
@@ -334,67 +428,86 @@ std::vector<Mesh> LoadMeshes(cgltf_data* data)
             continue;
         }
         
-        // primitives in glTF can be thought of as sub meshes
-        int numPrims = node->mesh->primitives_count;
-        for (int j = 0; j < numPrims; ++j) {
-            result.push_back(Mesh());
-            Mesh& mesh = result[result.size() - 1];
-            
-            cgltf_primitive* primitive = &node->mesh->primitives[j];
-            
-            unsigned int ac = primitive->attributes_count;
-            for (unsigned int k = 0; k < ac; ++k) {
-                cgltf_attribute* attribute = &primitive->attributes[k];
-                GLTFHelpers::MeshFromAttribute(mesh, *attribute, node->skin, nodes, nodeCount);
-            }
-            
-            if (primitive->indices != nullptr) {
-                int ic = primitive->indices->count;
-                std::vector<unsigned int>& indices = mesh.GetIndices();
-                indices.resize(ic);
-                
-                for (unsigned int k = 0; k < ic; ++k) {
-                    indices[k] = cgltf_accessor_read_index(primitive->indices, k);
-                }
-            }
-            
-            mesh.UpdateOpenGLBuffers();
+        unsigned int skinIndex = (unsigned int)(node->skin - data->skins);
+        unsigned int numPrims = node->mesh->primitives_count;
+        for (unsigned int j = 0; j < numPrims; ++j) {
+            primitives.push_back(&node->mesh->primitives[j]);
+            primitiveSkins.push_back(skinIndex);
+        }
+    }
+
+    std::vector<std::vector<int> > skinJointNodes(data->skins_count);
+    for (unsigned int i = 0; i < data->skins_count; ++i) {
+        skinJointNodes[i] = GLTFHelpers::GetSkinJointNodes(&data->skins[i], nodes, nodeCount);
+    }
+
+    // GL objects are only created by the upload below, which stays on the
+    // calling thread
+    std::vector<Mesh> result(primitives.size());
+    GLTFHelpers::ParallelFor(jobs, "LoadMeshes", (unsigned int)primitives.size(), [&](unsigned int i) {
+        Mesh& mesh = result[i];
+        cgltf_primitive* primitive = primitives[i];
+        
+        unsigned int ac = primitive->attributes_count;
+        for (unsigned int k = 0; k < ac; ++k) {
+            cgltf_attribute* attribute = &primitive->attributes[k];
+            GLTFHelpers::MeshFromAttribute(mesh, *attribute, skinJointNodes[primitiveSkins[i]]);
+        }
+        
+        if (primitive->indices != nullptr) {
+            GLTFHelpers::GetIndexValues(mesh.GetIndices(), *primitive->indices);
+        }
+    });
+
+    if (uploadToGPU) {
+        for (unsigned int i = 0; i < result.size(); ++i) {
+            result[i].UpdateOpenGLBuffers();
         }
     }
     
     return result;
 }
 
-std::vector<Clip> LoadAnimationClips(cgltf_data* data) {
-    unsigned int numClips = data->animations_count;
+Clip LoadAnimationClip(cgltf_data* data, unsigned int index)
+{
     unsigned int numNodes = data->nodes_count;
+    cgltf_animation& animation = data->animations[index];
+
+    Clip result;
+    result.SetName(animation.name);
+
+    unsigned int numChannels = animation.channels_count;
+    for (unsigned int j = 0; j < numChannels; ++j) {
+        cgltf_animation_channel& channel = animation.channels[j];
+        cgltf_node* target = channel.target_node;
+        int nodeId = GLTFHelpers::GetNodeIndex(target, data->nodes, numNodes);
+
+        if (channel.target_path == cgltf_animation_path_type_translation) {
+            VectorTrack& track = result[nodeId].GetPositionTrack();
+            GLTFHelpers::TrackFromChannel<Vec3, 3>(track, channel);
+        } else if (channel.target_path == cgltf_animation_path_type_scale) {
+            VectorTrack& track = result[nodeId].GetScaleTrack();
+            GLTFHelpers::TrackFromChannel<Vec3, 3>(track, channel);
+        } else if (channel.target_path == cgltf_animation_path_type_rotation) {
+            QuaternionTrack& track = result[nodeId].GetRotationTrack();
+            GLTFHelpers::TrackFromChannel<Quat, 4>(track, channel);
+        }
+    }
+
+    result.RecalculateDuration();
+    return result;
+}
+
+std::vector<Clip> LoadAnimationClips(cgltf_data* data, JobSystem* jobs) {
+    unsigned int numClips = data->animations_count;
 
     std::vector<Clip> result;
     result.resize(numClips);
 
-    for (unsigned int i = 0; i < numClips; ++i) {
-        result[i].SetName(data->animations[i].name);
-
-        unsigned int numChannels = data->animations[i].channels_count;
-        for (unsigned int j = 0; j < numChannels; ++j) {
-            cgltf_animation_channel& channel = data->animations[i].channels[j];
-            cgltf_node* target = channel.target_node;
-            int nodeId = GLTFHelpers::GetNodeIndex(target, data->nodes, numNodes);
-
-            if (channel.target_path == cgltf_animation_path_type_translation) {
-                VectorTrack& track = result[i][nodeId].GetPositionTrack();
-                GLTFHelpers::TrackFromChannel<Vec3, 3>(track, channel);
-            } else if (channel.target_path == cgltf_animation_path_type_scale) {
-                VectorTrack& track = result[i][nodeId].GetScaleTrack();
-                GLTFHelpers::TrackFromChannel<Vec3, 3>(track, channel);
-            } else if (channel.target_path == cgltf_animation_path_type_rotation) {
-                QuaternionTrack& track = result[i][nodeId].GetRotationTrack();
-                GLTFHelpers::TrackFromChannel<Quat, 4>(track, channel);
-            }
-        }
-
-        result[i].RecalculateDuration();
-    }
+    // clips are independent of each other
+    GLTFHelpers::ParallelFor(jobs, "LoadAnimationClips", numClips, [&](unsigned int i) {
+        result[i] = LoadAnimationClip(data, i);
+    });
 
     return result;
 }
@@ -8,14 +8,21 @@
 #include <Clip.h>
 #include <Skeleton.h>
 #include <Mesh.h>
+#include <JobSystem.h>
 
 cgltf_data* LoadGLTFFile(const char* path);
 void        FreeGLTFFile(cgltf_data* data);
 Pose        LoadRestPose(cgltf_data* data);
 Pose        LoadBindPose(cgltf_data* data);
 Skeleton    LoadSkeleton(cgltf_data* data);
-std::vector<Mesh>        LoadMeshes(cgltf_data* data);
-std::vector<Clip>        LoadAnimationClips(cgltf_data* data);
+// without uploading, the meshes only hold CPU side data (no GL context
+// needed) until Mesh::UpdateOpenGLBuffers is called. With jobs, meshes and
+// clips are imported side by side on its threads; the caller calls
+// jobs->WaitAll to recycle them. AssetLoader workers pass none, so loads
+// don't start more threads than there are cores.
+std::vector<Mesh>        LoadMeshes(cgltf_data* data, bool uploadToGPU = true, JobSystem* jobs = nullptr);
+std::vector<Clip>        LoadAnimationClips(cgltf_data* data, JobSystem* jobs = nullptr);
+Clip                     LoadAnimationClip(cgltf_data* data, unsigned int index);
 std::vector<std::string> LoadJointNames(cgltf_data* data);
 
 #endif // GLTF_LOADER_H_INCLUDED
@@ -0,0 +1,399 @@
+#include <IKBatchSolver.h>
+
+IKBatchSolver::IKBatchSolver() :
+    numChains(0),
+    chainLength(0),
+    numSteps(15),
+    threshold(0.00001f),
+    warmStart(false),
+    lastIterations(0)
+{
+}
+
+void IKBatchSolver::Resize(unsigned int newNumChains, unsigned int newChainLength)
+{
+    numChains = newNumChains;
+    chainLength = newChainLength;
+
+    unsigned int numJoints = numChains * chainLength;
+    localChains.assign(numJoints, Transform());
+    posX.assign(numJoints, 0.0f);
+    posY.assign(numJoints, 0.0f);
+    posZ.assign(numJoints, 0.0f);
+    lengths.assign(numJoints, 0.0f);
+    prevX.assign(numJoints, 0.0f);
+    prevY.assign(numJoints, 0.0f);
+    prevZ.assign(numJoints, 0.0f);
+    hasPrevious.assign(numChains, 0);
+
+    baseX.assign(numChains, 0.0f);
+    baseY.assign(numChains, 0.0f);
+    baseZ.assign(numChains, 0.0f);
+    goalX.assign(numChains, 0.0f);
+    goalY.assign(numChains, 0.0f);
+    goalZ.assign(numChains, 0.0f);
+    active.assign(numChains, 0.0f);
+    converged.assign(numChains, 0);
+    rotX.assign(numChains, 0.0f);
+    rotY.assign(numChains, 0.0f);
+    rotZ.assign(numChains, 0.0f);
+    rotW.assign(numChains, 1.0f);
+    lastIterations = 0;
+}
+
+void IKBatchSolver::SetChain(unsigned int chain, const std::vector<Transform>& local)
+{
+    unsigned int count = (unsigned int)local.size();
+    if (count > chainLength) {
+        count = chainLength;
+    }
+    for (unsigned int i = 0; i < count; ++i) {
+        localChains[chain * chainLength + i] = local[i];
+    }
+}
+
+void IKBatchSolver::GetChain(unsigned int chain, std::vector<Transform>& outLocal) const
+{
+    if (outLocal.size() != chainLength) {
+        outLocal.resize(chainLength);
+    }
+    for (unsigned int i = 0; i < chainLength; ++i) {
+        outLocal[i] = localChains[chain * chainLength + i];
+    }
+    if (chainLength == 0) { return; }
+
+    // rotate each joint so its child lands on the solved position, same as
+    // FABRIKSolver::WorldToIKChain but walking the chain only once
+    Transform parentWorld;
+    for (unsigned int i = 0; i < chainLength - 1; ++i)
+    {
+        Transform world = (i == 0) ? outLocal[0] : combine(parentWorld, outLocal[i]);
+        Transform next = combine(world, outLocal[i + 1]);
+        Quat invRotation = inverse(world.rotation);
+
+        Vec3 toNext = invRotation * (next.position - world.position);
+        Vec3 toDesired = invRotation * (GetWorldPosition(chain, i + 1) - world.position);
+
+        Quat delta = fromTo(toNext, toDesired);
+        outLocal[i].rotation = delta * outLocal[i].rotation;
+
+        // the parent of the next joint uses the corrected rotation
+        parentWorld = (i == 0) ? outLocal[0] : combine(parentWorld, outLocal[i]);
+    }
+}
+
+Vec3 IKBatchSolver::GetWorldPosition(unsigned int chain, unsigned int joint) const
+{
+    unsigned int index = joint * numChains + chain;
+    return Vec3(posX[index], posY[index], posZ[index]);
+}
+
+void IKBatchSolver::SetGoal(unsigned int chain, const Vec3& goal)
+{
+    goalX[chain] = goal.x;
+    goalY[chain] = goal.y;
+    goalZ[chain] = goal.z;
+}
+
+void IKBatchSolver::ChainsToWorld()
+{
+    for (unsigned int c = 0; c < numChains; ++c)
+    {
+        Transform world;
+        for (unsigned int i = 0; i < chainLength; ++i)
+        {
+            const Transform& local = localChains[c * chainLength + i];
+            world = (i == 0) ? local : combine(world, local);
+
+            unsigned int index = i * numChains + c;
+            posX[index] = world.position.x;
+            posY[index] = world.position.y;
+            posZ[index] = world.position.z;
+            if (i >= 1) {
+                unsigned int prev = index - numChains;
+                Vec3 bone(posX[index] - posX[prev],
+                          posY[index] - posY[prev],
+                          posZ[index] - posZ[prev]);
+                lengths[index] = len(bone);
+            } else {
+                lengths[index] = 0.0f; // difference between root joint and itself
+            }
+        }
+
+        baseX[c] = posX[c];
+        baseY[c] = posY[c];
+        baseZ[c] = posZ[c];
+
+        // start from the last solution, carried along by the base movement
+        if (warmStart && hasPrevious[c]) {
+            float dx = baseX[c] - prevX[c];
+            float dy = baseY[c] - prevY[c];
+            float dz = baseZ[c] - prevZ[c];
+            for (unsigned int i = 1; i < chainLength; ++i) {
+                unsigned int index = i * numChains + c;
+                posX[index] = prevX[index] + dx;
+                posY[index] = prevY[index] + dy;
+                posZ[index] = prevZ[index] + dz;
+            }
+        }
+    }
+
+    for (unsigned int c = 0; c < numChains; ++c) {
+        active[c] = 1.0f;
+        converged[c] = 0;
+    }
+}
+
+void IKBatchSolver::StorePrevious()
+{
+    prevX = posX;
+    prevY = posY;
+    prevZ = posZ;
+    for (unsigned int c = 0; c < numChains; ++c) {
+        hasPrevious[c] = 1;
+    }
+}
+
+// masks out lanes whose effector is close enough to the goal
+// returns the number of lanes still iterating
+unsigned int IKBatchSolver::UpdateActiveLanes()
+{
+    float threshSqd = threshold * threshold;
+    unsigned int base = (chainLength - 1) * numChains;
+    unsigned int numActive = 0;
+    for (unsigned int c = 0; c < numChains; ++c)
+    {
+        float dx = posX[base + c] - goalX[c];
+        float dy = posY[base + c] - goalY[c];
+        float dz = posZ[base + c] - goalZ[c];
+        if (dx*dx + dy*dy + dz*dz < threshSqd) {
+            converged[c] = 1;
+            active[c] = 0.0f;
+        }
+        numActive += (active[c] != 0.0f) ? 1 : 0;
+    }
+    return numActive;
+}
+
+// branch free lane update: inactive lanes (mask 0) keep their old position
+#define IK_LANE_SET(arr, index, value, mask) \
+    arr[index] = arr[index] + ((value) - arr[index]) * (mask)
+
+// The lane loops index rows through pointers rather than joint * numChains
+// + chain, whose unsigned wrap around keeps the compiler from vectorizing,
+// pick the divisor before dividing instead of branching around it, and
+// tell GCC the rows don't overlap (ivdep); they touch more arrays than it
+// is willing to check against each other at run time.
+
+void IKBatchSolver::IterateBackward()
+{
+    unsigned int last = chainLength - 1;
+    const float* mask = active.data();
+    float* ex = posX.data() + last * numChains;
+    float* ey = posY.data() + last * numChains;
+    float* ez = posZ.data() + last * numChains;
+    const float* gx = goalX.data();
+    const float* gy = goalY.data();
+    const float* gz = goalZ.data();
+
+    #pragma GCC ivdep
+    for (unsigned int c = 0; c < numChains; ++c) {
+        IK_LANE_SET(ex, c, gx[c], mask[c]);
+        IK_LANE_SET(ey, c, gy[c], mask[c]);
+        IK_LANE_SET(ez, c, gz[c], mask[c]);
+    }
+
+    for (int i = (int)last - 1; i >= 0; --i)
+    {
+        unsigned int row = (unsigned int)i * numChains;
+        float* px = posX.data() + row;
+        float* py = posY.data() + row;
+        float* pz = posZ.data() + row;
+        const float* nx = px + numChains;
+        const float* ny = py + numChains;
+        const float* nz = pz + numChains;
+        const float* length = lengths.data() + row + numChains;
+        #pragma GCC ivdep
+        for (unsigned int c = 0; c < numChains; ++c)
+        {
+            float dx = px[c] - nx[c];
+            float dy = py[c] - ny[c];
+            float dz = pz[c] - nz[c];
+            float lenSqd = dx*dx + dy*dy + dz*dz;
+            bool valid = lenSqd > VEC3_EPSILON;
+            float scale = length[c] * (valid ? 1.0f : 0.0f) / sqrtf(valid ? lenSqd : 1.0f);
+            IK_LANE_SET(px, c, nx[c] + dx * scale, mask[c]);
+            IK_LANE_SET(py, c, ny[c] + dy * scale, mask[c]);
+            IK_LANE_SET(pz, c, nz[c] + dz * scale, mask[c]);
+        }
+    }
+}
+
+void IKBatchSolver::IterateForward()
+{
+    const float* mask = active.data();
+    float* bx = posX.data();
+    float* by = posY.data();
+    float* bz = posZ.data();
+    const float* sx = baseX.data();
+    const float* sy = baseY.data();
+    const float* sz = baseZ.data();
+
+    #pragma GCC ivdep
+    for (unsigned int c = 0; c < numChains; ++c) {
+        IK_LANE_SET(bx, c, sx[c], mask[c]);
+        IK_LANE_SET(by, c, sy[c], mask[c]);
+        IK_LANE_SET(bz, c, sz[c], mask[c]);
+    }
+
+    for (unsigned int i = 1; i < chainLength; ++i)
+    {
+        unsigned int row = i * numChains;
+        float* px = posX.data() + row;
+        float* py = posY.data() + row;
+        float* pz = posZ.data() + row;
+        const float* fx = px - numChains;
+        const float* fy = py - numChains;
+        const float* fz = pz - numChains;
+        const float* length = lengths.data() + row;
+        #pragma GCC ivdep
+        for (unsigned int c = 0; c < numChains; ++c)
+        {
+            float dx = px[c] - fx[c];
+            float dy = py[c] - fy[c];
+            float dz = pz[c] - fz[c];
+            float lenSqd = dx*dx + dy*dy + dz*dz;
+            bool valid = lenSqd > VEC3_EPSILON;
+            float scale = length[c] * (valid ? 1.0f : 0.0f) / sqrtf(valid ? lenSqd : 1.0f);
+            IK_LANE_SET(px, c, fx[c] + dx * scale, mask[c]);
+            IK_LANE_SET(py, c, fy[c] + dy * scale, mask[c]);
+            IK_LANE_SET(pz, c, fz[c] + dz * scale, mask[c]);
+        }
+    }
+}
+
+// one CCD step: rotate everything after the joint so the effector points
+// at the goal. The rotation is the shortest arc quaternion between the two
+// directions, built as (cross(a,b), |a||b| + dot(a,b)) and normalized.
+// The rotations of every lane are built first, then applied joint by
+// joint, so both loops run over contiguous lanes with a fixed trip count
+void IKBatchSolver::RotateAboutJoint(unsigned int joint)
+{
+    unsigned int last = chainLength - 1;
+    const float* jx = posX.data() + joint * numChains;
+    const float* jy = posY.data() + joint * numChains;
+    const float* jz = posZ.data() + joint * numChains;
+    const float* ex = posX.data() + last * numChains;
+    const float* ey = posY.data() + last * numChains;
+    const float* ez = posZ.data() + last * numChains;
+    const float* gx = goalX.data();
+    const float* gy = goalY.data();
+    const float* gz = goalZ.data();
+    float* qx = rotX.data();
+    float* qy = rotY.data();
+    float* qz = rotZ.data();
+    float* qw = rotW.data();
+    const float* mask = active.data();
+
+    #pragma GCC ivdep
+    for (unsigned int c = 0; c < numChains; ++c)
+    {
+        float ax = ex[c] - jx[c];
+        float ay = ey[c] - jy[c];
+        float az = ez[c] - jz[c];
+        float bx = gx[c] - jx[c];
+        float by = gy[c] - jy[c];
+        float bz = gz[c] - jz[c];
+
+        float x = ay * bz - az * by;
+        float y = az * bx - ax * bz;
+        float z = ax * by - ay * bx;
+        float lenA = sqrtf(ax*ax + ay*ay + az*az);
+        float lenB = sqrtf(bx*bx + by*by + bz*bz);
+        float w = lenA * lenB + (ax*bx + ay*by + az*bz);
+
+        // degenerate (zero length or opposite directions) and inactive
+        // lanes use the identity rotation
+        float lenSqd = x*x + y*y + z*z + w*w;
+        bool valid = lenSqd > QUAT_EPSILON;
+        float invLen = mask[c] * (valid ? 1.0f : 0.0f) / sqrtf(valid ? lenSqd : 1.0f);
+        qx[c] = x * invLen;
+        qy[c] = y * invLen;
+        qz[c] = z * invLen;
+        qw[c] = w * invLen + ((invLen != 0.0f) ? 0.0f : 1.0f);
+    }
+
+    // v' = v + 2w(q x v) + 2(q x (q x v))
+    for (unsigned int k = joint + 1; k <= last; ++k)
+    {
+        float* px = posX.data() + k * numChains;
+        float* py = posY.data() + k * numChains;
+        float* pz = posZ.data() + k * numChains;
+        #pragma GCC ivdep
+        for (unsigned int c = 0; c < numChains; ++c)
+        {
+            float vx = px[c] - jx[c];
+            float vy = py[c] - jy[c];
+            float vz = pz[c] - jz[c];
+            float tx = 2.0f * (qy[c] * vz - qz[c] * vy);
+            float ty = 2.0f * (qz[c] * vx - qx[c] * vz);
+            float tz = 2.0f * (qx[c] * vy - qy[c] * vx);
+            px[c] = jx[c] + vx + qw[c] * tx + (qy[c] * tz - qz[c] * ty);
+            py[c] = jy[c] + vy + qw[c] * ty + (qz[c] * tx - qx[c] * tz);
+            pz[c] = jz[c] + vz + qw[c] * tz + (qx[c] * ty - qy[c] * tx);
+        }
+    }
+}
+
+#undef IK_LANE_SET
+
+unsigned int IKBatchSolver::SolveFABRIK()
+{
+    lastIterations = 0;
+    if (numChains == 0 || chainLength == 0) { return 0; }
+
+    ChainsToWorld();
+    for (unsigned int i = 0; i < numSteps; ++i)
+    {
+        if (UpdateActiveLanes() == 0) {
+            break;
+        }
+        IterateBackward();
+        IterateForward();
+        lastIterations = i + 1;
+    }
+    UpdateActiveLanes();
+    StorePrevious();
+
+    unsigned int numConverged = 0;
+    for (unsigned int c = 0; c < numChains; ++c) {
+        numConverged += converged[c];
+    }
+    return numConverged;
+}
+
+unsigned int IKBatchSolver::SolveCCD()
+{
+    lastIterations = 0;
+    if (numChains == 0 || chainLength == 0) { return 0; }
+
+    ChainsToWorld();
+    for (unsigned int i = 0; i < numSteps; ++i)
+    {
+        if (UpdateActiveLanes() == 0) {
+            break;
+        }
+        for (int j = (int)chainLength - 2; j >= 0; --j) {
+            RotateAboutJoint((unsigned int)j);
+        }
+        lastIterations = i + 1;
+    }
+    UpdateActiveLanes();
+    StorePrevious();
+
+    unsigned int numConverged = 0;
+    for (unsigned int c = 0; c < numChains; ++c) {
+        numConverged += converged[c];
+    }
+    return numConverged;
+}
@@ -0,0 +1,99 @@
+#ifndef IK_BATCH_SOLVER_H_INCLUDED
+#define IK_BATCH_SOLVER_H_INCLUDED
+
+#include <vector>
+#include <Transform.h>
+
+// Solves many IK chains of the same length at once (e.g. the legs of every
+// character in a crowd). World space joint positions are stored as a
+// structure of arrays, indexed [joint * numChains + chain], so each step of
+// FABRIK/CCD is a loop over contiguous floats for all chains ("lanes") that
+// the compiler can vectorize; it does with the Makefile's OPTFLAGS, the
+// default debug build runs them one lane at a time. Chains that reached
+// their goal are masked out of further iterations.
+class IKBatchSolver
+{
+public:
+
+    IKBatchSolver();
+
+    void Resize(unsigned int newNumChains, unsigned int newChainLength);
+    inline unsigned int GetNumChains() const  { return numChains;   }
+    inline unsigned int GetChainLength() const { return chainLength; }
+
+    // same convention as FABRIKSolver: joint 0 is in world (or model) space,
+    // the remaining joints are relative to the previous joint
+    void SetChain(unsigned int chain, const std::vector<Transform>& local);
+    // writes the solved local transforms of the chain
+    void GetChain(unsigned int chain, std::vector<Transform>& outLocal) const;
+    Vec3 GetWorldPosition(unsigned int chain, unsigned int joint) const;
+
+    void SetGoal(unsigned int chain, const Vec3& goal);
+
+    inline unsigned int GetNumSteps() const { return numSteps; }
+    inline void SetNumSteps(unsigned int newNumSteps) { numSteps = newNumSteps; }
+
+    inline float GetThreshold() const { return threshold; }
+    inline void SetThreshold(float newThreshold) { threshold = newThreshold; }
+
+    // when enabled, each chain starts iterating from its solution of the
+    // previous solve (moved along with its base) instead of the input pose
+    inline bool GetWarmStart() const { return warmStart; }
+    inline void SetWarmStart(bool enable) { warmStart = enable; }
+
+    // both return the number of chains within threshold of their goal
+    unsigned int SolveFABRIK();
+    unsigned int SolveCCD();
+
+    inline bool HasConverged(unsigned int chain) const { return converged[chain] != 0; }
+    // iterations run by the last solve (the slowest lane)
+    inline unsigned int GetLastIterationCount() const { return lastIterations; }
+
+protected:
+
+    unsigned int numChains;
+    unsigned int chainLength;
+    unsigned int numSteps;
+    float threshold;
+    bool warmStart;
+    unsigned int lastIterations;
+
+    // input local chains, [chain * chainLength + joint]
+    std::vector<Transform> localChains;
+
+    // world positions and bone lengths, [joint * numChains + chain]
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> posZ;
+    std::vector<float> lengths;
+
+    // previous solution, same layout; used for warm starting
+    std::vector<float> prevX;
+    std::vector<float> prevY;
+    std::vector<float> prevZ;
+    std::vector<unsigned char> hasPrevious;
+
+    // per lane data, [chain]
+    std::vector<float> baseX;
+    std::vector<float> baseY;
+    std::vector<float> baseZ;
+    std::vector<float> goalX;
+    std::vector<float> goalY;
+    std::vector<float> goalZ;
+    std::vector<float> active;  // 1.0f while the lane iterates, else 0.0f
+    std::vector<unsigned char> converged;
+    // the CCD rotation of each lane about the current joint
+    std::vector<float> rotX;
+    std::vector<float> rotY;
+    std::vector<float> rotZ;
+    std::vector<float> rotW;
+
+    void ChainsToWorld();
+    void StorePrevious();
+    unsigned int UpdateActiveLanes();
+    void IterateBackward();
+    void IterateForward();
+    void RotateAboutJoint(unsigned int joint);
+};
+
+#endif // IK_BATCH_SOLVER_H_INCLUDED
@@ -6,13 +6,9 @@ IKLeg::IKLeg(Skeleton& skeleton,
              const std::string& ankle, 
              const std::string& toe)
 {
-    lineVisuals = new DebugDraw();
-    pointVisuals = new DebugDraw();
-
     solver.Resize(3);
-    pointVisuals->Resize(3);
-    lineVisuals->Resize(4);
-
+    // nearly straight legs take FABRIK more than the default 15 steps
+    solver.SetNumSteps(30);
     ankleToGroundOffset = 0.0f;
 
     hipIndex = kneeIndex = ankleIndex = toeIndex = 0;
@@ -34,23 +30,13 @@ IKLeg::IKLeg(Skeleton& skeleton,
 IKLeg::IKLeg()
 {
     ankleToGroundOffset = 0.0f;
-    lineVisuals = new DebugDraw();
-    pointVisuals = new DebugDraw();
-
     solver.Resize(3);
-    pointVisuals->Resize(3);
-    lineVisuals->Resize(4);
 }
 
 IKLeg::IKLeg(const IKLeg& other)
 {
-    lineVisuals = new DebugDraw();
-    pointVisuals = new DebugDraw();
-
     ankleToGroundOffset = 0.0f;
     solver.Resize(3);
-    pointVisuals->Resize(3);
-    lineVisuals->Resize(4);
 
     *this = other;
 }
@@ -73,11 +59,9 @@ IKLeg& IKLeg::operator=(const IKLeg& other)
 
 IKLeg::~IKLeg()
 {
-    delete pointVisuals;
-    delete lineVisuals;
 }
 
-void IKLeg::SolveForLeg(const Transform& model,
+bool IKLeg::SolveForLeg(const Transform& model,
                         Pose& pose, 
                         const Vec3& ankleTargetPosition)
 {
@@ -89,22 +73,17 @@ void IKLeg::SolveForLeg(const Transform& model,
     Transform target(ankleTargetPosition + Vec3(0,1,0) * ankleToGroundOffset, 
                      Quat(), 
                      Vec3(1, 1, 1));
-    solver.Solve(target);
+    bool solved = solver.Solve(target);
 
     Transform rootWorld = combine(model, pose.GetGlobalTransform(pose.GetParent(hipIndex)));
     IKPose.SetLocalTransform(hipIndex, combine(inverse(rootWorld), solver.GetLocalTransform(0)));
     IKPose.SetLocalTransform(kneeIndex, solver.GetLocalTransform(1));
     IKPose.SetLocalTransform(ankleIndex, solver.GetLocalTransform(2));
-
-    lineVisuals->LinesFromIKSolver(solver);
-    pointVisuals->PointsFromIKSolver(solver);
+    return solved;
 }
 
-void IKLeg::Draw(const Mat4& vp, const Vec3& legColor)
+void IKLeg::Draw(DebugRenderer& renderer, const Vec3& legColor)
 {
-    lineVisuals->UpdateOpenGLBuffers();
-    pointVisuals->UpdateOpenGLBuffers();
-    lineVisuals->Draw(DebugDrawMode::Lines, legColor, vp);
-    pointVisuals->Draw(DebugDrawMode::Points, legColor, vp);
+    renderer.GetBatch().FromIKSolver(solver, legColor);
 }
 
@@ -3,7 +3,7 @@
 
 #include <CCDSolver.h>
 #include <FABRIKSolver.h>
-#include <DebugDraw.h>
+#include <DebugRenderer.h>
 #include <Skeleton.h>
 #include <Track.h>
 
@@ -21,14 +21,16 @@ public:
     IKLeg& operator=(const IKLeg&);
     ~IKLeg();
 
-    void SolveForLeg(const Transform& model, 
+    // true if the ankle reached the target
+    bool SolveForLeg(const Transform& model, 
                      Pose& pose, 
                      const Vec3& ankleTargetPosition);
 
     Pose& GetAdjustedPose() { return IKPose; }
     ScalarTrack& GetTrack() { return pinTrack; }
 
-    void Draw(const Mat4& vp, const Vec3& legColor);
+    // queues the solved chain; drawn by the renderer's next Flush
+    void Draw(DebugRenderer& renderer, const Vec3& legColor);
 
     unsigned int Hip()   { return hipIndex;   }
     unsigned int Knee()  { return kneeIndex;  }
@@ -39,6 +41,11 @@ public:
         ankleToGroundOffset = offset;
     }
 
+    // keeps the knee from bending backwards; axis is in the knee's local space
+    inline void SetKneeConstraint(const Vec3& axis, float minDegrees, float maxDegrees) {
+        solver.SetHingeConstraint(1, axis, minDegrees, maxDegrees);
+    }
+
 private:
 
     ScalarTrack pinTrack;
@@ -50,9 +57,6 @@ private:
     unsigned int ankleIndex;
     unsigned int toeIndex;
     
-    DebugDraw* lineVisuals;
-    DebugDraw* pointVisuals;
-    
     float ankleToGroundOffset;
 };
 
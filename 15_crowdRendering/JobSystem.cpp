@@ -0,0 +1,332 @@
+#include <JobSystem.h>
+#include <chrono>
+#include <cstring>
+
+struct JobSystem::Job
+{
+    Task work;
+    const char* name;
+    // one for the missing Submit plus one per unfinished dependency;
+    // the job is queued when this drops to zero
+    std::atomic<int> unfinished;
+    std::atomic<bool> done;
+    // jobs that depend on this one
+    std::vector<Job*> continuations;
+    float ms;
+};
+
+// which thread of which system the calling thread is; outside threads
+// use queue 0
+static thread_local const JobSystem* tlsSystem = nullptr;
+static thread_local unsigned int tlsThread = 0;
+
+static float MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count();
+}
+
+JobSystem::JobSystem(unsigned int numWorkers) :
+    numUsedJobs(0),
+    numQueued(0),
+    numUnfinished(0),
+    numSleeping(0),
+    quit(false)
+{
+    if (numWorkers == 0) {
+        unsigned int numCores = std::thread::hardware_concurrency();
+        numWorkers = (numCores > 1) ? numCores - 1 : 1;
+    }
+    queues.resize(numWorkers + 1);
+    for (unsigned int i = 0; i < numWorkers + 1; ++i) {
+        queues[i] = new WorkQueue();
+    }
+    ResetStats();
+
+    workers.reserve(numWorkers);
+    for (unsigned int i = 0; i < numWorkers; ++i) {
+        workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i + 1));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    WaitAll();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quit = true;
+    }
+    wakeSignal.notify_all();
+    for (unsigned int i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    for (unsigned int i = 0; i < queues.size(); ++i) {
+        delete queues[i];
+    }
+    for (unsigned int i = 0; i < jobs.size(); ++i) {
+        delete jobs[i];
+    }
+}
+
+JobSystem::Job* JobSystem::Create(const char* name, const Task& work)
+{
+    Job* job = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        if (numUsedJobs == jobs.size()) {
+            jobs.push_back(new Job());
+        }
+        job = jobs[numUsedJobs++];
+    }
+    job->work = work;
+    job->name = name;
+    job->unfinished.store(1);
+    job->done.store(false);
+    job->continuations.clear();
+    job->ms = 0.0f;
+    return job;
+}
+
+void JobSystem::AddDependency(Job* before, Job* after)
+{
+    after->unfinished.fetch_add(1);
+    before->continuations.push_back(after);
+}
+
+void JobSystem::Submit(Job* job)
+{
+    numUnfinished.fetch_add(1);
+    if (job->unfinished.fetch_sub(1) == 1) {
+        Enqueue(job);
+    }
+}
+
+JobSystem::Job* JobSystem::Submit(const char* name, const Task& work)
+{
+    Job* job = Create(name, work);
+    Submit(job);
+    return job;
+}
+
+void JobSystem::Wait(Job* job)
+{
+    unsigned int thread = GetThreadIndex();
+    while (!job->done.load(std::memory_order_acquire)) {
+        if (!RunOne(thread)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WaitAll()
+{
+    unsigned int thread = GetThreadIndex();
+    while (numUnfinished.load() > 0) {
+        if (!RunOne(thread)) {
+            std::this_thread::yield();
+        }
+    }
+    GatherTimings();
+
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    numUsedJobs = 0;
+}
+
+void JobSystem::ParallelFor(const char* name, unsigned int count, unsigned int batchSize, const RangeTask& work)
+{
+    if (count == 0) {
+        return;
+    }
+    if (batchSize == 0) {
+        unsigned int numBatches = GetNumThreads() * 4;
+        batchSize = (count + numBatches - 1) / numBatches;
+    }
+    if (batchSize >= count) {
+        work(0, count);
+        return;
+    }
+
+    // an empty job that depends on every batch; its name is left out
+    // of the timings
+    Job* done = Create(nullptr, Task());
+    for (unsigned int begin = 0; begin < count; begin += batchSize) {
+        unsigned int end = (begin + batchSize < count) ? begin + batchSize : count;
+        Job* batch = Create(name, [&work, begin, end]() {
+            work(begin, end);
+        });
+        AddDependency(batch, done);
+        Submit(batch);
+    }
+    Submit(done);
+    Wait(done);
+}
+
+float JobSystem::GetMilliseconds(const Job* job) const
+{
+    return job->ms;
+}
+
+JobThreadStats JobSystem::GetThreadStats(unsigned int thread) const
+{
+    return queues[thread]->stats;
+}
+
+void JobSystem::ResetStats()
+{
+    timings.clear();
+    for (unsigned int i = 0; i < queues.size(); ++i) {
+        queues[i]->stats.numJobs = 0;
+        queues[i]->stats.numStolen = 0;
+        queues[i]->stats.busyMs = 0.0f;
+    }
+}
+
+unsigned int JobSystem::GetThreadIndex() const
+{
+    return (tlsSystem == this) ? tlsThread : 0;
+}
+
+void JobSystem::Enqueue(Job* job)
+{
+    WorkQueue* queue = queues[GetThreadIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->jobs.push_back(job);
+    }
+    numQueued.fetch_add(1);
+    // a worker counts itself as sleeping before it checks numQueued, so
+    // one of the two always sees the other
+    if (numSleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeSignal.notify_one();
+    }
+}
+
+JobSystem::Job* JobSystem::Dequeue(unsigned int thread)
+{
+    // newest first from our own deque
+    WorkQueue* own = queues[thread];
+    {
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->jobs.empty()) {
+            Job* job = own->jobs.back();
+            own->jobs.pop_back();
+            numQueued.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // oldest first from everyone else's
+    unsigned int numQueues = (unsigned int)queues.size();
+    for (unsigned int i = 1; i < numQueues; ++i) {
+        WorkQueue* victim = queues[(thread + i) % numQueues];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->jobs.empty()) {
+            Job* job = victim->jobs.front();
+            victim->jobs.pop_front();
+            numQueued.fetch_sub(1);
+            ++own->stats.numStolen;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::RunOne(unsigned int thread)
+{
+    Job* job = Dequeue(thread);
+    if (job == nullptr) {
+        return false;
+    }
+    Execute(job, thread);
+    return true;
+}
+
+void JobSystem::Execute(Job* job, unsigned int thread)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    if (job->work) {
+        job->work();
+    }
+    job->ms = MillisecondsSince(start);
+
+    JobThreadStats& stats = queues[thread]->stats;
+    ++stats.numJobs;
+    stats.busyMs += job->ms;
+
+    // continuations go on this thread's deque, next to their inputs
+    for (unsigned int i = 0, size = (unsigned int)job->continuations.size(); i < size; ++i) {
+        Job* next = job->continuations[i];
+        if (next->unfinished.fetch_sub(1) == 1) {
+            Enqueue(next);
+        }
+    }
+    job->done.store(true, std::memory_order_release);
+    numUnfinished.fetch_sub(1);
+}
+
+void JobSystem::GatherTimings()
+{
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    for (unsigned int i = 0; i < numUsedJobs; ++i) {
+        const Job* job = jobs[i];
+        if (job->name == nullptr) {
+            continue;
+        }
+        JobTiming* timing = nullptr;
+        for (unsigned int t = 0, size = (unsigned int)timings.size(); t < size; ++t) {
+            if (timings[t].name == job->name || strcmp(timings[t].name, job->name) == 0) {
+                timing = &timings[t];
+                break;
+            }
+        }
+        if (timing == nullptr) {
+            JobTiming empty = { job->name, 0, 0.0f, 0.0f };
+            timings.push_back(empty);
+            timing = &timings.back();
+        }
+        ++timing->count;
+        timing->totalMs += job->ms;
+        if (job->ms > timing->maxMs) {
+            timing->maxMs = job->ms;
+        }
+    }
+}
+
+void JobSystem::WorkerLoop(unsigned int thread)
+{
+    tlsSystem = this;
+    tlsThread = thread;
+    while (true)
+    {
+        if (RunOne(thread)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        numSleeping.fetch_add(1);
+        while (!quit && numQueued.load() <= 0) {
+            wakeSignal.wait(lock);
+        }
+        numSleeping.fetch_sub(1);
+        if (quit) {
+            return;
+        }
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const JobTiming& timing)
+{
+    float average = (timing.count > 0) ? timing.totalMs / (float)timing.count : 0.0f;
+    os << timing.name << ": " << timing.count << " jobs, "
+       << timing.totalMs << " ms total, " << average << " ms average, "
+       << timing.maxMs << " ms max";
+    return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const JobThreadStats& stats)
+{
+    os << stats.numJobs << " jobs (" << stats.numStolen << " stolen), "
+       << "busy " << stats.busyMs << " ms";
+    return os;
+}
@@ -0,0 +1,135 @@
+#ifndef JOB_SYSTEM_H_INCLUDED
+#define JOB_SYSTEM_H_INCLUDED
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <ostream>
+
+// time spent in every job of one name since the last ResetStats
+struct JobTiming
+{
+    const char* name;
+    unsigned int count;
+    float totalMs;
+    float maxMs;
+};
+
+// what one thread did since the last ResetStats; thread 0 is the thread
+// that submits and waits (normally the main thread), the rest are workers
+struct JobThreadStats
+{
+    unsigned int numJobs;
+    unsigned int numStolen; // taken from another thread's queue
+    float busyMs;
+};
+
+std::ostream& operator<<(std::ostream& os, const JobTiming& timing);
+std::ostream& operator<<(std::ostream& os, const JobThreadStats& stats);
+
+// Runs short CPU jobs (animation sampling, blending, IK, skinning) on
+// worker threads. Every thread has its own deque: jobs a thread queues go
+// on the back of its deque and it pops from the back, so dependent work
+// stays on the core whose cache holds its inputs; a thread with nothing
+// to do steals from the front of another thread's deque. A job can wait
+// for other jobs to finish before it runs, which lets a chain of stages
+// run as soon as its inputs are ready instead of per stage for everyone.
+// Waiting threads run queued jobs instead of blocking.
+//
+// Jobs are created, linked and submitted by one outside thread (and by
+// jobs themselves), and stay valid until WaitAll, which recycles them.
+class JobSystem
+{
+public:
+
+    typedef std::function<void()> Task;
+    // runs items [begin, end)
+    typedef std::function<void(unsigned int begin, unsigned int end)> RangeTask;
+
+    struct Job;
+
+    // 0 workers picks one less than the number of cores (at least one);
+    // the thread that waits is the extra one
+    JobSystem(unsigned int numWorkers = 0);
+    // finishes all submitted work
+    ~JobSystem();
+
+    // name is used for timings and has to outlive the system, normally a
+    // string literal; the job doesn't run until it's submitted
+    Job* Create(const char* name, const Task& work);
+    // after doesn't start until before has finished; neither can have
+    // been submitted yet
+    void AddDependency(Job* before, Job* after);
+    // queues the job on the calling thread once its dependencies finished
+    void Submit(Job* job);
+    Job* Submit(const char* name, const Task& work);
+
+    // runs other jobs on the calling thread until job has finished
+    void Wait(Job* job);
+    // waits for every submitted job and recycles them all; only the
+    // outside thread can call this, no job pointer stays valid
+    void WaitAll();
+
+    // splits [0, count) into batches of batchSize (0 picks about four
+    // batches per thread) and returns once all of them have run; the
+    // batches are jobs too, recycled by the next WaitAll
+    void ParallelFor(const char* name, unsigned int count, unsigned int batchSize, const RangeTask& work);
+
+    // valid until WaitAll
+    float GetMilliseconds(const Job* job) const;
+
+    // thread count including the waiting thread
+    inline unsigned int GetNumThreads() const { return (unsigned int)queues.size(); }
+    inline unsigned int GetNumWorkers() const { return (unsigned int)workers.size(); }
+
+    // gathered by WaitAll; read them before submitting more work
+    inline const std::vector<JobTiming>& GetTimings() const { return timings; }
+    JobThreadStats GetThreadStats(unsigned int thread) const;
+    void ResetStats();
+
+protected:
+
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<Job*> jobs;
+        JobThreadStats stats;
+    };
+
+    std::vector<std::thread> workers;
+    // queues[0] belongs to the outside thread, queues[i + 1] to workers[i]
+    std::vector<WorkQueue*> queues;
+
+    // every job created since the last WaitAll is in jobs[0, numUsedJobs);
+    // the rest are recycled ones waiting to be created again
+    std::vector<Job*> jobs;
+    unsigned int numUsedJobs;
+    std::mutex jobsMutex;
+
+    std::atomic<int> numQueued;
+    std::atomic<int> numUnfinished;
+    std::atomic<int> numSleeping;
+    bool quit;
+    std::mutex sleepMutex;
+    std::condition_variable wakeSignal;
+
+    std::vector<JobTiming> timings;
+
+    unsigned int GetThreadIndex() const;
+    void Enqueue(Job* job);
+    Job* Dequeue(unsigned int thread);
+    bool RunOne(unsigned int thread);
+    void Execute(Job* job, unsigned int thread);
+    void GatherTimings();
+    void WorkerLoop(unsigned int thread);
+
+private:
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+};
+
+#endif // JOB_SYSTEM_H_INCLUDED
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_H_INCLUDED
+#define MAPPED_FILE_H_INCLUDED
+
+// A read only view of a whole file, mapped into memory rather than read,
+// so pages are only brought in as they are touched and nothing is copied.
+class MappedFile
+{
+public:
+
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(const char* path);
+    void Close();
+
+    inline bool IsOpen() const { return data != nullptr; }
+    inline const unsigned char* GetData() const { return data; }
+    inline unsigned long long GetSize() const { return size; }
+
+private:
+
+    const unsigned char* data;
+    unsigned long long size;
+#ifdef _WIN32
+    void* file;    // HANDLE
+    void* mapping; // HANDLE
+#endif
+
+    // disallow copy
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+};
+
+#endif // MAPPED_FILE_H_INCLUDED
@@ -1,13 +1,23 @@
 #include "Mesh.h"
+#include <Shader.h>
+#include <iostream>
 
+// GL objects are created on the first upload so meshes can be filled in
+// on threads without a GL context
 Mesh::Mesh()
 {
-    posAttrib = new Attribute<Vec3>();
-    normAttrib = new Attribute<Vec3>();
-    uvAttrib = new Attribute<Vec2>();
-    weightAttrib = new Attribute<Vec4>();
-    influenceAttrib = new Attribute<iVec4>();
-    indexBuffer = new IndexBuffer();
+    posAttrib = nullptr;
+    normAttrib = nullptr;
+    uvAttrib = nullptr;
+    weightAttrib = nullptr;
+    influenceAttrib = nullptr;
+    indexBuffer = nullptr;
+    skinnedPosAttrib = nullptr;
+    skinnedNormAttrib = nullptr;
+    packedAttrib = nullptr;
+    vertexFormat = VertexFormat::Separate;
+    vertexArray = 0;
+    vertexArrayDirty = true;
 }
 
 Mesh::~Mesh()
@@ -18,16 +28,28 @@ Mesh::~Mesh()
     delete weightAttrib;
     delete influenceAttrib;
     delete indexBuffer;
+    delete skinnedPosAttrib;
+    delete skinnedNormAttrib;
+    delete packedAttrib;
+    if (vertexArray != 0) {
+        glDeleteVertexArrays(1, &vertexArray);
+    }
 }
 
 Mesh::Mesh(const Mesh& other)
 {
-    posAttrib = new Attribute<Vec3>();
-    normAttrib = new Attribute<Vec3>();
-    uvAttrib = new Attribute<Vec2>();
-    weightAttrib = new Attribute<Vec4>();
-    influenceAttrib = new Attribute<iVec4>();
-    indexBuffer = new IndexBuffer();
+    posAttrib = nullptr;
+    normAttrib = nullptr;
+    uvAttrib = nullptr;
+    weightAttrib = nullptr;
+    influenceAttrib = nullptr;
+    indexBuffer = nullptr;
+    skinnedPosAttrib = nullptr;
+    skinnedNormAttrib = nullptr;
+    packedAttrib = nullptr;
+    vertexFormat = VertexFormat::Separate;
+    vertexArray = 0;
+    vertexArrayDirty = true;
     *this = other;
 }
 
@@ -43,12 +65,33 @@ Mesh& Mesh::operator=(const Mesh& other)
     weights = other.weights;
     influences = other.influences;
     indices = other.indices;
-    UpdateOpenGLBuffers();
+    packedVertices = other.packedVertices;
+    vertexFormat = other.vertexFormat;
+    // only touch GL if one of the meshes is already on the GPU
+    if (HasOpenGLBuffers() || other.HasOpenGLBuffers()) {
+        UpdateOpenGLBuffers();
+    }
     return *this;
 }
 
+void Mesh::CreateOpenGLBuffers()
+{
+    if (HasOpenGLBuffers()) {
+        return;
+    }
+    posAttrib = new Attribute<Vec3>();
+    normAttrib = new Attribute<Vec3>();
+    uvAttrib = new Attribute<Vec2>();
+    weightAttrib = new Attribute<Vec4>();
+    influenceAttrib = new Attribute<iVec4>();
+    indexBuffer = new IndexBuffer();
+    packedAttrib = new Attribute<PackedVertex>();
+}
+
 void Mesh::UpdateOpenGLBuffers()
 {
+    CreateOpenGLBuffers();
+    vertexArrayDirty = true;
     if (positions.size() > 0) {
         posAttrib->Set(positions);
     }
@@ -64,18 +107,83 @@ void Mesh::UpdateOpenGLBuffers()
     if (influences.size() > 0) {
         influenceAttrib->Set(influences);
     }
+    if (packedVertices.size() > 0) {
+        packedAttrib->Set(packedVertices);
+    }
     if (indices.size() > 0) {
         indexBuffer->Set(indices);
     }
 }
 
+void Mesh::SetVertexFormat(VertexFormat format)
+{
+    if (format == vertexFormat) {
+        return;
+    }
+
+    unsigned int numVerts = GetVertexCount();
+    if (format == VertexFormat::Packed) {
+        packedVertices.resize(numVerts);
+        for (unsigned int i = 0; i < numVerts; ++i) {
+            Vec3 normal = (i < normals.size()) ? normals[i] : Vec3(0, 1, 0);
+            Vec2 texCoord = (i < texCoords.size()) ? texCoords[i] : Vec2();
+            Vec4 weight = (i < weights.size()) ? weights[i] : Vec4(1, 0, 0, 0);
+            iVec4 joint = (i < influences.size()) ? influences[i] : iVec4();
+            packedVertices[i] = PackVertex(positions[i], normal, texCoord, weight, joint);
+        }
+        // the packed copy replaces the float data
+        std::vector<Vec3>().swap(positions);
+        std::vector<Vec3>().swap(normals);
+        std::vector<Vec2>().swap(texCoords);
+        std::vector<Vec4>().swap(weights);
+        std::vector<iVec4>().swap(influences);
+    } else {
+        positions.resize(numVerts);
+        normals.resize(numVerts);
+        texCoords.resize(numVerts);
+        weights.resize(numVerts);
+        influences.resize(numVerts);
+        for (unsigned int i = 0; i < numVerts; ++i) {
+            const PackedVertex& v = packedVertices[i];
+            positions[i] = UnpackPosition(v);
+            normals[i] = UnpackNormal(v);
+            texCoords[i] = UnpackTexCoord(v);
+            weights[i] = UnpackWeights(v);
+            influences[i] = UnpackJoints(v);
+        }
+        std::vector<PackedVertex>().swap(packedVertices);
+    }
+    vertexFormat = format;
+
+    if (HasOpenGLBuffers()) {
+        UpdateOpenGLBuffers();
+    }
+}
+
 void Mesh::Bind(int position, int normal, int texCoord, int weight, int influence)
 {
+    if (!HasOpenGLBuffers()) {
+        std::cout << __func__ << ": mesh was never uploaded" << std::endl;
+        return;
+    }
+    // CPU skinned meshes draw from the streamed positions and normals
     if (position >= 0) {
-        posAttrib->BindTo(position);
+        if (skinnedPosAttrib != nullptr) {
+            skinnedPosAttrib->BindTo(position);
+        } else if (vertexFormat == VertexFormat::Separate) {
+            posAttrib->BindTo(position);
+        }
     }
     if (normal >= 0) {
-        normAttrib->BindTo(normal);
+        if (skinnedNormAttrib != nullptr) {
+            skinnedNormAttrib->BindTo(normal);
+        } else if (vertexFormat == VertexFormat::Separate) {
+            normAttrib->BindTo(normal);
+        }
+    }
+    if (vertexFormat == VertexFormat::Packed) {
+        BindPacked(position, normal, texCoord, weight, influence);
+        return;
     }
     if (texCoord >= 0) {
         uvAttrib->BindTo(texCoord);
@@ -88,31 +196,79 @@ void Mesh::Bind(int position, int normal, int texCoord, int weight, int influenc
     }
 }
 
+void Mesh::BindPacked(int position, int normal, int texCoord, int weight, int influence)
+{
+    // positions and normals were bound above if the mesh is CPU skinned
+    if (position >= 0 && skinnedPosAttrib == nullptr) {
+        packedAttrib->BindTo(position, GetPackedVertexFormat(PackedVertexAttrib::Position));
+    }
+    if (normal >= 0 && skinnedNormAttrib == nullptr) {
+        packedAttrib->BindTo(normal, GetPackedVertexFormat(PackedVertexAttrib::Normal));
+    }
+    if (texCoord >= 0) {
+        packedAttrib->BindTo(texCoord, GetPackedVertexFormat(PackedVertexAttrib::TexCoord));
+    }
+    if (weight >= 0) {
+        packedAttrib->BindTo(weight, GetPackedVertexFormat(PackedVertexAttrib::Weights));
+    }
+    if (influence >= 0) {
+        packedAttrib->BindTo(influence, GetPackedVertexFormat(PackedVertexAttrib::Joints));
+    }
+}
+
 void Mesh::Draw()
 {
+    if (!HasOpenGLBuffers()) {
+        return;
+    }
     if (indices.size() > 0) {
         ::Draw(*indexBuffer, DrawMode::Triangles);
     } else {
-        ::Draw(positions.size(), DrawMode::Triangles);
+        ::Draw(GetVertexCount(), DrawMode::Triangles);
     }
 }
 
 void Mesh::DrawInstanced(unsigned int numInstances)
 {
+    if (!HasOpenGLBuffers()) {
+        return;
+    }
     if (indices.size() > 0) {
         ::DrawInstanced(*indexBuffer, DrawMode::Triangles, numInstances);
     } else {
-        ::DrawInstanced(positions.size(), DrawMode::Triangles, numInstances);
+        ::DrawInstanced(GetVertexCount(), DrawMode::Triangles, numInstances);
     }
 }
 
 void Mesh::Unbind(int position, int normal, int texCoord, int weight, int influence)
 {
+    if (!HasOpenGLBuffers()) {
+        return;
+    }
     if (position >= 0) {
-        posAttrib->UnbindFrom(position);
+        if (skinnedPosAttrib != nullptr) {
+            skinnedPosAttrib->UnbindFrom(position);
+        } else if (vertexFormat == VertexFormat::Packed) {
+            packedAttrib->UnbindFrom(position);
+        } else {
+            posAttrib->UnbindFrom(position);
+        }
     }
     if (normal >= 0) {
-        normAttrib->UnbindFrom(normal);
+        if (skinnedNormAttrib != nullptr) {
+            skinnedNormAttrib->UnbindFrom(normal);
+        } else if (vertexFormat == VertexFormat::Packed) {
+            packedAttrib->UnbindFrom(normal);
+        } else {
+            normAttrib->UnbindFrom(normal);
+        }
+    }
+    if (vertexFormat == VertexFormat::Packed) {
+        // all the same buffer
+        if (texCoord >= 0)  { packedAttrib->UnbindFrom(texCoord);  }
+        if (weight >= 0)    { packedAttrib->UnbindFrom(weight);    }
+        if (influence >= 0) { packedAttrib->UnbindFrom(influence); }
+        return;
     }
     if (texCoord >= 0) {
         uvAttrib->UnbindFrom(texCoord);
@@ -125,6 +281,47 @@ void Mesh::Unbind(int position, int normal, int texCoord, int weight, int influe
     }
 }
 
+void Mesh::BindVertexArray()
+{
+    if (!HasOpenGLBuffers()) {
+        std::cout << __func__ << ": mesh was never uploaded" << std::endl;
+        return;
+    }
+    if (vertexArray == 0) {
+        glGenVertexArrays(1, &vertexArray);
+    }
+    glBindVertexArray(vertexArray);
+    if (vertexArrayDirty) {
+        Bind(SHADER_ATTRIB_POSITION, SHADER_ATTRIB_NORMAL, SHADER_ATTRIB_TEXCOORD,
+             SHADER_ATTRIB_WEIGHTS, SHADER_ATTRIB_JOINTS);
+        // the element array binding is part of the vertex array state
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                     indices.size() > 0 ? indexBuffer->GetHandle() : 0);
+        vertexArrayDirty = false;
+    } else if (skinnedPosAttrib != nullptr) {
+        // streamed attributes move to a new ring segment every frame
+        skinnedPosAttrib->BindTo(SHADER_ATTRIB_POSITION);
+        skinnedNormAttrib->BindTo(SHADER_ATTRIB_NORMAL);
+    }
+}
+
+void Mesh::DrawVertexArray(unsigned int numInstances)
+{
+    if (vertexArray == 0) {
+        return;
+    }
+    if (indices.size() > 0) {
+        ::DrawElementsInstanced(indexBuffer->GetCount(), DrawMode::Triangles, numInstances);
+    } else {
+        ::DrawInstanced(GetVertexCount(), DrawMode::Triangles, numInstances);
+    }
+}
+
+void Mesh::UnbindVertexArray()
+{
+    glBindVertexArray(0);
+}
+
 // implementation using Transform objects
 #if 0
 void Mesh::CPUSkin(Skeleton& skeleton, Pose& pose)
@@ -175,31 +372,39 @@ void Mesh::CPUSkin(Skeleton& skeleton, Pose& pose)
                             n3 * weight.w;
     }
     
+    CreateOpenGLBuffers();
     posAttrib->Set(skinnedPositions);
     normAttrib->Set(skinnedNormals);
 }
 #endif
 
-// implementation using matrices
+// implementation using 4x4 matrices
+#if 0
 // this way is more easier to convert to GPU shader code
 void Mesh::CPUSkin(Skeleton& skeleton, Pose& pose)
 {
-    unsigned int numVerts = positions.size();
+    unsigned int numVerts = GetVertexCount();
     if (numVerts == 0) { 
         // TODO error
         return;
     }
     
-    skinnedPositions.resize(numVerts);
-    skinnedNormals.resize(numVerts);
+    Vec3* skinnedPositions = nullptr;
+    Vec3* skinnedNormals = nullptr;
+    if (!MapSkinnedAttributes(numVerts, skinnedPositions, skinnedNormals)) {
+        return;
+    }
     
     // stores pose transform matrices in posePalette
+    std::vector<Mat4> posePalette;
     pose.GetMatrixPalette(posePalette);
     std::vector<Mat4> invPosePalette = skeleton.GetInvBindPose();
     
+    Vec3 position, normal;
+    Vec4 weight;
+    iVec4 joint;
     for (unsigned int i = 0; i < numVerts; ++i) {
-        iVec4& joint = influences[i];
-        Vec4& weight = weights[i];
+        GetSkinningInput(i, position, normal, weight, joint);
         
         // calculate the skin matrix
         // up to 4 different joint influences (not all necessarily used)
@@ -210,48 +415,157 @@ void Mesh::CPUSkin(Skeleton& skeleton, Pose& pose)
         Mat4 skin = m0 + m1 + m2 + m3;
         
         // combine transforms
-        skinnedPositions[i] = transformPoint(skin, positions[i]);
-        skinnedNormals[i] = transformVector(skin, normals[i]);
+        skinnedPositions[i] = transformPoint(skin, position);
+        skinnedNormals[i] = transformVector(skin, normal);
     }
     
-    posAttrib->Set(skinnedPositions);
-    normAttrib->Set(skinnedNormals);
+    skinnedPosAttrib->Unmap();
+    skinnedNormAttrib->Unmap();
+}
+#endif
+
+// implementation using affine matrices; the same math as the 4x4 version
+// without the bottom row, which is always (0, 0, 0, 1)
+void Mesh::CPUSkin(Skeleton& skeleton, Pose& pose)
+{
+    // pose * invBindPose once per joint instead of once per influence
+    pose.GetAffinePalette(posePalette);
+    skeleton.GetInvBindPose(invBindPalette);
+    for (unsigned int i = 0, size = (unsigned int)posePalette.size(); i < size; ++i) {
+        posePalette[i] = posePalette[i] * invBindPalette[i];
+    }
+    CPUSkin(posePalette);
 }
 
 // skinning computation using pre computed pos * invBindPose
 void Mesh::CPUSkin(std::vector<Mat4>& animatedPose)
 {
-    unsigned int numVerts = positions.size();
+    unsigned int numVerts = GetVertexCount();
     if (numVerts == 0) {
         return;
     }
     
-    skinnedPositions.resize(numVerts);
-    skinnedNormals.resize(numVerts);
+    Vec3* skinnedPositions = nullptr;
+    Vec3* skinnedNormals = nullptr;
+    if (!MapSkinnedAttributes(numVerts, skinnedPositions, skinnedNormals)) {
+        return;
+    }
     
+    Vec3 position, normal;
+    Vec4 weight;
+    iVec4 joint;
     for (unsigned int i = 0; i < numVerts; ++i) {
-        iVec4& joint = influences[i];
-        Vec4& weight = weights[i];
+        GetSkinningInput(i, position, normal, weight, joint);
         
         // calculate skinned positions and normals
-        Vec3 p0 = transformPoint(animatedPose[joint.x], positions[i]);
-        Vec3 p1 = transformPoint(animatedPose[joint.y], positions[i]);
-        Vec3 p2 = transformPoint(animatedPose[joint.z], positions[i]);
-        Vec3 p3 = transformPoint(animatedPose[joint.w], positions[i]);
+        Vec3 p0 = transformPoint(animatedPose[joint.x], position);
+        Vec3 p1 = transformPoint(animatedPose[joint.y], position);
+        Vec3 p2 = transformPoint(animatedPose[joint.z], position);
+        Vec3 p3 = transformPoint(animatedPose[joint.w], position);
         skinnedPositions[i] = p0 * weight.x + 
                               p1 * weight.y + 
                               p2 * weight.z + 
                               p3 * weight.w;
-        Vec3 n0 = transformPoint(animatedPose[joint.x], normals[i]);
-        Vec3 n1 = transformPoint(animatedPose[joint.y], normals[i]);
-        Vec3 n2 = transformPoint(animatedPose[joint.z], normals[i]);
-        Vec3 n3 = transformPoint(animatedPose[joint.w], normals[i]);
+        Vec3 n0 = transformPoint(animatedPose[joint.x], normal);
+        Vec3 n1 = transformPoint(animatedPose[joint.y], normal);
+        Vec3 n2 = transformPoint(animatedPose[joint.z], normal);
+        Vec3 n3 = transformPoint(animatedPose[joint.w], normal);
         skinnedNormals[i] = n0 * weight.x + 
                             n1 * weight.y + 
                             n2 * weight.z + 
                             n3 * weight.w;
     }
     
-    posAttrib->Set(skinnedPositions);
-    normAttrib->Set(skinnedNormals);
+    skinnedPosAttrib->Unmap();
+    skinnedNormAttrib->Unmap();
+}
+
+void Mesh::CPUSkin(std::vector<Affine3x4>& animatedPose)
+{
+    unsigned int numVerts = GetVertexCount();
+    if (numVerts == 0) {
+        return;
+    }
+
+    Vec3* skinnedPositions = nullptr;
+    Vec3* skinnedNormals = nullptr;
+    if (!MapSkinnedAttributes(numVerts, skinnedPositions, skinnedNormals)) {
+        return;
+    }
+
+    CPUSkin(animatedPose, skinnedPositions, skinnedNormals);
+
+    skinnedPosAttrib->Unmap();
+    skinnedNormAttrib->Unmap();
+}
+
+void Mesh::CPUSkin(const std::vector<Affine3x4>& animatedPose,
+                   Vec3* outPositions, Vec3* outNormals) const
+{
+    unsigned int numVerts = GetVertexCount();
+    Vec3 position, normal;
+    Vec4 weight;
+    iVec4 joint;
+    for (unsigned int i = 0; i < numVerts; ++i) {
+        GetSkinningInput(i, position, normal, weight, joint);
+
+        Affine3x4 skin = animatedPose[joint.x] * weight.x +
+                         animatedPose[joint.y] * weight.y +
+                         animatedPose[joint.z] * weight.z +
+                         animatedPose[joint.w] * weight.w;
+
+        outPositions[i] = transformPoint(skin, position);
+        outNormals[i] = transformVector(skin, normal);
+    }
+}
+
+bool Mesh::MapSkinnedAttributes(unsigned int numVerts, Vec3*& outPositions, Vec3*& outNormals)
+{
+    if (skinnedPosAttrib == nullptr) {
+        skinnedPosAttrib = new StreamAttribute<Vec3>();
+        skinnedNormAttrib = new StreamAttribute<Vec3>();
+        vertexArrayDirty = true;
+    }
+    outPositions = skinnedPosAttrib->Map(numVerts);
+    outNormals = skinnedNormAttrib->Map(numVerts);
+    if (outPositions == nullptr || outNormals == nullptr) {
+        skinnedPosAttrib->Unmap();
+        skinnedNormAttrib->Unmap();
+        return false;
+    }
+    return true;
+}
+
+unsigned long long Mesh::GetSkinnedBytesUploaded() const
+{
+    if (skinnedPosAttrib == nullptr) {
+        return 0;
+    }
+    return skinnedPosAttrib->GetBytesUploaded() + skinnedNormAttrib->GetBytesUploaded();
+}
+
+unsigned int Mesh::GetVertexCount() const
+{
+    if (vertexFormat == VertexFormat::Packed) {
+        return (unsigned int)packedVertices.size();
+    }
+    return (unsigned int)positions.size();
+}
+
+void Mesh::GetSkinningInput(unsigned int i, Vec3& outPosition, Vec3& outNormal,
+                            Vec4& outWeights, iVec4& outJoints) const
+{
+    if (vertexFormat == VertexFormat::Packed) {
+        // same decoding as the packed vertex shader
+        const PackedVertex& v = packedVertices[i];
+        outPosition = UnpackPosition(v);
+        outNormal = UnpackNormal(v);
+        outWeights = UnpackWeights(v);
+        outJoints = UnpackJoints(v);
+    } else {
+        outPosition = positions[i];
+        outNormal = normals[i];
+        outWeights = weights[i];
+        outJoints = influences[i];
+    }
 }
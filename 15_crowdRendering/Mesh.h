@@ -6,11 +6,20 @@
 #include <Vec3.h>
 #include <Vec4.h>
 #include <Mat4.h>
+#include <Affine3x4.h>
 #include <Attribute.h>
+#include <StreamAttribute.h>
+#include <PackedVertex.h>
 #include <Skeleton.h>
 #include <IndexBuffer.h>
 #include <Draw.h>
 
+enum class VertexFormat
+{
+    Separate, // one float attribute buffer per vertex component
+    Packed    // interleaved PackedVertex buffer
+};
+
 class Mesh
 {
 public:
@@ -25,21 +34,51 @@ public:
     inline std::vector<Vec4>& GetWeights()         { return weights;    }
     inline std::vector<iVec4>& GetInfluences()     { return influences; }
     inline std::vector<unsigned int>& GetIndices() { return indices;    }
+    inline std::vector<PackedVertex>& GetPackedVertices() { return packedVertices; }
+
+    // switching to Packed moves the vertex data into packed vertices and
+    // frees the separate arrays (their getters return empty vectors);
+    // switching back decodes them again
+    void SetVertexFormat(VertexFormat format);
+    inline VertexFormat GetVertexFormat() const { return vertexFormat; }
+    unsigned int GetVertexCount() const;
     
-    // applies CPU skinning
+    // applies CPU skinning; results are written straight into streamed
+    // vertex buffers which Bind uses from then on
     void CPUSkin(Skeleton& skeleton, Pose& pose);
     
     // CPU skinning with pre-computed pose * invBindMatrix palette
     void CPUSkin(std::vector<Mat4>& animatedPose);
+    void CPUSkin(std::vector<Affine3x4>& animatedPose);
+    // same, into arrays of GetVertexCount() entries; touches no GL state
+    // so it can run on any thread
+    void CPUSkin(const std::vector<Affine3x4>& animatedPose,
+                 Vec3* outPositions, Vec3* outNormals) const;
+
+    // bind pose position, normal and skin data of vertex i in either format
+    void GetSkinningInput(unsigned int i, Vec3& outPosition, Vec3& outNormal,
+                          Vec4& outWeights, iVec4& outJoints) const;
+
+    // bytes written by CPU skinning so far
+    unsigned long long GetSkinnedBytesUploaded() const;
     
-    // sends CPU side data changes to the GPU attributes
+    // sends CPU side data changes to the GPU attributes, creating them
+    // on first use; requires a GL context
     void UpdateOpenGLBuffers();
+    inline bool HasOpenGLBuffers() const { return posAttrib != nullptr; }
     // inputs are attribute locations
     void Bind(int position, int normal, int texCoord, int weight, int influence);
     void Draw();
     void DrawInstanced(unsigned int numInstances);
     void Unbind(int position, int normal, int texCoord, int weight, int influence);
 
+    // Binds a vertex array object with every attribute at the fixed
+    // SHADER_ATTRIB_* locations, built on first use, so drawing doesn't
+    // need Bind/Unbind. DrawVertexArray draws with it bound.
+    void BindVertexArray();
+    void DrawVertexArray(unsigned int numInstances);
+    static void UnbindVertexArray();
+
 protected:
     
     std::vector<Vec3> positions;
@@ -55,10 +94,22 @@ protected:
     Attribute<Vec4>* weightAttrib;
     Attribute<iVec4>* influenceAttrib;
     IndexBuffer* indexBuffer;
+
+    VertexFormat vertexFormat;
+    std::vector<PackedVertex> packedVertices;
+    Attribute<PackedVertex>* packedAttrib;
     
-    std::vector<Vec3> skinnedPositions;
-    std::vector<Vec3> skinnedNormals;
-    std::vector<Mat4> posePalette;
+    StreamAttribute<Vec3>* skinnedPosAttrib;
+    StreamAttribute<Vec3>* skinnedNormAttrib;
+    std::vector<Affine3x4> posePalette;
+    std::vector<Affine3x4> invBindPalette;
+
+    unsigned int vertexArray;
+    bool vertexArrayDirty; // buffers or layout changed since it was built
+
+    void CreateOpenGLBuffers();
+    bool MapSkinnedAttributes(unsigned int numVerts, Vec3*& outPositions, Vec3*& outNormals);
+    void BindPacked(int position, int normal, int texCoord, int weight, int influence);
 };
 
 #endif // MESH_H_INCLUDED
@@ -0,0 +1,343 @@
+#include <MeshOptimizer.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace MeshOptimizerHelpers
+{
+    // moves element i of v to remap[i]; several elements may land on the
+    // same slot when they are duplicates
+    template<typename T>
+    void RemapVector(std::vector<T>& v,
+                     const std::vector<unsigned int>& remap,
+                     unsigned int newCount) {
+        if (v.empty()) {
+            return;
+        }
+        std::vector<T> result(newCount);
+        for (unsigned int i = 0; i < remap.size(); ++i) {
+            result[remap[i]] = v[i];
+        }
+        v.swap(result);
+    }
+
+    void RemapMesh(Mesh& mesh,
+                   const std::vector<unsigned int>& remap,
+                   unsigned int newCount) {
+        RemapVector(mesh.GetPositions(), remap, newCount);
+        RemapVector(mesh.GetNormals(), remap, newCount);
+        RemapVector(mesh.GetTexCoords(), remap, newCount);
+        RemapVector(mesh.GetWeights(), remap, newCount);
+        RemapVector(mesh.GetInfluences(), remap, newCount);
+        RemapVector(mesh.GetPackedVertices(), remap, newCount);
+    }
+
+    template<typename T>
+    void AppendBytes(std::vector<unsigned char>& out,
+                     unsigned int stride,
+                     unsigned int& offset,
+                     const std::vector<T>& v) {
+        if (v.empty()) {
+            return;
+        }
+        for (unsigned int i = 0; i < v.size(); ++i) {
+            memcpy(&out[i * stride + offset], &v[i], sizeof(T));
+        }
+        offset += sizeof(T);
+    }
+
+    // every attribute of each vertex as one fixed size byte string
+    unsigned int GetVertexBytes(Mesh& mesh, std::vector<unsigned char>& out) {
+        unsigned int numVerts = mesh.GetVertexCount();
+        unsigned int stride = 0;
+        if (mesh.GetVertexFormat() == VertexFormat::Packed) {
+            stride = sizeof(PackedVertex);
+        } else {
+            stride += mesh.GetPositions().empty()  ? 0 : sizeof(Vec3);
+            stride += mesh.GetNormals().empty()    ? 0 : sizeof(Vec3);
+            stride += mesh.GetTexCoords().empty()  ? 0 : sizeof(Vec2);
+            stride += mesh.GetWeights().empty()    ? 0 : sizeof(Vec4);
+            stride += mesh.GetInfluences().empty() ? 0 : sizeof(iVec4);
+        }
+
+        out.assign(numVerts * stride, 0);
+        unsigned int offset = 0;
+        AppendBytes(out, stride, offset, mesh.GetPositions());
+        AppendBytes(out, stride, offset, mesh.GetNormals());
+        AppendBytes(out, stride, offset, mesh.GetTexCoords());
+        AppendBytes(out, stride, offset, mesh.GetWeights());
+        AppendBytes(out, stride, offset, mesh.GetInfluences());
+        AppendBytes(out, stride, offset, mesh.GetPackedVertices());
+        return stride;
+    }
+
+    // merges vertices whose attributes are bit for bit identical
+    unsigned int WeldVertices(Mesh& mesh) {
+        unsigned int numVerts = mesh.GetVertexCount();
+        std::vector<unsigned char> bytes;
+        unsigned int stride = GetVertexBytes(mesh, bytes);
+
+        // sort so duplicates are next to each other
+        std::vector<unsigned int> order(numVerts);
+        for (unsigned int i = 0; i < numVerts; ++i) {
+            order[i] = i;
+        }
+        const unsigned char* data = bytes.empty() ? nullptr : &bytes[0];
+        std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+            int cmp = memcmp(data + a * stride, data + b * stride, stride);
+            return (cmp < 0) || (cmp == 0 && a < b);
+        });
+
+        // the first copy of each vertex keeps its place in the original order
+        std::vector<unsigned int> firstCopy(numVerts);
+        for (unsigned int i = 0; i < numVerts; ++i) {
+            bool duplicate = (i > 0) &&
+                memcmp(data + order[i] * stride, data + order[i - 1] * stride, stride) == 0;
+            firstCopy[order[i]] = duplicate ? firstCopy[order[i - 1]] : order[i];
+        }
+        std::vector<unsigned int> remap(numVerts);
+        unsigned int newCount = 0;
+        for (unsigned int i = 0; i < numVerts; ++i) {
+            remap[i] = (firstCopy[i] == i) ? newCount++ : remap[firstCopy[i]];
+        }
+
+        std::vector<unsigned int>& indices = mesh.GetIndices();
+        for (unsigned int i = 0; i < indices.size(); ++i) {
+            indices[i] = remap[indices[i]];
+        }
+        RemapMesh(mesh, remap, newCount);
+        return newCount;
+    }
+
+    // Forsyth's scoring: recently used vertices and vertices with few
+    // triangles left score higher
+    float VertexScore(int cachePosition, unsigned int remainingTriangles) {
+        if (remainingTriangles == 0) {
+            return -1.0f;
+        }
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // the last triangle's vertices; fixed score so the next
+                // triangle isn't too strongly tied to it
+                score = 0.75f;
+            } else {
+                float scaler = 1.0f / (MESH_OPTIMIZER_CACHE_SIZE - 3);
+                score = 1.0f - (cachePosition - 3) * scaler;
+                score = powf(score, 1.5f);
+            }
+        }
+        score += 2.0f * powf((float)remainingTriangles, -0.5f);
+        return score;
+    }
+}
+
+float CalculateACMR(const std::vector<unsigned int>& indices,
+                    unsigned int numVertices,
+                    unsigned int cacheSize)
+{
+    unsigned int numTriangles = indices.size() / 3;
+    if (numTriangles == 0) {
+        return 0.0f;
+    }
+
+    // FIFO cache like the post transform cache of most GPUs
+    std::vector<unsigned int> insertedAt(numVertices, 0);
+    unsigned int misses = 0;
+    for (unsigned int i = 0; i < numTriangles * 3; ++i) {
+        unsigned int v = indices[i];
+        if (insertedAt[v] == 0 || misses + 1 - insertedAt[v] > cacheSize) {
+            ++misses;
+            insertedAt[v] = misses;
+        }
+    }
+    return (float)misses / (float)numTriangles;
+}
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices,
+                         unsigned int numVertices)
+{
+    using namespace MeshOptimizerHelpers;
+
+    unsigned int numTriangles = indices.size() / 3;
+    if (numTriangles == 0) {
+        return;
+    }
+
+    // triangles using each vertex
+    std::vector<unsigned int> triangleOffsets(numVertices + 1, 0);
+    for (unsigned int i = 0; i < numTriangles * 3; ++i) {
+        triangleOffsets[indices[i] + 1] += 1;
+    }
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        triangleOffsets[v + 1] += triangleOffsets[v];
+    }
+    std::vector<unsigned int> vertexTriangles(numTriangles * 3);
+    std::vector<unsigned int> remaining(numVertices, 0);
+    for (unsigned int i = 0; i < numTriangles * 3; ++i) {
+        unsigned int v = indices[i];
+        vertexTriangles[triangleOffsets[v] + remaining[v]++] = i / 3;
+    }
+
+    std::vector<int> cachePosition(numVertices, -1);
+    std::vector<float> vertexScore(numVertices);
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+    }
+    std::vector<float> triangleScore(numTriangles);
+    std::vector<bool> emitted(numTriangles, false);
+    for (unsigned int t = 0; t < numTriangles; ++t) {
+        triangleScore[t] = vertexScore[indices[t * 3 + 0]] +
+                           vertexScore[indices[t * 3 + 1]] +
+                           vertexScore[indices[t * 3 + 2]];
+    }
+
+    // simulated LRU cache, with room for the 3 vertices being added
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> newCache;
+    cache.reserve(MESH_OPTIMIZER_CACHE_SIZE + 3);
+    newCache.reserve(MESH_OPTIMIZER_CACHE_SIZE + 3);
+
+    std::vector<unsigned int> result;
+    result.reserve(numTriangles * 3);
+    unsigned int scanCursor = 0;
+    int best = -1;
+
+    for (unsigned int n = 0; n < numTriangles; ++n)
+    {
+        if (best < 0) {
+            // nothing in the cache has triangles left; take the best of
+            // the rest (linear in practice since the cursor only advances)
+            float bestScore = -1.0f;
+            while (scanCursor < numTriangles && emitted[scanCursor]) {
+                ++scanCursor;
+            }
+            for (unsigned int t = scanCursor; t < numTriangles; ++t) {
+                if (!emitted[t] && triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = (int)t;
+                }
+                // good enough, don't scan the whole mesh every time
+                if (best >= 0 && t - scanCursor > 64) {
+                    break;
+                }
+            }
+        }
+
+        unsigned int triangle = (unsigned int)best;
+        emitted[triangle] = true;
+        newCache.clear();
+        for (unsigned int k = 0; k < 3; ++k) {
+            unsigned int v = indices[triangle * 3 + k];
+            result.push_back(v);
+            newCache.push_back(v);
+
+            // remove the triangle from the vertex's list
+            unsigned int* tris = &vertexTriangles[triangleOffsets[v]];
+            for (unsigned int j = 0; j < remaining[v]; ++j) {
+                if (tris[j] == triangle) {
+                    tris[j] = tris[remaining[v] - 1];
+                    break;
+                }
+            }
+            --remaining[v];
+        }
+        for (unsigned int j = 0; j < cache.size(); ++j) {
+            unsigned int v = cache[j];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2]) {
+                newCache.push_back(v);
+            }
+        }
+        cache.swap(newCache);
+
+        // rescore everything in the cache, and the vertices pushed out
+        for (unsigned int j = 0; j < cache.size(); ++j) {
+            unsigned int v = cache[j];
+            cachePosition[v] = (j < MESH_OPTIMIZER_CACHE_SIZE) ? (int)j : -1;
+        }
+        best = -1;
+        float bestScore = -1.0f;
+        for (unsigned int j = 0; j < cache.size(); ++j) {
+            unsigned int v = cache[j];
+            float newScore = VertexScore(cachePosition[v], remaining[v]);
+            float delta = newScore - vertexScore[v];
+            vertexScore[v] = newScore;
+            const unsigned int* tris = &vertexTriangles[triangleOffsets[v]];
+            for (unsigned int k = 0; k < remaining[v]; ++k) {
+                unsigned int t = tris[k];
+                triangleScore[t] += delta;
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = (int)t;
+                }
+            }
+        }
+        if (cache.size() > MESH_OPTIMIZER_CACHE_SIZE) {
+            cache.resize(MESH_OPTIMIZER_CACHE_SIZE);
+        }
+    }
+
+    indices.swap(result);
+}
+
+std::vector<unsigned int> OptimizeVertexFetch(std::vector<unsigned int>& indices,
+                                              unsigned int numVertices)
+{
+    const unsigned int unused = (unsigned int)-1;
+    std::vector<unsigned int> remap(numVertices, unused);
+    unsigned int next = 0;
+    for (unsigned int i = 0; i < indices.size(); ++i) {
+        unsigned int& v = remap[indices[i]];
+        if (v == unused) {
+            v = next++;
+        }
+        indices[i] = v;
+    }
+    // vertices no triangle uses go to the end
+    for (unsigned int v = 0; v < numVertices; ++v) {
+        if (remap[v] == unused) {
+            remap[v] = next++;
+        }
+    }
+    return remap;
+}
+
+MeshOptimizerReport OptimizeMesh(Mesh& mesh)
+{
+    using namespace MeshOptimizerHelpers;
+
+    MeshOptimizerReport report;
+    std::vector<unsigned int>& indices = mesh.GetIndices();
+    unsigned int numVerts = mesh.GetVertexCount();
+    if (indices.empty()) {
+        indices.resize(numVerts);
+        for (unsigned int i = 0; i < numVerts; ++i) {
+            indices[i] = i;
+        }
+    }
+
+    report.verticesBefore = numVerts;
+    report.numTriangles = indices.size() / 3;
+    report.acmrBefore = CalculateACMR(indices, numVerts);
+    report.atvrBefore = (numVerts > 0) ? report.acmrBefore * report.numTriangles / numVerts : 0.0f;
+
+    numVerts = WeldVertices(mesh);
+    OptimizeVertexCache(indices, numVerts);
+    std::vector<unsigned int> remap = OptimizeVertexFetch(indices, numVerts);
+    RemapMesh(mesh, remap, numVerts);
+
+    report.verticesAfter = numVerts;
+    report.acmrAfter = CalculateACMR(indices, numVerts);
+    report.atvrAfter = (numVerts > 0) ? report.acmrAfter * report.numTriangles / numVerts : 0.0f;
+    return report;
+}
+
+std::ostream& operator<<(std::ostream& os, const MeshOptimizerReport& report)
+{
+    os << report.numTriangles << " triangles, "
+       << report.verticesBefore << " -> " << report.verticesAfter << " vertices, "
+       << "ACMR " << report.acmrBefore << " -> " << report.acmrAfter << ", "
+       << "ATVR " << report.atvrBefore << " -> " << report.atvrAfter;
+    return os;
+}
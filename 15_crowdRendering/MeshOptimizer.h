@@ -0,0 +1,41 @@
+#ifndef MESH_OPTIMIZER_H_INCLUDED
+#define MESH_OPTIMIZER_H_INCLUDED
+
+#include <vector>
+#include <Mesh.h>
+
+#define MESH_OPTIMIZER_CACHE_SIZE 32
+
+struct MeshOptimizerReport
+{
+    unsigned int verticesBefore;
+    unsigned int verticesAfter;   // after welding duplicates
+    unsigned int numTriangles;
+    float acmrBefore;             // average cache misses per triangle
+    float acmrAfter;
+    float atvrBefore;             // average transforms per vertex (1.0 is ideal)
+    float atvrAfter;
+};
+
+// Reorders a mesh so the GPU runs the (skinning) vertex shader as few
+// times as possible: duplicate vertices are welded, triangles are
+// reordered for the post transform cache (Forsyth's algorithm) and
+// vertices are reordered to the order the triangles first use them.
+// Works on CPU data only; upload afterwards. Non-indexed meshes get an
+// index buffer.
+MeshOptimizerReport OptimizeMesh(Mesh& mesh);
+
+// the individual steps, on raw index lists
+// simulated misses per triangle of a FIFO cache of the given size
+float CalculateACMR(const std::vector<unsigned int>& indices,
+                    unsigned int numVertices,
+                    unsigned int cacheSize = MESH_OPTIMIZER_CACHE_SIZE);
+void  OptimizeVertexCache(std::vector<unsigned int>& indices,
+                          unsigned int numVertices);
+// rewrites the indices and returns the new index of every old vertex
+std::vector<unsigned int> OptimizeVertexFetch(std::vector<unsigned int>& indices,
+                                              unsigned int numVertices);
+
+std::ostream& operator<<(std::ostream& os, const MeshOptimizerReport& report);
+
+#endif // MESH_OPTIMIZER_H_INCLUDED
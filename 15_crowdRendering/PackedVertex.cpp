@@ -0,0 +1,256 @@
+#include <PackedVertex.h>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+#include <iostream>
+
+AttributeFormat GetPackedVertexFormat(PackedVertexAttrib attrib)
+{
+    AttributeFormat format;
+    format.stride = sizeof(PackedVertex);
+    format.normalized = false;
+    format.integer = false;
+
+    switch (attrib)
+    {
+    case PackedVertexAttrib::Position:
+        format.size = 3;
+        format.type = GL_FLOAT;
+        format.offset = offsetof(PackedVertex, position);
+        break;
+    case PackedVertexAttrib::Normal:
+        // decoded to a vec3 by the shader
+        format.size = 2;
+        format.type = GL_SHORT;
+        format.normalized = true;
+        format.offset = offsetof(PackedVertex, normal);
+        break;
+    case PackedVertexAttrib::TexCoord:
+        format.size = 2;
+        format.type = GL_HALF_FLOAT;
+        format.offset = offsetof(PackedVertex, texCoord);
+        break;
+    case PackedVertexAttrib::Weights:
+        format.size = 4;
+        format.type = GL_UNSIGNED_BYTE;
+        format.normalized = true;
+        format.offset = offsetof(PackedVertex, weights);
+        break;
+    case PackedVertexAttrib::Joints:
+        format.size = 4;
+        format.type = GL_UNSIGNED_BYTE;
+        format.integer = true;
+        format.offset = offsetof(PackedVertex, joints);
+        break;
+    }
+
+    return format;
+}
+
+PackedVertex PackVertex(const Vec3& position,
+                        const Vec3& normal,
+                        const Vec2& texCoord,
+                        const Vec4& weights,
+                        const iVec4& joints)
+{
+    PackedVertex result;
+    result.position[0] = position.x;
+    result.position[1] = position.y;
+    result.position[2] = position.z;
+    OctEncode(normal, result.normal);
+    result.texCoord[0] = FloatToHalf(texCoord.x);
+    result.texCoord[1] = FloatToHalf(texCoord.y);
+    QuantizeWeights(weights, result.weights);
+    for (int i = 0; i < 4; ++i) {
+        int joint = joints.v[i];
+        if (joint < 0 || joint > 255) {
+            std::cout << __func__ << ": joint index " << joint
+                      << " doesn't fit in 8 bits" << std::endl;
+            joint = 0;
+        }
+        result.joints[i] = (unsigned char)joint;
+    }
+    return result;
+}
+
+Vec3 UnpackPosition(const PackedVertex& v)
+{
+    return Vec3(v.position[0], v.position[1], v.position[2]);
+}
+
+Vec3 UnpackNormal(const PackedVertex& v)
+{
+    return OctDecode(v.normal);
+}
+
+Vec2 UnpackTexCoord(const PackedVertex& v)
+{
+    return Vec2(HalfToFloat(v.texCoord[0]), HalfToFloat(v.texCoord[1]));
+}
+
+Vec4 UnpackWeights(const PackedVertex& v)
+{
+    return Vec4(v.weights[0] / 255.0f,
+                v.weights[1] / 255.0f,
+                v.weights[2] / 255.0f,
+                v.weights[3] / 255.0f);
+}
+
+iVec4 UnpackJoints(const PackedVertex& v)
+{
+    return iVec4(v.joints[0], v.joints[1], v.joints[2], v.joints[3]);
+}
+
+static inline float SignNotZero(float f)
+{
+    return (f >= 0.0f) ? 1.0f : -1.0f;
+}
+
+static inline short ToSnorm16(float f)
+{
+    if (f < -1.0f) { f = -1.0f; }
+    if (f >  1.0f) { f =  1.0f; }
+    return (short)floorf(f * 32767.0f + 0.5f);
+}
+
+static inline float FromSnorm16(short s)
+{
+    float f = s / 32767.0f;
+    return (f < -1.0f) ? -1.0f : f;
+}
+
+// project onto the octahedron |x|+|y|+|z| = 1 and fold the lower half
+// over the diagonals
+void OctEncode(const Vec3& normal, short out[2])
+{
+    float l1 = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    if (l1 < VEC3_EPSILON) {
+        out[0] = 0;
+        out[1] = 0;
+        return;
+    }
+    float x = normal.x / l1;
+    float y = normal.y / l1;
+    if (normal.z < 0.0f) {
+        float foldX = (1.0f - fabsf(y)) * SignNotZero(x);
+        float foldY = (1.0f - fabsf(x)) * SignNotZero(y);
+        x = foldX;
+        y = foldY;
+    }
+    out[0] = ToSnorm16(x);
+    out[1] = ToSnorm16(y);
+}
+
+Vec3 OctDecode(const short in[2])
+{
+    float x = FromSnorm16(in[0]);
+    float y = FromSnorm16(in[1]);
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    if (z < 0.0f) {
+        float unfoldX = (1.0f - fabsf(y)) * SignNotZero(x);
+        float unfoldY = (1.0f - fabsf(x)) * SignNotZero(y);
+        x = unfoldX;
+        y = unfoldY;
+    }
+    return normalized(Vec3(x, y, z));
+}
+
+unsigned short FloatToHalf(float f)
+{
+    unsigned int bits;
+    memcpy(&bits, &f, sizeof(bits));
+
+    unsigned int sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) {
+        // inf or nan
+        return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    }
+    if (exponent >= 31) {
+        // too large, clamp to inf
+        return (unsigned short)(sign | 0x7c00);
+    }
+    if (exponent <= 0) {
+        // denormal or zero
+        if (exponent < -10) {
+            return (unsigned short)sign;
+        }
+        mantissa |= 0x800000;
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int half = mantissa >> shift;
+        // round to nearest
+        if ((mantissa >> (shift - 1)) & 1) {
+            half += 1;
+        }
+        return (unsigned short)(sign | half);
+    }
+
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    // round to nearest; a carry into the exponent is still correct
+    if (mantissa & 0x1000) {
+        half += 1;
+    }
+    return (unsigned short)half;
+}
+
+float HalfToFloat(unsigned short h)
+{
+    unsigned int sign = (unsigned int)(h & 0x8000) << 16;
+    unsigned int exponent = (h >> 10) & 0x1f;
+    unsigned int mantissa = h & 0x3ff;
+    unsigned int bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // normalize the denormal
+            exponent = 1;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                exponent -= 1;
+            }
+            mantissa &= 0x3ff;
+            bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void QuantizeWeights(const Vec4& weights, unsigned char out[4])
+{
+    float sum = weights.x + weights.y + weights.z + weights.w;
+    if (sum <= 0.0f) {
+        out[0] = 255;
+        out[1] = out[2] = out[3] = 0;
+        return;
+    }
+
+    // round each weight, then give the rounding error to the largest one
+    int total = 0;
+    int largest = 0;
+    int quantized[4];
+    for (int i = 0; i < 4; ++i) {
+        float w = weights.v[i] / sum;
+        if (w < 0.0f) { w = 0.0f; }
+        quantized[i] = (int)floorf(w * 255.0f + 0.5f);
+        total += quantized[i];
+        if (quantized[i] > quantized[largest]) {
+            largest = i;
+        }
+    }
+    quantized[largest] += 255 - total;
+
+    for (int i = 0; i < 4; ++i) {
+        out[i] = (unsigned char)quantized[i];
+    }
+}
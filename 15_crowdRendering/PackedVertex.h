@@ -0,0 +1,58 @@
+#ifndef PACKED_VERTEX_H_INCLUDED
+#define PACKED_VERTEX_H_INCLUDED
+
+#include <Vec2.h>
+#include <Vec3.h>
+#include <Vec4.h>
+#include <Attribute.h>
+
+// Compact interleaved skinned vertex, 28 bytes instead of the 64 bytes of
+// the separate float attributes:
+//   position  float x3
+//   normal    octahedral encoded, snorm16 x2
+//   texCoord  half float x2
+//   weights   unorm8 x4, quantized so they still sum to one
+//   joints    uint8 x4
+struct PackedVertex
+{
+    float position[3];
+    short normal[2];
+    unsigned short texCoord[2];
+    unsigned char weights[4];
+    unsigned char joints[4];
+};
+
+enum class PackedVertexAttrib
+{
+    Position,
+    Normal,
+    TexCoord,
+    Weights,
+    Joints
+};
+
+// GL format of each field, for Attribute<PackedVertex>::BindTo
+AttributeFormat GetPackedVertexFormat(PackedVertexAttrib attrib);
+
+PackedVertex PackVertex(const Vec3& position,
+                        const Vec3& normal,
+                        const Vec2& texCoord,
+                        const Vec4& weights,
+                        const iVec4& joints);
+
+// decoding, matching what the GPU reads
+Vec3  UnpackPosition(const PackedVertex& v);
+Vec3  UnpackNormal(const PackedVertex& v);
+Vec2  UnpackTexCoord(const PackedVertex& v);
+Vec4  UnpackWeights(const PackedVertex& v);
+iVec4 UnpackJoints(const PackedVertex& v);
+
+// building blocks
+void           OctEncode(const Vec3& normal, short out[2]);
+Vec3           OctDecode(const short in[2]);
+unsigned short FloatToHalf(float f);
+float          HalfToFloat(unsigned short h);
+// quantizes weights to 0-255 with the sum kept at exactly 255
+void           QuantizeWeights(const Vec4& weights, unsigned char out[4]);
+
+#endif // PACKED_VERTEX_H_INCLUDED
@@ -0,0 +1,95 @@
+#ifndef POLYNOMIAL_TRACK_H_INCLUDED
+#define POLYNOMIAL_TRACK_H_INCLUDED
+
+#include <vector>
+
+#include <Track.h>
+#include <TrackHelpers.h>
+#include <TrackFrameLookup.h>
+#include <CubicPolynomial.h>
+
+// One segment of a cubic track in power basis over the segment's own
+// 0..1 range. Vec3 is padded to four lanes so Vec3 and Quat evaluate as
+// a single four wide multiply add per coefficient.
+template<int N>
+struct PolynomialSegment
+{
+    static const int Width = (N == 3) ? 4 : N;
+
+    float a[Width];
+    float b[Width];
+    float c[Width];
+    float d[Width];
+};
+
+// A cubic track converted after loading. Each segment's Hermite curve,
+// tangents already scaled by its duration and the neighborhood flip for
+// rotations already applied, is stored as a + bt + ct^2 + dt^3. Sampling
+// is one Horner evaluation per component at the cursor's t. Results
+// match TypedTrack<T, N, Interpolation::Cubic> to rounding.
+template<typename T, int N>
+class PolynomialTrack
+{
+public:
+    // frames of the source track
+    inline unsigned int GetSize() const { return (unsigned int)segments.size() + 1; }
+
+    // converts the frames of a cubic track
+    void Set(const Track<T, N>& input);
+
+    // cursor is from the lookup of the source track's key times
+    T Sample(const TrackCursor& cursor) const;
+
+protected:
+    std::vector<PolynomialSegment<N>> segments; // one less than the frames
+};
+
+template<typename T, int N>
+void PolynomialTrack<T, N>::Set(const Track<T, N>& input)
+{
+    unsigned int size = input.GetSize();
+    segments.resize(size > 1 ? size - 1 : 0);
+    for (unsigned int i = 0; i + 1 < size; ++i) {
+        const Frame<N>& thisFrame = input[i];
+        const Frame<N>& nextFrame = input[i + 1];
+        PolynomialSegment<N>& segment = segments[i];
+
+        for (int j = 0; j < PolynomialSegment<N>::Width; ++j) {
+            segment.a[j] = segment.b[j] = segment.c[j] = segment.d[j] = 0.0f;
+        }
+        float frameDelta = nextFrame.time - thisFrame.time;
+        if (frameDelta <= 0.0f) {
+            // evaluates to T(), like the other samplers
+            TrackHelpers::Store(T(), segment.a);
+            continue;
+        }
+
+        T p1 = TrackHelpers::Cast<T>(thisFrame.value);
+        T p2 = TrackHelpers::Cast<T>(nextFrame.value);
+        TrackHelpers::Neighborhood(p1, p2);
+        T s1 = TrackHelpers::CastTangent<T>(thisFrame.out) * frameDelta;
+        T s2 = TrackHelpers::CastTangent<T>(nextFrame.in) * frameDelta;
+        CubicPolynomial<T> curve = HermiteToPolynomial(p1, s1, p2, s2);
+        TrackHelpers::Store(curve.a, segment.a);
+        TrackHelpers::Store(curve.b, segment.b);
+        TrackHelpers::Store(curve.c, segment.c);
+        TrackHelpers::Store(curve.d, segment.d);
+    }
+}
+
+template<typename T, int N>
+inline T PolynomialTrack<T, N>::Sample(const TrackCursor& cursor) const
+{
+    const PolynomialSegment<N>& segment = segments[cursor.frame];
+    float t = cursor.t;
+
+    // a fixed width loop the compiler turns into vector math
+    float result[PolynomialSegment<N>::Width];
+    for (int j = 0; j < PolynomialSegment<N>::Width; ++j) {
+        result[j] = segment.a[j] + (segment.b[j] + (segment.c[j] + segment.d[j] * t) * t) * t;
+    }
+    // rotations are normalized, like Hermite's result
+    return TrackHelpers::Cast<T>(result);
+}
+
+#endif // POLYNOMIAL_TRACK_H_INCLUDED
@@ -35,7 +35,7 @@ Pose::Pose(unsigned int numJoints)
     Resize(numJoints);
 }
 
-Transform Pose::GetGlobalTransform(unsigned int index)
+Transform Pose::GetGlobalTransform(unsigned int index) const
 {
     Transform result = joints[index];
     for (int p = parents[index]; p >= 0; p = parents[p]) {
@@ -43,7 +43,7 @@ Transform Pose::GetGlobalTransform(unsigned int index)
     }
     return result;
 }
-DualQuaternion Pose::GetGlobalDualQuaternion(unsigned int index)
+DualQuaternion Pose::GetGlobalDualQuaternion(unsigned int index) const
 {
     DualQuaternion result = transformToDualQuat(joints[index]);
     for (int p = parents[index]; p >= 0; p = parents[p])
@@ -56,12 +56,12 @@ DualQuaternion Pose::GetGlobalDualQuaternion(unsigned int index)
     return result;
 }
 
-Transform Pose::operator[](unsigned int index)
+Transform Pose::operator[](unsigned int index) const
 {
     return GetGlobalTransform(index);
 }
 
-void Pose::GetMatrixPalette(std::vector<Mat4>& out)
+void Pose::GetMatrixPalette(std::vector<Mat4>& out) const
 {
 // unoptimized version
 #if 0
@@ -105,7 +105,34 @@ void Pose::GetMatrixPalette(std::vector<Mat4>& out)
     }
 }
 
-void Pose::GetDualQuaternionPalette(std::vector<DualQuaternion>& out)
+void Pose::GetAffinePalette(std::vector<Affine3x4>& out) const
+{
+    int size = (int)GetSize();
+    if ((int)out.size() != size) {
+        out.resize(size);
+    }
+
+    // parents before children reuse the parent's result, as in GetMatrixPalette
+    int i = 0;
+    for (; i < size; ++i) {
+        int parent = parents[i];
+        if (parent > i) {
+            break;
+        }
+
+        Affine3x4 global = transformToAffine(joints[i]);
+        if (parent >= 0) {
+            global = out[parent] * global;
+        }
+        out[i] = global;
+    }
+
+    for (; i < size; ++i) {
+        out[i] = transformToAffine(GetGlobalTransform(i));
+    }
+}
+
+void Pose::GetDualQuaternionPalette(std::vector<DualQuaternion>& out) const
 {
     unsigned int size = GetSize();
     if (out.size() != size) {
@@ -118,7 +145,7 @@ void Pose::GetDualQuaternionPalette(std::vector<DualQuaternion>& out)
 }
 
 
-bool Pose::operator==(const Pose& other)
+bool Pose::operator==(const Pose& other) const
 {
     if (other.joints.size() != joints.size() ||
         other.parents.size() != parents.size()) {
@@ -144,7 +171,7 @@ bool Pose::operator==(const Pose& other)
     return true;
 }
 
-bool Pose::operator!=(const Pose& other)
+bool Pose::operator!=(const Pose& other) const
 {
     return !(*this == other);
 }
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <Mat4.h>
+#include <Affine3x4.h>
 #include <Transform.h>
 #include <DualQuaternion.h>
 
@@ -28,19 +29,21 @@ public:
     }
 
     // combines transforms from the root up until the desired local joint index
-    Transform GetGlobalTransform(unsigned int index);
-    Transform operator[](unsigned int index);
+    Transform GetGlobalTransform(unsigned int index) const;
+    Transform operator[](unsigned int index) const;
 
-    DualQuaternion GetGlobalDualQuaternion(unsigned int index);
+    DualQuaternion GetGlobalDualQuaternion(unsigned int index) const;
 
     // fills out with a linear array of matrices as the gobal transform matrix of each
     // joint in the pose
-    void GetMatrixPalette(std::vector<Mat4>& out);
+    void GetMatrixPalette(std::vector<Mat4>& out) const;
+    // same global matrices without the constant bottom row
+    void GetAffinePalette(std::vector<Affine3x4>& out) const;
     // Global transform dual quaternion of each joint in the pose
-    void GetDualQuaternionPalette(std::vector<DualQuaternion>& out);
+    void GetDualQuaternionPalette(std::vector<DualQuaternion>& out) const;
 
-    bool operator==(const Pose& other);
-    bool operator!=(const Pose& other);
+    bool operator==(const Pose& other) const;
+    bool operator!=(const Pose& other) const;
 
 protected:
     
@@ -0,0 +1,194 @@
+#include <RenderQueue.h>
+#include <Uniform.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+RenderQueue::RenderQueue()
+{
+    numDraws = 0;
+    ResetStats();
+}
+
+void RenderQueue::ResetStats()
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void RenderQueue::InvalidateUniformCache()
+{
+    uniformCache.clear();
+}
+
+unsigned int RenderQueue::Submit(Shader* shader, Mesh* mesh, unsigned int numInstances)
+{
+    if (numDraws == draws.size()) {
+        draws.resize(numDraws + 1);
+    }
+    DrawCommand& command = draws[numDraws];
+    command.shader = shader;
+    command.mesh = mesh;
+    command.numInstances = numInstances;
+    for (unsigned int i = 0; i < RENDER_QUEUE_MAX_TEXTURES; ++i) {
+        command.textures[i] = 0;
+    }
+    command.uniforms.clear();
+    return numDraws++;
+}
+
+void RenderQueue::SetTexture(unsigned int draw, unsigned int unit, unsigned int texture)
+{
+    if (draw >= numDraws || unit >= RENDER_QUEUE_MAX_TEXTURES) {
+        std::cout << __func__ << ": invalid draw " << draw
+                  << " or texture unit " << unit << std::endl;
+        return;
+    }
+    draws[draw].textures[unit] = texture;
+}
+
+#define SET_UNIFORM_IMPL(tType, uType)                                   \
+    void RenderQueue::SetUniform(unsigned int draw,                      \
+                                 unsigned int location,                  \
+                                 const tType* data,                      \
+                                 unsigned int count)                     \
+    {                                                                    \
+        AddUniform(draw, location, uType, data, count,                   \
+                   count * (unsigned int)(sizeof(tType) / sizeof(float))); \
+    }
+
+SET_UNIFORM_IMPL(int, UniformType::Int)
+SET_UNIFORM_IMPL(float, UniformType::Float)
+SET_UNIFORM_IMPL(Vec2, UniformType::Vec2)
+SET_UNIFORM_IMPL(Vec3, UniformType::Vec3)
+SET_UNIFORM_IMPL(Vec4, UniformType::Vec4)
+SET_UNIFORM_IMPL(iVec2, UniformType::IVec2)
+SET_UNIFORM_IMPL(Quat, UniformType::Quat)
+SET_UNIFORM_IMPL(Mat4, UniformType::Mat4)
+
+#undef SET_UNIFORM_IMPL
+
+void RenderQueue::AddUniform(unsigned int draw, unsigned int location, UniformType type,
+                             const void* data, unsigned int count, unsigned int size)
+{
+    if (draw >= numDraws) {
+        std::cout << __func__ << ": invalid draw " << draw << std::endl;
+        return;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    UniformValue value;
+    value.location = location;
+    value.type = type;
+    value.count = count;
+    value.offset = (unsigned int)uniformData.size();
+    value.size = size;
+    uniformData.resize(value.offset + size);
+    memcpy(&uniformData[value.offset], data, size * sizeof(float));
+    draws[draw].uniforms.push_back(value);
+}
+
+bool RenderQueue::IsCached(unsigned int program, const UniformValue& value)
+{
+    unsigned long long key = ((unsigned long long)program << 32) | value.location;
+    const float* data = &uniformData[value.offset];
+    std::vector<float>& cached = uniformCache[key];
+    if (cached.size() == value.size &&
+        memcmp(&cached[0], data, value.size * sizeof(float)) == 0) {
+        return true;
+    }
+    cached.assign(data, data + value.size);
+    return false;
+}
+
+void RenderQueue::Upload(const UniformValue& value)
+{
+    const float* data = &uniformData[value.offset];
+    switch (value.type)
+    {
+    case UniformType::Int:   Uniform<int>::Set(value.location, (const int*)data, value.count); break;
+    case UniformType::Float: Uniform<float>::Set(value.location, data, value.count); break;
+    case UniformType::Vec2:  Uniform<Vec2>::Set(value.location, (const Vec2*)data, value.count); break;
+    case UniformType::Vec3:  Uniform<Vec3>::Set(value.location, (const Vec3*)data, value.count); break;
+    case UniformType::Vec4:  Uniform<Vec4>::Set(value.location, (const Vec4*)data, value.count); break;
+    case UniformType::IVec2: Uniform<iVec2>::Set(value.location, (const iVec2*)data, value.count); break;
+    case UniformType::Quat:  Uniform<Quat>::Set(value.location, (const Quat*)data, value.count); break;
+    case UniformType::Mat4:  Uniform<Mat4>::Set(value.location, (const Mat4*)data, value.count); break;
+    }
+}
+
+void RenderQueue::Flush()
+{
+    order.resize(numDraws);
+    for (unsigned int i = 0; i < numDraws; ++i) {
+        order[i] = i;
+    }
+    // stable, so draws with the same state keep their submission order
+    std::vector<DrawCommand>& commands = draws;
+    std::stable_sort(order.begin(), order.end(), [&commands](unsigned int a, unsigned int b) {
+        const DrawCommand& l = commands[a];
+        const DrawCommand& r = commands[b];
+        if (l.shader != r.shader) {
+            return l.shader->GetHandle() < r.shader->GetHandle();
+        }
+        for (unsigned int i = 0; i < RENDER_QUEUE_MAX_TEXTURES; ++i) {
+            if (l.textures[i] != r.textures[i]) {
+                return l.textures[i] < r.textures[i];
+            }
+        }
+        return l.mesh < r.mesh;
+    });
+
+    Shader* shader = nullptr;
+    Mesh* mesh = nullptr;
+    unsigned int textures[RENDER_QUEUE_MAX_TEXTURES] = { 0 };
+    for (unsigned int i = 0; i < numDraws; ++i)
+    {
+        DrawCommand& command = draws[order[i]];
+        if (command.shader != shader) {
+            shader = command.shader;
+            shader->Bind();
+            ++stats.shaderChanges;
+        }
+        for (unsigned int t = 0; t < RENDER_QUEUE_MAX_TEXTURES; ++t) {
+            if (command.textures[t] != textures[t]) {
+                textures[t] = command.textures[t];
+                glActiveTexture(GL_TEXTURE0 + t);
+                glBindTexture(GL_TEXTURE_2D, textures[t]);
+                ++stats.textureChanges;
+            }
+        }
+        if (command.mesh != mesh) {
+            mesh = command.mesh;
+            mesh->BindVertexArray();
+            ++stats.meshChanges;
+        }
+        for (unsigned int u = 0, size = (unsigned int)command.uniforms.size(); u < size; ++u) {
+            if (IsCached(shader->GetHandle(), command.uniforms[u])) {
+                ++stats.uniformsSkipped;
+            } else {
+                Upload(command.uniforms[u]);
+                ++stats.uniformUploads;
+                stats.uniformBytes += command.uniforms[u].size * sizeof(float);
+            }
+        }
+        mesh->DrawVertexArray(command.numInstances);
+        ++stats.drawCalls;
+    }
+
+    if (numDraws > 0) {
+        Mesh::UnbindVertexArray();
+        for (unsigned int t = 0; t < RENDER_QUEUE_MAX_TEXTURES; ++t) {
+            if (textures[t] != 0) {
+                glActiveTexture(GL_TEXTURE0 + t);
+                glBindTexture(GL_TEXTURE_2D, 0);
+            }
+        }
+        glActiveTexture(GL_TEXTURE0);
+        shader->UnBind();
+    }
+
+    numDraws = 0;
+    uniformData.clear();
+}
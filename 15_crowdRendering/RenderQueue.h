@@ -0,0 +1,115 @@
+#ifndef RENDER_QUEUE_H_INCLUDED
+#define RENDER_QUEUE_H_INCLUDED
+
+#include <vector>
+#include <unordered_map>
+
+#include <Vec2.h>
+#include <Vec3.h>
+#include <Vec4.h>
+#include <Mat4.h>
+#include <Quat.h>
+#include <Shader.h>
+#include <Mesh.h>
+
+#define RENDER_QUEUE_MAX_TEXTURES 4
+
+enum class UniformType
+{
+    Int,
+    Float,
+    Vec2,
+    Vec3,
+    Vec4,
+    IVec2,
+    Quat,
+    Mat4
+};
+
+struct RenderQueueStats
+{
+    unsigned int drawCalls;
+    unsigned int shaderChanges;
+    unsigned int textureChanges;
+    unsigned int meshChanges;    // vertex array binds
+    unsigned int uniformUploads;
+    unsigned int uniformBytes;    // sent with glUniform*
+    unsigned int uniformsSkipped; // value already set on the program
+};
+
+// Records draws during the frame and submits them in Flush, sorted by
+// shader, then textures, then mesh, so each of those is bound once per
+// run of draws that share it. Meshes draw from their vertex array
+// objects. Uniform values are copied when they are set; uploads are
+// skipped when the program already holds the same value.
+// Uniform locations should be looked up once (Shader::GetUniform) and kept.
+class RenderQueue
+{
+public:
+
+    RenderQueue();
+
+    // returns the draw's index for SetTexture/SetUniform
+    unsigned int Submit(Shader* shader, Mesh* mesh, unsigned int numInstances);
+    void SetTexture(unsigned int draw, unsigned int unit, unsigned int texture);
+
+    void SetUniform(unsigned int draw, unsigned int location, const int* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const float* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const Vec2* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const Vec3* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const Vec4* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const iVec2* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const Quat* data, unsigned int count = 1);
+    void SetUniform(unsigned int draw, unsigned int location, const Mat4* data, unsigned int count = 1);
+
+    // issues every recorded draw and empties the queue; GL state is left
+    // with no program, textures or vertex array bound
+    void Flush();
+
+    inline unsigned int GetNumDraws() const { return numDraws; }
+    inline const RenderQueueStats& GetStats() const { return stats; }
+    void ResetStats();
+
+    // call if uniforms of a queued shader were set outside the queue
+    void InvalidateUniformCache();
+
+private:
+
+    struct UniformValue
+    {
+        unsigned int location;
+        UniformType type;
+        unsigned int count;
+        unsigned int offset; // into uniformData
+        unsigned int size;   // in floats
+    };
+
+    struct DrawCommand
+    {
+        Shader* shader;
+        Mesh* mesh;
+        unsigned int numInstances;
+        unsigned int textures[RENDER_QUEUE_MAX_TEXTURES];
+        std::vector<UniformValue> uniforms;
+    };
+
+    // commands are reused between frames to keep their uniform storage
+    std::vector<DrawCommand> draws;
+    unsigned int numDraws;
+    std::vector<unsigned int> order;
+    std::vector<float> uniformData; // 4 byte values of this frame's uniforms
+    // last value uploaded to each (program, location)
+    std::unordered_map<unsigned long long, std::vector<float> > uniformCache;
+    RenderQueueStats stats;
+
+    void AddUniform(unsigned int draw, unsigned int location, UniformType type,
+                    const void* data, unsigned int count, unsigned int size);
+    bool IsCached(unsigned int program, const UniformValue& value);
+    void Upload(const UniformValue& value);
+
+    // disallow copy
+    RenderQueue(const RenderQueue&);
+    RenderQueue& operator=(const RenderQueue&);
+};
+
+#endif // RENDER_QUEUE_H_INCLUDED
@@ -0,0 +1,251 @@
+#include <ResampledClip.h>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+// error is measured at these points between every two frames
+#define RESAMPLE_ERROR_STEPS 4
+// a clip this close to a whole number of frames long gets no extra
+// frame for float noise in its keys' times
+#define RESAMPLE_FRAME_TOLERANCE 0.01f
+
+ResampledClip::ResampledClip()
+{
+    numFrames = 0;
+    sampleRate = 0.0f;
+    name = "No name given";
+    startTime = 0.0f;
+    endTime = 0.0f;
+    looping = true;
+}
+
+// shortest time between two keys of track; FLT_MAX without two keys
+template <typename TRACK>
+static float GetKeySpacing(const TRACK& track)
+{
+    float spacing = FLT_MAX;
+    for (unsigned int i = 1, size = track.GetSize(); i < size; ++i) {
+        float delta = track[i].time - track[i - 1].time;
+        if (delta > 0.0f && delta < spacing) {
+            spacing = delta;
+        }
+    }
+    return spacing;
+}
+
+// angle between two rotations; from the chord between them, since acos
+// of a dot product near 1 has no precision left for small angles
+static float RotationError(const Quat& a, const Quat& b)
+{
+    Quat aligned = dot(a, b) < 0.0f ? -b : b;
+    float chord = len(a - aligned) * 0.5f;
+    if (chord > 1.0f) {
+        chord = 1.0f;
+    }
+    return 4.0f * asinf(chord);
+}
+
+ResampleReport ResampledClip::Set(const Clip& input, float rate)
+{
+    ResampleReport report;
+    joints.clear();
+    channels.clear();
+    transforms.clear();
+    numFrames = 0;
+    sampleRate = 0.0f;
+    name = input.GetName();
+    startTime = input.GetStartTime();
+    endTime = input.GetEndTime();
+    looping = input.GetLooping();
+
+    // a column for every joint with an animated channel
+    unsigned int poseSize = 0;
+    float keySpacing = FLT_MAX;
+    for (unsigned int i = 0, size = input.GetSize(); i < size; ++i) {
+        unsigned int joint = input.GetIdAtIndex(i);
+        const TransformTrack& track = input.GetTrackAtIndex(i);
+        keySpacing = std::min(keySpacing, GetKeySpacing(track.GetPositionTrack()));
+        keySpacing = std::min(keySpacing, GetKeySpacing(track.GetRotationTrack()));
+        keySpacing = std::min(keySpacing, GetKeySpacing(track.GetScaleTrack()));
+        unsigned char mask = 0;
+        if (track.GetPositionTrack().GetSize() > 1) {
+            mask |= RESAMPLED_CHANNEL_POSITION;
+        }
+        if (track.GetRotationTrack().GetSize() > 1) {
+            mask |= RESAMPLED_CHANNEL_ROTATION;
+        }
+        if (track.GetScaleTrack().GetSize() > 1) {
+            mask |= RESAMPLED_CHANNEL_SCALE;
+        }
+        if (mask != 0) {
+            joints.push_back(joint);
+            channels.push_back(mask);
+            if (joint + 1 > poseSize) {
+                poseSize = joint + 1;
+            }
+        }
+    }
+
+    if (rate <= 0.0f) {
+        rate = (keySpacing < FLT_MAX) ? std::min(1.0f / keySpacing, RESAMPLED_CLIP_MAX_RATE)
+                                      : RESAMPLED_CLIP_DEFAULT_RATE;
+    }
+
+    float duration = GetDuration();
+    unsigned int numJoints = (unsigned int)joints.size();
+    if (duration > 0.0f && rate > 0.0f && numJoints > 0) {
+        unsigned int numIntervals = (unsigned int)ceilf(duration * rate - RESAMPLE_FRAME_TOLERANCE);
+        if (numIntervals < 1) {
+            numIntervals = 1;
+        }
+        numFrames = numIntervals + 1;
+        sampleRate = (float)numIntervals / duration;
+        transforms.resize(numFrames * numJoints);
+
+        Pose pose(poseSize);
+        for (unsigned int f = 0; f < numFrames; ++f) {
+            if (f + 1 < numFrames) {
+                input.Sample(pose, startTime + duration * (float)f / (float)numIntervals);
+            } else {
+                // a looping clip wraps its end time back to the start
+                // pose, so the last frame samples the tracks clamped
+                for (unsigned int i = 0, size = input.GetSize(); i < size; ++i) {
+                    unsigned int joint = input.GetIdAtIndex(i);
+                    Transform local = pose.GetLocalTransform(joint);
+                    pose.SetLocalTransform(joint, input.GetTrackAtIndex(i).Sample(local, endTime, false));
+                }
+            }
+            Transform* row = &transforms[f * numJoints];
+            const Transform* lastRow = row - numJoints;
+            for (unsigned int c = 0; c < numJoints; ++c) {
+                row[c] = pose.GetLocalTransform(joints[c]);
+                // neighboring frames share a hemisphere, so Sample can
+                // nlerp without the neighborhood check
+                if (f > 0 && dot(row[c].rotation, lastRow[c].rotation) < 0.0f) {
+                    row[c].rotation = -row[c].rotation;
+                }
+            }
+        }
+    }
+
+    report.sampleRate = sampleRate;
+    report.numFrames = numFrames;
+    report.numJoints = numJoints;
+    report.bytesBefore = GetClipBytes(input);
+    report.bytesAfter = sizeof(ResampledClip) + name.capacity() +
+                        joints.size() * sizeof(unsigned int) +
+                        channels.size() * sizeof(unsigned char) +
+                        transforms.size() * sizeof(Transform);
+    report.maxPositionError = 0.0f;
+    report.maxRotationError = 0.0f;
+    report.maxScaleError = 0.0f;
+
+    Pose expected(poseSize);
+    Pose actual(poseSize);
+    for (unsigned int f = 0; f + 1 < numFrames; ++f) {
+        for (unsigned int s = 1; s < RESAMPLE_ERROR_STEPS; ++s) {
+            float time = startTime + ((float)f + (float)s / RESAMPLE_ERROR_STEPS) / sampleRate;
+            input.Sample(expected, time);
+            Sample(actual, time);
+            for (unsigned int c = 0; c < numJoints; ++c) {
+                Transform a = expected.GetLocalTransform(joints[c]);
+                Transform b = actual.GetLocalTransform(joints[c]);
+                float positionError = len(a.position - b.position);
+                float rotationError = RotationError(a.rotation, b.rotation);
+                float scaleError = len(a.scale - b.scale);
+                if (positionError > report.maxPositionError) {
+                    report.maxPositionError = positionError;
+                }
+                if (rotationError > report.maxRotationError) {
+                    report.maxRotationError = rotationError;
+                }
+                if (scaleError > report.maxScaleError) {
+                    report.maxScaleError = scaleError;
+                }
+            }
+        }
+    }
+    return report;
+}
+
+float ResampledClip::Sample(Pose& outPose, float inTime) const
+{
+    if (numFrames == 0) {
+        return 0.0f;
+    }
+
+    unsigned int frame = 0;
+    float t = 0.0f;
+    inTime = Locate(inTime, frame, t);
+
+    unsigned int numJoints = (unsigned int)joints.size();
+    const Transform* thisRow = &transforms[frame * numJoints];
+    const Transform* nextRow = thisRow + numJoints;
+    for (unsigned int c = 0; c < numJoints; ++c) {
+        unsigned int j = joints[c];
+        unsigned char mask = channels[c];
+        Transform local = outPose.GetLocalTransform(j);
+        if (mask & RESAMPLED_CHANNEL_POSITION) {
+            local.position = lerp(thisRow[c].position, nextRow[c].position, t);
+        }
+        if (mask & RESAMPLED_CHANNEL_ROTATION) {
+            local.rotation = nlerp(thisRow[c].rotation, nextRow[c].rotation, t);
+        }
+        if (mask & RESAMPLED_CHANNEL_SCALE) {
+            local.scale = lerp(thisRow[c].scale, nextRow[c].scale, t);
+        }
+        outPose.SetLocalTransform(j, local);
+    }
+    return inTime;
+}
+
+float ResampledClip::Locate(float inTime, unsigned int& outFrame, float& outT) const
+{
+    inTime = AdjustTimeToFitRange(inTime);
+    float frameTime = (inTime - startTime) * sampleRate;
+    outFrame = (unsigned int)frameTime;
+    if (outFrame > numFrames - 2) {
+        outFrame = numFrames - 2;
+    }
+    outT = frameTime - (float)outFrame;
+    return inTime;
+}
+
+float ResampledClip::AdjustTimeToFitRange(float inTime) const
+{
+    // modulate between start and end
+    if (looping) {
+        float duration = endTime - startTime;
+        if (duration <= 0.0f) {
+            return 0.0f;
+        }
+
+        inTime = fmodf(inTime - startTime, duration);
+        if (inTime < 0.0f) {
+            inTime += duration;
+        }
+        inTime = inTime + startTime;
+
+    // clamp between start and end
+    } else {
+        if (inTime < startTime) {
+            inTime = startTime;
+        }
+        if (inTime > endTime) {
+            inTime = endTime;
+        }
+    }
+
+    return inTime;
+}
+
+std::ostream& operator<<(std::ostream& os, const ResampleReport& report)
+{
+    os << report.numFrames << " frames at " << report.sampleRate << " fps, "
+       << report.numJoints << " joints, "
+       << report.bytesBefore << " -> " << report.bytesAfter << " bytes, "
+       << "max error position " << report.maxPositionError
+       << " rotation " << report.maxRotationError
+       << " scale " << report.maxScaleError;
+    return os;
+}
@@ -0,0 +1,95 @@
+#ifndef RESAMPLED_CLIP_H_INCLUDED
+#define RESAMPLED_CLIP_H_INCLUDED
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <Clip.h>
+#include <Pose.h>
+#include <Transform.h>
+
+// as a rate, has Set derive it from the source's keys
+#define RESAMPLED_CLIP_KEY_RATE     0.0f
+// for a source without two keys on any track
+#define RESAMPLED_CLIP_DEFAULT_RATE 30.0f
+#define RESAMPLED_CLIP_MAX_RATE     120.0f
+
+// which parts of a joint's transform the source clip animates
+#define RESAMPLED_CHANNEL_POSITION 1
+#define RESAMPLED_CHANNEL_ROTATION 2
+#define RESAMPLED_CHANNEL_SCALE    4
+
+struct ResampleReport
+{
+    float sampleRate;          // frames per second, fit to the duration
+    unsigned int numFrames;
+    unsigned int numJoints;    // columns of the table
+    size_t bytesBefore;        // the source clip's keyframes
+    size_t bytesAfter;         // the table
+    // against the source, between frames where the error peaks
+    float maxPositionError;
+    float maxRotationError;    // radians
+    float maxScaleError;
+};
+
+// A clip resampled to frames at a fixed rate, stored as one dense
+// [frame][joint] table of local transforms. Sampling a time is a floor
+// and one lerp per channel, with no key search; a frame is a contiguous
+// row, ready to be streamed or sampled several joints at a time.
+class ResampledClip
+{
+public:
+
+    ResampledClip();
+
+    // samples every track of input at the rate, rounded so a whole number
+    // of frames spans the clip, and measures the error against it. The
+    // key rate puts a frame on every key of the most densely keyed track
+    // (up to RESAMPLED_CLIP_MAX_RATE), so evenly keyed linear sources
+    // come out exact; a fixed rate that misses the keys cuts corners
+    ResampleReport Set(const Clip& input, float rate = RESAMPLED_CLIP_KEY_RATE);
+
+    // fills in outPose and returns the adjusted time for that pose; like
+    // Clip::Sample, channels the source doesn't animate are left alone
+    float Sample(Pose& outPose, float inTime) const;
+    // the row inTime falls in and how far it is toward the next row;
+    // returns the adjusted time like Sample. Only valid with frames
+    float Locate(float inTime, unsigned int& outFrame, float& outT) const;
+
+    inline unsigned int GetNumFrames() const { return numFrames; }
+    inline unsigned int GetNumJoints() const { return (unsigned int)joints.size(); }
+    inline unsigned int GetJoint(unsigned int column) const { return joints[column]; }
+    // RESAMPLED_CHANNEL_ bits
+    inline unsigned char GetChannels(unsigned int column) const { return channels[column]; }
+    inline float        GetSampleRate() const { return sampleRate; }
+    // a row of GetNumJoints() transforms
+    inline const Transform* GetFrame(unsigned int frame) const {
+        return &transforms[frame * joints.size()];
+    }
+
+    inline const std::string& GetName() const      { return name;                }
+    inline float              GetDuration() const  { return endTime - startTime; }
+    inline float              GetStartTime() const { return startTime;           }
+    inline float              GetEndTime() const   { return endTime;             }
+    inline bool               GetLooping() const   { return looping;             }
+    inline void               SetLooping(bool inLooping) { looping = inLooping;  }
+
+protected:
+
+    std::vector<unsigned int> joints;   // joint id of each column
+    std::vector<unsigned char> channels; // RESAMPLED_CHANNEL_ bits of each column
+    std::vector<Transform> transforms;  // numFrames rows of joints.size()
+    unsigned int numFrames;
+    float sampleRate;
+    std::string name;
+
+    float startTime;
+    float endTime;
+    bool looping;
+
+    float AdjustTimeToFitRange(float inTime) const;
+};
+
+std::ostream& operator<<(std::ostream& os, const ResampleReport& report);
+
+#endif // RESAMPLED_CLIP_H_INCLUDED
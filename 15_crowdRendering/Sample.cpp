@@ -7,44 +7,102 @@ bool Sample::Initialize(const char* title, const int width, const int height)
         return false;
     }
     
-    cgltf_data* gltf = LoadGLTFFile("Assets/Woman.gltf");
-    meshes = LoadMeshes(gltf);
-    skeleton = LoadSkeleton(gltf);
-    clips = LoadAnimationClips(gltf);
-    FreeGLTFFile(gltf);
-    
-    crowdShader = new Shader("Shaders/crowd.vert", "Shaders/lit.frag");
-    diffuseTexture = new Texture("Assets/Woman.png");
-    
-    unsigned int numClips = (unsigned int)clips.size();
+    // shaders are compiled here since they need the GL context; everything
+    // else is loaded on worker threads and uploaded as it finishes
+    crowdShader = new Shader("Shaders/crowdSkinMatrix.vert", "Shaders/lit.frag");
+    diffuseUniform = crowdShader->GetUniform("tex0");
+    animTexUniform = crowdShader->GetUniform("animTex");
+    crowdUniforms.Resolve(crowdShader);
+    diffuseTexture = new Texture();
+    assetsReady = false;
+    numAssetsPending = 2;
+    loader = new AssetLoader();
+    jobs = new JobSystem();
+
+    // decoded (or mapped from its cache) on a worker, uploaded here
+    loader->Submit([this]() {
+        diffuseTexture->Decode("Assets/Woman.png");
+    }, [this]() {
+        if (diffuseTexture->IsDecoded()) {
+            diffuseTexture->Upload();
+            std::cout << "Assets/Woman.png: " << diffuseTexture->GetLoadStats() << std::endl;
+        }
+        OnAssetLoaded();
+    });
+
+    loader->Submit([this]() {
+        cgltf_data* gltf = LoadGLTFFile("Assets/Woman.gltf");
+        if (gltf == nullptr) {
+            return;
+        }
+        meshes = LoadMeshes(gltf, false);
+        for (unsigned int i = 0; i < meshes.size(); ++i) {
+            MeshOptimizerReport report = OptimizeMesh(meshes[i]);
+            std::cout << "Mesh " << i << ": " << report << std::endl;
+            meshes[i].SetVertexFormat(VertexFormat::Packed);
+        }
+        skeleton = LoadSkeleton(gltf);
+        // the manager keeps the file around to load clips when needed
+        clipManager.Register(gltf);
+    }, [this]() {
+        OnModelLoaded();
+    });
+
+    return true;
+}
+
+void Sample::OnModelLoaded()
+{
+    for (unsigned int i = 0, size = (unsigned int)meshes.size(); i < size; ++i) {
+        meshes[i].UpdateOpenGLBuffers();
+    }
+
+    // one skin matrix texture per clip, read from disk or baked if missing;
+    // only a missing texture needs the clip loaded
+    unsigned int numClips = clipManager.GetNumClips();
     textures.resize(numClips);
     crowds.resize(numClips);
+    numAssetsPending += numClips;
     for (unsigned int i = 0; i < numClips; ++i)
     {
-        std::string fileName = "Assets/";
-        fileName += clips[i].GetName();
-        fileName += ".animTex";
-        bool fileExists = true;
-        {
-            std::ifstream testFile(fileName);
-            if (!testFile.is_open()) {
-                fileExists = false;
+        loader->Submit([this, i]() {
+            std::string fileName = "Assets/";
+            fileName += clipManager.GetName(i);
+            fileName += ".skinTex";
+            bool fileExists = true;
+            {
+                std::ifstream testFile(fileName);
+                if (!testFile.is_open()) {
+                    fileExists = false;
+                } else {
+                    testFile.close();
+                }
+            }
+            if (fileExists) {
+                textures[i].LoadData(fileName.c_str());
             } else {
-                testFile.close();
+                const Clip* clip = clipManager.Acquire(i);
+                textures[i].Resize(512);
+                BakeSkinMatrixData(skeleton, *clip, textures[i]);
+                clipManager.Release(clip);
+                textures[i].Save(fileName.c_str());
             }
-        }
-        if (fileExists) {
-            textures[i].Load(fileName.c_str());
-        } else {
-            textures[i].Resize(512);
-            BakeAnimationTexture(skeleton, clips[i], textures[i]);
-            textures[i].Save(fileName.c_str());
-        }
+        }, [this, i]() {
+            textures[i].UploadToGPU();
+            OnAssetLoaded();
+        });
     }
-    
-    SetCrowdSize(20);
 
-    return true;
+    OnAssetLoaded();
+}
+
+void Sample::OnAssetLoaded()
+{
+    --numAssetsPending;
+    if (numAssetsPending == 0) {
+        SetCrowdSize(20);
+        assetsReady = true;
+    }
 }
 
 void Sample::SetCrowdSize(unsigned int size)
@@ -53,8 +111,10 @@ void Sample::SetCrowdSize(unsigned int size)
     unsigned int numCrowds = (unsigned int)crowds.size();
     for (unsigned int i = 0; i < numCrowds; ++i)
     {
+        const Clip* clip = clipManager.Acquire(i);
         crowds[i].Resize(20);
-        crowds[i].RandomizeTimes(clips[i]);
+        crowds[i].RandomizeTimes(*clip);
+        clipManager.Release(clip);
         crowds[i].RandomizePositions(occupied, Vec3(-40, 0, -80.0f), Vec3(40, 0, 30.0f), 2.0f);
     }
 }
@@ -63,52 +123,70 @@ void Sample::Update(float inDeltaTime)
 {
     Application::Update(inDeltaTime);
 
-    unsigned int numCrowds = (unsigned int)crowds.size();
-    for (unsigned int i = 0; i < numCrowds; ++i) {
-        crowds[i].Update(inDeltaTime, clips[i], textures[i].GetSize());
+    // finished loads are uploaded here, on the GL thread
+    loader->Drain();
+    if (!assetsReady) {
+        return;
     }
+
+    // crowds play different clips and don't share any state. Clips are
+    // only pinned while a crowd reads them, so the manager can evict and
+    // reload them when they don't all fit its budget
+    jobs->ParallelFor("CrowdUpdate", (unsigned int)crowds.size(), 1,
+        [this, inDeltaTime](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; ++i) {
+            const Clip* clip = clipManager.Acquire(i);
+            crowds[i].Update(inDeltaTime, *clip, textures[i].GetSize());
+            clipManager.Release(clip);
+        }
+    });
+    jobs->WaitAll();
 }
 
 void Sample::Render(float inAspectRatio)
 {
+    if (!assetsReady) {
+        return;
+    }
+
     Mat4 projection = perspective(60.0f, inAspectRatio, 0.01f, 1000.0f);
     Mat4 view = lookAt(Vec3(0,15,40), Vec3(0,3,0), Vec3(0,1,0));
     Mat4 mvp = projection * view; // no model matrix
     
-    crowdShader->Bind();
-    Uniform<Mat4>::Set(crowdShader->GetUniform("view"), view);
-    Uniform<Mat4>::Set(crowdShader->GetUniform("projection"), projection);
-    Uniform<Vec3>::Set(crowdShader->GetUniform("light"), Vec3(1,1,1));
-    Uniform<Mat4>::Set(crowdShader->GetUniform("invBindPose"), skeleton.GetInvBindPose());
-    diffuseTexture->Set(crowdShader->GetUniform("tex0"), 0);
-    
+    FrameUniformBlock frame;
+    frame.view = view;
+    frame.projection = projection;
+    frame.light = Vec4(1, 1, 1, 0);
+    frameUniforms.Set(frame);
+    frameUniforms.BindTo(SHADER_BLOCK_FRAME);
+
+    int diffuseUnit = 0;
+    int animTexUnit = 1;
+
     unsigned int numCrowds = (unsigned int)crowds.size();
     for (unsigned int c = 0; c < numCrowds; ++c)
     {
-        textures[c].Bind(crowdShader->GetUniform("animTex"), 1); // GL_TEXTURE1
-        crowds[c].SetUniforms(crowdShader);
         for (unsigned int i = 0, size = (unsigned int)meshes.size(); i < size; ++i)
         {
-            meshes[i].Bind(crowdShader->GetAttribute("position"),
-                           crowdShader->GetAttribute("normal"),
-                           crowdShader->GetAttribute("texCoord"),
-                           crowdShader->GetAttribute("weights"),
-                           crowdShader->GetAttribute("joints"));
-            meshes[i].DrawInstanced(crowds[c].GetSize());
-            meshes[i].Unbind(crowdShader->GetAttribute("position"),
-                             crowdShader->GetAttribute("normal"),
-                             crowdShader->GetAttribute("texCoord"),
-                             crowdShader->GetAttribute("weights"),
-                             crowdShader->GetAttribute("joints"));
+            unsigned int draw = renderQueue.Submit(crowdShader, &meshes[i], crowds[c].GetSize());
+            renderQueue.SetTexture(draw, diffuseUnit, diffuseTexture->GetHandle());
+            renderQueue.SetTexture(draw, animTexUnit, textures[c].GetId());
+            renderQueue.SetUniform(draw, diffuseUniform, &diffuseUnit);
+            renderQueue.SetUniform(draw, animTexUniform, &animTexUnit);
+            crowds[c].SetUniforms(renderQueue, draw, crowdUniforms);
         }
-        textures[c].Unbind(1);
     }
-    diffuseTexture->Unset(0);
-    crowdShader->UnBind();
+    renderQueue.Flush();
 }
 
 void Sample::Shutdown()
 {
+    delete loader;
+    loader = nullptr;
+    delete jobs;
+    jobs = nullptr;
+
+    clipManager.Clear();
     Application::Shutdown();
 }
 
@@ -25,6 +25,12 @@
 #include <AnimTexture.h>
 #include <AnimBaker.h>
 #include <Crowd.h>
+#include <ClipManager.h>
+#include <AssetLoader.h>
+#include <JobSystem.h>
+#include <MeshOptimizer.h>
+#include <RenderQueue.h>
+#include <UniformBuffer.h>
 
 class Sample : public Application
 {
@@ -40,12 +46,26 @@ private:
     Texture* diffuseTexture;
     Shader* crowdShader;
     std::vector<Mesh> meshes;
-    std::vector<Clip> clips;
+    ClipManager clipManager; // one clip per crowd, acquired while in use
     std::vector<AnimTexture> textures;
     std::vector<Crowd> crowds;
     Skeleton skeleton;
+
+    // draws go through the queue with uniform locations looked up once
+    RenderQueue renderQueue;
+    UniformBuffer frameUniforms; // camera and light, set once per frame
+    unsigned int diffuseUniform;
+    unsigned int animTexUniform;
+    CrowdUniforms crowdUniforms;
+
+    AssetLoader* loader;
+    JobSystem* jobs; // per frame updates
+    unsigned int numAssetsPending;
+    bool assetsReady;
     
     void SetCrowdSize(unsigned int size);
+    void OnModelLoaded();
+    void OnAssetLoaded();
     
 };
 
@@ -47,6 +47,8 @@ void Shader::Load(const std::string& vertex,
     if (LinkShaders(vert, frag)) {
         PopulateAttributes();
         PopulateUniforms();
+        BindUniformBlock("FrameData", SHADER_BLOCK_FRAME);
+        BindUniformBlock("SkeletonData", SHADER_BLOCK_SKELETON);
     }
 }
 
@@ -78,6 +80,16 @@ unsigned int Shader::GetUniform(const std::string& name)
 
 }
 
+bool Shader::BindUniformBlock(const std::string& name, unsigned int index)
+{
+    unsigned int block = glGetUniformBlockIndex(progID, name.c_str());
+    if (block == GL_INVALID_INDEX) {
+        return false;
+    }
+    glUniformBlockBinding(progID, block, index);
+    return true;
+}
+
 unsigned int Shader::GetHandle() { return progID; }
 
 std::string Shader::ReadFile(const std::string& path)
@@ -136,6 +148,11 @@ bool Shader::LinkShaders(unsigned int vertex, unsigned int fragment)
 {
     glAttachShader(progID, vertex);
     glAttachShader(progID, fragment);
+    glBindAttribLocation(progID, SHADER_ATTRIB_POSITION, "position");
+    glBindAttribLocation(progID, SHADER_ATTRIB_NORMAL,   "normal");
+    glBindAttribLocation(progID, SHADER_ATTRIB_TEXCOORD, "texCoord");
+    glBindAttribLocation(progID, SHADER_ATTRIB_WEIGHTS,  "weights");
+    glBindAttribLocation(progID, SHADER_ATTRIB_JOINTS,   "joints");
     glLinkProgram(progID);
 
     int success = 0;
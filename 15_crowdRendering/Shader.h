@@ -6,6 +6,19 @@
 #include <map>
 #include <string>
 
+// every shader is linked with these attribute locations, so the vertex
+// array object of a mesh works with all of them
+#define SHADER_ATTRIB_POSITION 0
+#define SHADER_ATTRIB_NORMAL   1
+#define SHADER_ATTRIB_TEXCOORD 2
+#define SHADER_ATTRIB_WEIGHTS  3
+#define SHADER_ATTRIB_JOINTS   4
+
+// uniform blocks are bound to these indices when a shader is linked;
+// see UniformBuffer.h for their layouts
+#define SHADER_BLOCK_FRAME    0 // FrameData
+#define SHADER_BLOCK_SKELETON 1 // SkeletonData
+
 class Shader
 {
 public:
@@ -23,6 +36,8 @@ public:
 
     unsigned int GetAttribute(const std::string& name);
     unsigned int GetUniform(const std::string& name);
+    // false if the shader has no block with that name
+    bool BindUniformBlock(const std::string& name, unsigned int index);
     unsigned int GetHandle();
 
 private:
@@ -2,9 +2,20 @@
 #define MAX_BONES 60
 #define MAX_INSTANCES 80
 
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 invBindPose[MAX_BONES];
+// shared per-frame data, see FrameUniformBlock
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 light;
+};
+
+// constant per skeleton, see SkeletonUniformBlock
+layout(std140) uniform SkeletonData
+{
+    mat3x4 invBindPose[MAX_BONES]; // rows of an affine matrix
+};
+
 uniform sampler2D animTex;
 
 // unique to each actor in the crowd
@@ -49,7 +60,7 @@ mat4 GetModel(int instance)
 mat4 GetPose(int joint, int instance)
 {
     int x_now = frames[instance].x;
-    int x_next = frames[instance].x;
+    int x_next = frames[instance].y;
     int y_pos = joint * 3;
 
     // get current and next value
@@ -80,6 +91,12 @@ mat4 GetPose(int joint, int instance)
                 position.x, position.y, position.z, 1.0);
 }
 
+mat4 GetInvBindPose(int joint)
+{
+    mat3x4 rows = invBindPose[joint];
+    return transpose(mat4(rows[0], rows[1], rows[2], vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
 void main()
 {
     mat4 pose0 = GetPose(joints.x, gl_InstanceID);
@@ -88,10 +105,10 @@ void main()
     mat4 pose3 = GetPose(joints.w, gl_InstanceID);
 
     mat4 model = GetModel(gl_InstanceID);
-    mat4 skin = (pose0 * invBindPose[joints.x]) * weights.x;
-    skin += (pose1 * invBindPose[joints.y]) * weights.y;
-    skin += (pose2 * invBindPose[joints.z]) * weights.z;
-    skin += (pose3 * invBindPose[joints.w]) * weights.w;
+    mat4 skin = (pose0 * GetInvBindPose(joints.x)) * weights.x;
+    skin += (pose1 * GetInvBindPose(joints.y)) * weights.y;
+    skin += (pose2 * GetInvBindPose(joints.z)) * weights.z;
+    skin += (pose3 * GetInvBindPose(joints.w)) * weights.w;
 
     gl_Position = projection * view * model * skin * vec4(position, 1.0);
     fragPos = vec3(model * skin * vec4(position, 1.0));
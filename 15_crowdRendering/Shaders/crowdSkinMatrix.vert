@@ -0,0 +1,110 @@
+#version 330 core
+#define MAX_INSTANCES 80
+
+// shared per-frame data, see FrameUniformBlock
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 light;
+};
+
+uniform sampler2D animTex; // skin matrices from BakeSkinMatrixData
+
+// unique to each actor in the crowd
+uniform vec3 model_pos[MAX_INSTANCES];
+uniform vec4 model_rot[MAX_INSTANCES];
+uniform vec3 model_scl[MAX_INSTANCES];
+uniform ivec2 frames[MAX_INSTANCES];
+uniform float time[MAX_INSTANCES];
+
+in vec3 position;
+in vec2 normal; // octahedral encoded
+in vec2 texCoord;
+in vec4 weights;
+in ivec4 joints;
+
+out vec3 norm;
+out vec3 fragPos;
+out vec2 uv;
+
+vec3 QMulV(vec4 q, vec3 v)
+{
+    return q.xyz * 2.0f * dot(q.xyz, v) +
+           v * (q.w * q.w - dot(q.xyz, q.xyz)) +
+           cross(q.xyz, v) * 2.0f * q.w;
+}
+
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 s = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * s;
+    }
+    return normalize(n);
+}
+
+// returns the result model transform matrix
+mat4 GetModel(int instance)
+{
+    vec3 position = model_pos[instance];
+    vec4 rotation = model_rot[instance];
+    vec3 scale = model_scl[instance];
+    vec3 xBasis = QMulV(rotation, vec3(scale.x, 0, 0));
+    vec3 yBasis = QMulV(rotation, vec3(0, scale.y, 0));
+    vec3 zBasis = QMulV(rotation, vec3(0, 0, scale.z));
+    return mat4(xBasis.x, xBasis.y, xBasis.z, 0.0,
+                yBasis.x, yBasis.y, yBasis.z, 0.0,
+                zBasis.x, zBasis.y, zBasis.z, 0.0,
+                position.x, position.y, position.z, 1.0);
+}
+
+// fractional texture column of the instance's current pose; the linear
+// filter blends the two neighbouring baked frames in a single fetch
+float GetColumn(int instance)
+{
+    int x_now = frames[instance].x;
+    int x_next = frames[instance].y;
+    if (x_next < x_now) {
+        // wrapped around the end of the clip; don't blend across it
+        return float(x_now);
+    }
+    return mix(float(x_now), float(x_next), time[instance]);
+}
+
+// the top three rows of the joint's skin matrix
+// (global pose * inverse bind pose), the fourth row is (0, 0, 0, 1)
+mat3x4 GetSkin(int joint, float column)
+{
+    vec2 texel = 1.0 / vec2(textureSize(animTex, 0));
+    float y = float(joint * 3) + 0.5;
+    float x = column + 0.5;
+
+    return mat3x4(texture(animTex, vec2(x, y + 0.0) * texel),
+                  texture(animTex, vec2(x, y + 1.0) * texel),
+                  texture(animTex, vec2(x, y + 2.0) * texel));
+}
+
+void main()
+{
+    float column = GetColumn(gl_InstanceID);
+
+    // the rows are linear in the matrix, so blend them before transforming
+    mat3x4 skin = GetSkin(joints.x, column) * weights.x;
+    skin += GetSkin(joints.y, column) * weights.y;
+    skin += GetSkin(joints.z, column) * weights.z;
+    skin += GetSkin(joints.w, column) * weights.w;
+
+    vec4 p = vec4(position, 1.0);
+    vec4 n = vec4(OctDecode(normal), 0.0);
+    vec3 skinnedPos = vec3(dot(skin[0], p), dot(skin[1], p), dot(skin[2], p));
+    vec3 skinnedNorm = vec3(dot(skin[0], n), dot(skin[1], n), dot(skin[2], n));
+
+    mat4 model = GetModel(gl_InstanceID);
+    gl_Position = projection * view * model * vec4(skinnedPos, 1.0);
+    fragPos = vec3(model * vec4(skinnedPos, 1.0));
+    norm = vec3(model * vec4(skinnedNorm, 0.0f));
+    uv = texCoord;
+}
+
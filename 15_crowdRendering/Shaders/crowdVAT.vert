@@ -0,0 +1,79 @@
+#version 330 core
+#define MAX_INSTANCES 80
+
+// shared per-frame data, see FrameUniformBlock
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 light;
+};
+
+uniform sampler2D animTex; // skinned vertices from BakeVertexAnimationData
+uniform int numFrames;     // frames baked per vertex
+
+// unique to each actor in the crowd
+uniform vec3 model_pos[MAX_INSTANCES];
+uniform vec4 model_rot[MAX_INSTANCES];
+uniform vec3 model_scl[MAX_INSTANCES];
+uniform ivec2 frames[MAX_INSTANCES];
+uniform float time[MAX_INSTANCES];
+
+// positions and normals come from the texture, looked up by gl_VertexID
+in vec2 texCoord;
+
+out vec3 norm;
+out vec3 fragPos;
+out vec2 uv;
+
+vec3 QMulV(vec4 q, vec3 v)
+{
+    return q.xyz * 2.0f * dot(q.xyz, v) +
+           v * (q.w * q.w - dot(q.xyz, q.xyz)) +
+           cross(q.xyz, v) * 2.0f * q.w;
+}
+
+// returns the result model transform matrix
+mat4 GetModel(int instance)
+{
+    vec3 position = model_pos[instance];
+    vec4 rotation = model_rot[instance];
+    vec3 scale = model_scl[instance];
+    vec3 xBasis = QMulV(rotation, vec3(scale.x, 0, 0));
+    vec3 yBasis = QMulV(rotation, vec3(0, scale.y, 0));
+    vec3 zBasis = QMulV(rotation, vec3(0, 0, scale.z));
+    return mat4(xBasis.x, xBasis.y, xBasis.z, 0.0,
+                yBasis.x, yBasis.y, yBasis.z, 0.0,
+                zBasis.x, zBasis.y, zBasis.z, 0.0,
+                position.x, position.y, position.z, 1.0);
+}
+
+// fractional frame of the instance's current pose; the linear filter
+// blends the two neighbouring baked frames in a single fetch
+float GetFrame(int instance)
+{
+    int x_now = frames[instance].x;
+    int x_next = frames[instance].y;
+    if (x_next < x_now) {
+        // wrapped around the end of the clip; don't blend across it
+        return float(x_now);
+    }
+    return mix(float(x_now), float(x_next), time[instance]);
+}
+
+void main()
+{
+    int texSize = textureSize(animTex, 0).x;
+    int vertsPerBlock = texSize / 2;
+    float x = float((gl_VertexID / vertsPerBlock) * numFrames) + GetFrame(gl_InstanceID) + 0.5;
+    float y = float((gl_VertexID % vertsPerBlock) * 2) + 0.5;
+    vec3 skinnedPos = texture(animTex, vec2(x, y) / float(texSize)).xyz;
+    vec3 skinnedNorm = texture(animTex, vec2(x, y + 1.0) / float(texSize)).xyz;
+
+    mat4 model = GetModel(gl_InstanceID);
+    gl_Position = projection * view * model * vec4(skinnedPos, 1.0);
+    fragPos = vec3(model * vec4(skinnedPos, 1.0));
+    norm = vec3(model * vec4(skinnedNorm, 0.0f));
+    uv = texCoord;
+}
+
@@ -4,7 +4,14 @@ in vec3 norm;
 in vec3 fragPos;
 in vec2 uv;
 
-uniform vec3 light;
+// shared per-frame data, see FrameUniformBlock
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 light;
+};
+
 uniform sampler2D tex0;
 
 out vec4 FragColor;
@@ -13,7 +20,7 @@ void main()
 {
     vec4 diffuse = texture(tex0, uv);
     vec3 n = normalize(norm);
-    vec3 l = normalize(light);
+    vec3 l = normalize(light.xyz);
     float diffIntensity = clamp(dot(n,l), 0, 1);
     FragColor = diffuse * diffIntensity;
 }
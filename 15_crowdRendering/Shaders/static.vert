@@ -9,8 +9,14 @@ out vec3 fragPos;
 out vec2 uv;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+// shared per-frame data, see FrameUniformBlock
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    vec4 light;
+};
 
 void main()
 {
@@ -33,7 +33,7 @@ void Skeleton::UpdateInverseBindPose()
     }
 }
 
-void Skeleton::GetInvBindPose(std::vector<DualQuaternion>& out)
+void Skeleton::GetInvBindPose(std::vector<DualQuaternion>& out) const
 {
     if (out.size() != invBindPose.size()) {
         out.resize(invBindPose.size());
@@ -46,3 +46,13 @@ void Skeleton::GetInvBindPose(std::vector<DualQuaternion>& out)
     }
 }
 
+void Skeleton::GetInvBindPose(std::vector<Affine3x4>& out) const
+{
+    if (out.size() != invBindPose.size()) {
+        out.resize(invBindPose.size());
+    }
+
+    for (unsigned int i = 0; i < out.size(); ++i) {
+        out[i] = mat4ToAffine(invBindPose[i]);
+    }
+}
@@ -8,6 +8,7 @@
 #include <Pose.h>
 #include <Transform.h>
 #include <DualQuaternion.h>
+#include <Affine3x4.h>
 
 class Skeleton
 {
@@ -25,7 +26,16 @@ public:
     inline std::vector<std::string>& GetJointNames()     { return jointNames;  }
     inline std::string& GetJointName(unsigned int index) { return jointNames[index]; }
 
-    void GetInvBindPose(std::vector<DualQuaternion>& out);
+    // read only access, safe from many threads at once
+    inline const Pose& GetBindPose() const { return bindPose; }
+    inline const Pose& GetRestPose() const { return restPose; }
+
+    inline const std::vector<Mat4>& GetInvBindPose() const           { return invBindPose; }
+    inline const std::vector<std::string>& GetJointNames() const     { return jointNames;  }
+    inline const std::string& GetJointName(unsigned int index) const { return jointNames[index]; }
+
+    void GetInvBindPose(std::vector<DualQuaternion>& out) const;
+    void GetInvBindPose(std::vector<Affine3x4>& out) const;
 
 protected:
 
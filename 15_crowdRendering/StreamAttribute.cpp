@@ -0,0 +1,253 @@
+#include <StreamAttribute.h>
+#include <Vec2.h>
+#include <Vec3.h>
+#include <Vec4.h>
+#include <iostream>
+#include <cstring>
+
+template class StreamAttribute<float>;
+template class StreamAttribute<Vec2>;
+template class StreamAttribute<Vec3>;
+template class StreamAttribute<Vec4>;
+
+// GL objects are created on the first Map so this can be constructed
+// without a context
+template<typename T>
+StreamAttribute<T>::StreamAttribute()
+{
+    id = 0;
+    count = 0;
+    capacity = 0;
+    segment = 0;
+    persistent = false;
+    persistentData = nullptr;
+    mapped = nullptr;
+    for (unsigned int i = 0; i < STREAM_ATTRIBUTE_SEGMENTS; ++i) {
+        fences[i] = 0;
+    }
+    ResetCounters();
+}
+
+template<typename T>
+StreamAttribute<T>::~StreamAttribute()
+{
+    Release();
+}
+
+template<typename T>
+void StreamAttribute<T>::ResetCounters()
+{
+    bytesUploaded = 0;
+    numStalls = 0;
+    numOrphans = 0;
+    numReallocations = 0;
+}
+
+template<typename T>
+T* StreamAttribute<T>::Map(unsigned int length)
+{
+    if (mapped != nullptr) {
+        std::cerr << __func__ << ": already mapped" << std::endl;
+        return mapped;
+    }
+    if (length == 0) {
+        return nullptr;
+    }
+
+    if (id == 0 || length > capacity) {
+        Allocate(length);
+    } else {
+        // every draw using the current segment has been issued by now
+        if (fences[segment] != 0) {
+            glDeleteSync(fences[segment]);
+        }
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        segment = (segment + 1) % STREAM_ATTRIBUTE_SEGMENTS;
+    }
+
+    unsigned int bytes = length * sizeof(T);
+    if (persistent) {
+        WaitForSegment(segment, true);
+        mapped = persistentData + segment * capacity;
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        if (!WaitForSegment(segment, false)) {
+            // the GPU is behind; give the driver a new store instead of waiting
+            glBufferData(GL_ARRAY_BUFFER,
+                         capacity * STREAM_ATTRIBUTE_SEGMENTS * sizeof(T),
+                         nullptr,
+                         GL_STREAM_DRAW);
+            DeleteFences();
+            ++numOrphans;
+        }
+        mapped = (T*)glMapBufferRange(GL_ARRAY_BUFFER,
+                                      segment * capacity * sizeof(T),
+                                      bytes,
+                                      GL_MAP_WRITE_BIT |
+                                      GL_MAP_INVALIDATE_RANGE_BIT |
+                                      GL_MAP_UNSYNCHRONIZED_BIT);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (mapped == nullptr) {
+            std::cerr << __func__ << ": failed to map buffer" << std::endl;
+            return nullptr;
+        }
+    }
+
+    count = length;
+    bytesUploaded += bytes;
+    return mapped;
+}
+
+template<typename T>
+void StreamAttribute<T>::Unmap()
+{
+    if (mapped == nullptr) {
+        return;
+    }
+    // persistent memory is coherent, so there is nothing to flush
+    if (!persistent) {
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    mapped = nullptr;
+}
+
+template<typename T>
+void StreamAttribute<T>::Set(const T* inputArray, unsigned int length)
+{
+    T* dest = Map(length);
+    if (dest != nullptr) {
+        memcpy(dest, inputArray, length * sizeof(T));
+    }
+    Unmap();
+}
+
+template<typename T>
+void StreamAttribute<T>::BindTo(unsigned int slot)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    glEnableVertexAttribArray(slot);
+    SetAttribPointer(slot, segment * capacity * sizeof(T));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+template<typename T>
+void StreamAttribute<T>::UnbindFrom(unsigned int slot)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    glDisableVertexAttribArray(slot);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+template<typename T>
+void StreamAttribute<T>::Allocate(unsigned int newCapacity)
+{
+    if (id != 0) {
+        ++numReallocations;
+    }
+    Release();
+
+    capacity = newCapacity;
+    segment = 0;
+    unsigned int size = capacity * STREAM_ATTRIBUTE_SEGMENTS * sizeof(T);
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    persistent = GLEW_ARB_buffer_storage;
+    if (persistent) {
+        glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        persistentData = (T*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+        if (persistentData == nullptr) {
+            // storage is immutable, so start over with a plain buffer
+            persistent = false;
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glDeleteBuffers(1, &id);
+            glGenBuffers(1, &id);
+            glBindBuffer(GL_ARRAY_BUFFER, id);
+        }
+    }
+    if (!persistent) {
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+template<typename T>
+void StreamAttribute<T>::Release()
+{
+    if (id == 0) {
+        return;
+    }
+    if (persistentData != nullptr || mapped != nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    DeleteFences();
+    glDeleteBuffers(1, &id);
+    id = 0;
+    count = 0;
+    persistentData = nullptr;
+    mapped = nullptr;
+}
+
+template<typename T>
+void StreamAttribute<T>::DeleteFences()
+{
+    for (unsigned int i = 0; i < STREAM_ATTRIBUTE_SEGMENTS; ++i) {
+        if (fences[i] != 0) {
+            glDeleteSync(fences[i]);
+            fences[i] = 0;
+        }
+    }
+}
+
+template<typename T>
+bool StreamAttribute<T>::WaitForSegment(unsigned int index, bool block)
+{
+    GLsync fence = fences[index];
+    if (fence == 0) {
+        return true;
+    }
+
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        if (!block) {
+            return false;
+        }
+        ++numStalls;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED) {
+        std::cerr << __func__ << ": glClientWaitSync failed" << std::endl;
+    }
+
+    glDeleteSync(fence);
+    fences[index] = 0;
+    return true;
+}
+
+template<>
+void StreamAttribute<float>::SetAttribPointer(unsigned int slot, unsigned int offset)
+{
+    glVertexAttribPointer(slot, 1, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)offset);
+}
+template<>
+void StreamAttribute<Vec2>::SetAttribPointer(unsigned int slot, unsigned int offset)
+{
+    glVertexAttribPointer(slot, 2, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)offset);
+}
+template<>
+void StreamAttribute<Vec3>::SetAttribPointer(unsigned int slot, unsigned int offset)
+{
+    glVertexAttribPointer(slot, 3, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)offset);
+}
+template<>
+void StreamAttribute<Vec4>::SetAttribPointer(unsigned int slot, unsigned int offset)
+{
+    glVertexAttribPointer(slot, 4, GL_FLOAT, GL_FALSE, 0, (void*)(size_t)offset);
+}
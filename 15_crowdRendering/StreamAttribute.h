@@ -0,0 +1,76 @@
+#ifndef STREAM_ATTRIBUTE_H_INCLUDED
+#define STREAM_ATTRIBUTE_H_INCLUDED
+
+#include <GL/glew.h>
+
+#define STREAM_ATTRIBUTE_SEGMENTS 3
+
+// Vertex attribute for data that is rewritten every frame (CPU skinning).
+// The buffer is a ring of three segments so the CPU can fill one while the
+// GPU still draws from the others; a fence guards each segment. With
+// ARB_buffer_storage the buffer stays persistently mapped, otherwise each
+// segment is mapped unsynchronized and the buffer is orphaned instead of
+// waiting when the GPU is behind. The buffer store is only reallocated
+// when the vertex count grows.
+template<typename T>
+class StreamAttribute
+{
+public:
+
+    StreamAttribute();
+    ~StreamAttribute();
+
+    // returns memory for length elements to be written this frame; it
+    // stays valid until Unmap, which must be called before drawing
+    T* Map(unsigned int length);
+    void Unmap();
+
+    // Map + copy + Unmap
+    void Set(const T* inputArray, unsigned int length);
+
+    // binds the most recently written segment
+    void BindTo(unsigned int slot);
+    void UnbindFrom(unsigned int slot);
+
+    unsigned int Count()     const { return count; }
+    unsigned int GetHandle() const { return id; }
+    bool IsPersistent()      const { return persistent; }
+
+    // counters since creation or the last ResetCounters
+    inline unsigned long long GetBytesUploaded() const { return bytesUploaded; }
+    inline unsigned int GetNumStalls()  const { return numStalls;  } // waits on a fence
+    inline unsigned int GetNumOrphans() const { return numOrphans; }
+    inline unsigned int GetNumReallocations() const { return numReallocations; }
+    void ResetCounters();
+
+protected:
+
+    unsigned int id;
+    unsigned int count;
+    unsigned int capacity; // elements per segment
+    unsigned int segment;  // segment being written or last written
+    bool persistent;
+    T* persistentData;
+    T* mapped;
+    GLsync fences[STREAM_ATTRIBUTE_SEGMENTS];
+
+    unsigned long long bytesUploaded;
+    unsigned int numStalls;
+    unsigned int numOrphans;
+    unsigned int numReallocations;
+
+    void Allocate(unsigned int newCapacity);
+    void Release();
+    void DeleteFences();
+    // returns false if the GPU is still using the segment and block is false
+    bool WaitForSegment(unsigned int index, bool block);
+    void SetAttribPointer(unsigned int slot, unsigned int offset);
+
+private:
+
+    // prevent copy/assignment
+    StreamAttribute(const StreamAttribute& other);
+    StreamAttribute& operator=(const StreamAttribute& other);
+};
+
+#endif // STREAM_ATTRIBUTE_H_INCLUDED
@@ -1,41 +1,302 @@
 #include <Texture.h>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <sys/stat.h>
 
+// the cache file is this header followed by every level
+struct TextureCacheHeader
+{
+    char magic[4];
+    unsigned int version;
+    unsigned int width;
+    unsigned int height;
+    unsigned int numChannels;
+    unsigned int numLevels;
+    // the source file the cache was built from
+    unsigned long long sourceSize;
+    long long sourceTime;
+};
+
+static const char sTextureCacheMagic[4] = { 'T', 'E', 'X', 'C' };
+
+static bool GetSourceInfo(const char* path, unsigned long long& size, long long& time)
+{
+    struct stat info;
+    if (stat(path, &info) != 0) {
+        return false;
+    }
+    size = (unsigned long long)info.st_size;
+    time = (long long)info.st_mtime;
+    return true;
+}
+
+static float MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count();
+}
+
+unsigned long long GetMipChainSize(unsigned int width, unsigned int height, unsigned int* outNumLevels)
+{
+    unsigned long long bytes = 0;
+    unsigned int numLevels = 0;
+    while (true) {
+        bytes += (unsigned long long)width * height * 4;
+        ++numLevels;
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    if (outNumLevels != nullptr) {
+        *outNumLevels = numLevels;
+    }
+    return bytes;
+}
+
+void BuildMipChain(unsigned char* chain, unsigned int width, unsigned int height)
+{
+    unsigned char* src = chain;
+    while (width > 1 || height > 1) {
+        unsigned int dstWidth = width > 1 ? width / 2 : 1;
+        unsigned int dstHeight = height > 1 ? height / 2 : 1;
+        unsigned char* dst = src + (size_t)width * height * 4;
+        for (unsigned int y = 0; y < dstHeight; ++y) {
+            // odd sizes drop the last row or column, like glGenerateMipmap
+            unsigned int y0 = y * 2;
+            unsigned int y1 = (y0 + 1 < height) ? y0 + 1 : y0;
+            for (unsigned int x = 0; x < dstWidth; ++x) {
+                unsigned int x0 = x * 2;
+                unsigned int x1 = (x0 + 1 < width) ? x0 + 1 : x0;
+                for (unsigned int c = 0; c < 4; ++c) {
+                    unsigned int sum = src[(y0 * width + x0) * 4 + c] +
+                                       src[(y0 * width + x1) * 4 + c] +
+                                       src[(y1 * width + x0) * 4 + c] +
+                                       src[(y1 * width + x1) * 4 + c];
+                    dst[(y * dstWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }
+        src = dst;
+        width = dstWidth;
+        height = dstHeight;
+    }
+}
 
 Texture::Texture()
 {
     width = 0;
     height = 0;
     numChannels = 0;
-    glGenTextures(1, &id);
+    numLevels = 0;
+    id = 0;
+    pixels = nullptr;
+    ownedPixels = nullptr;
+    memset(&stats, 0, sizeof(stats));
 }
 Texture::Texture(const char* path)
 {
-    glGenTextures(1, &id);
+    width = 0;
+    height = 0;
+    numChannels = 0;
+    numLevels = 0;
+    id = 0;
+    pixels = nullptr;
+    ownedPixels = nullptr;
+    memset(&stats, 0, sizeof(stats));
     Load(path);
 }
 Texture::~Texture()
 {
-    glDeleteTextures(1, &id);
+    ReleasePixels();
+    if (id != 0) {
+        glDeleteTextures(1, &id);
+    }
 }
 
 void Texture::Load(const char* path)
 {
-    glBindTexture(GL_TEXTURE_2D, id);
+    if (Decode(path)) {
+        Upload();
+    }
+}
+
+bool Texture::Decode(const char* path)
+{
+    ReleasePixels();
+    memset(&stats, 0, sizeof(stats));
+
+    std::string cachePath = path;
+    cachePath += TEXTURE_CACHE_EXTENSION;
+    if (LoadCache(path, cachePath)) {
+        return true;
+    }
+    if (!DecodeImage(path)) {
+        return false;
+    }
+    SaveCache(path, cachePath);
+    return true;
+}
+
+bool Texture::LoadCache(const char* path, const std::string& cachePath)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    if (!cache.Open(cachePath.c_str())) {
+        return false;
+    }
+
+    TextureCacheHeader header;
+    bool valid = cache.GetSize() >= sizeof(header);
+    if (valid) {
+        memcpy(&header, cache.GetData(), sizeof(header));
+        valid = memcmp(header.magic, sTextureCacheMagic, sizeof(header.magic)) == 0 &&
+                header.version == TEXTURE_CACHE_VERSION &&
+                header.width > 0 && header.height > 0;
+    }
+    unsigned int expectedLevels = 0;
+    unsigned long long bytes = 0;
+    if (valid) {
+        bytes = GetMipChainSize(header.width, header.height, &expectedLevels);
+        valid = header.numLevels == expectedLevels &&
+                cache.GetSize() == sizeof(header) + bytes;
+    }
+    // a cache without its source is trusted, so caches can ship alone
+    unsigned long long sourceSize;
+    long long sourceTime;
+    if (valid && GetSourceInfo(path, sourceSize, sourceTime)) {
+        valid = header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+    }
+    if (!valid) {
+        cache.Close();
+        return false;
+    }
+
+    width = header.width;
+    height = header.height;
+    numChannels = header.numChannels;
+    numLevels = header.numLevels;
+    pixels = cache.GetData() + sizeof(header);
+    stats.fromCache = true;
+    stats.numLevels = numLevels;
+    stats.bytes = bytes;
+    stats.cacheMs = MillisecondsSince(start);
+    return true;
+}
+
+bool Texture::DecodeImage(const char* path)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
     int tmpWidth, tmpHeight, tmpNumChannels;
     unsigned char* data = stbi_load(path, &tmpWidth, &tmpHeight, &tmpNumChannels, 4);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tmpWidth, tmpHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (data == nullptr) {
+        std::cerr << __func__ << ": failed to load " << path << ": "
+                  << stbi_failure_reason() << std::endl;
+        return false;
+    }
+
+    width = tmpWidth;
+    height = tmpHeight;
+    numChannels = tmpNumChannels;
+    unsigned long long bytes = GetMipChainSize(width, height, &numLevels);
+    ownedPixels = new unsigned char[bytes];
+    memcpy(ownedPixels, data, (size_t)width * height * 4);
     stbi_image_free(data);
+    BuildMipChain(ownedPixels, width, height);
+    pixels = ownedPixels;
+
+    stats.fromCache = false;
+    stats.numLevels = numLevels;
+    stats.bytes = bytes;
+    stats.decodeMs = MillisecondsSince(start);
+    return true;
+}
+
+void Texture::SaveCache(const char* path, const std::string& cachePath)
+{
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    TextureCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, sTextureCacheMagic, sizeof(header.magic));
+    header.version = TEXTURE_CACHE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.numChannels = numChannels;
+    header.numLevels = numLevels;
+    GetSourceInfo(path, header.sourceSize, header.sourceTime);
+
+    // written under a temporary name so a reader never maps half a file;
+    // the name is unique so threads saving the same cache don't share it
+    static std::atomic<unsigned int> sNumSaves(0);
+    std::ostringstream tmpName;
+    tmpName << cachePath << "." << std::this_thread::get_id() << "." << sNumSaves++ << ".tmp";
+    std::string tmpPath = tmpName.str();
+    std::ofstream file(tmpPath.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << __func__ << ": failed to open " << tmpPath << std::endl;
+        return;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)pixels, (std::streamsize)stats.bytes);
+    file.close();
+    if (!file) {
+        std::cerr << __func__ << ": failed to write " << tmpPath << std::endl;
+        remove(tmpPath.c_str());
+        return;
+    }
+    remove(cachePath.c_str());
+    if (rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        std::cerr << __func__ << ": failed to write " << cachePath << std::endl;
+        remove(tmpPath.c_str());
+        return;
+    }
+    stats.saveMs = MillisecondsSince(start);
+}
 
+void Texture::ReleasePixels()
+{
+    delete[] ownedPixels;
+    ownedPixels = nullptr;
+    cache.Close();
+    pixels = nullptr;
+}
+
+void Texture::Upload()
+{
+    if (pixels == nullptr) {
+        std::cerr << __func__ << ": no decoded image to upload" << std::endl;
+        return;
+    }
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    if (id == 0) {
+        glGenTextures(1, &id);
+    }
+
+    // the mipmaps were built when the image was decoded
+    glBindTexture(GL_TEXTURE_2D, id);
+    const unsigned char* level = pixels;
+    unsigned int levelWidth = width;
+    unsigned int levelHeight = height;
+    for (unsigned int i = 0; i < numLevels; ++i) {
+        glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, level);
+        level += (size_t)levelWidth * levelHeight * 4;
+        levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+        levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+    }
+    ReleasePixels();
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
-
-    width = tmpWidth;
-    height = tmpHeight;
-    numChannels = tmpNumChannels;
+    stats.uploadMs = MillisecondsSince(start);
 }
 
 void Texture::Set(unsigned int uniform, unsigned int texIndex)
@@ -51,3 +312,15 @@ void Texture::Unset(unsigned int texIndex)
     glActiveTexture(GL_TEXTURE0);
 }
 
+std::ostream& operator<<(std::ostream& os, const TextureLoadStats& stats)
+{
+    if (stats.fromCache) {
+        os << "cache hit, mapped in " << stats.cacheMs << " ms";
+    } else {
+        os << "cache miss, decoded in " << stats.decodeMs << " ms, "
+           << "cache written in " << stats.saveMs << " ms";
+    }
+    os << ", uploaded in " << stats.uploadMs << " ms, "
+       << stats.numLevels << " levels, " << stats.bytes << " bytes";
+    return os;
+}
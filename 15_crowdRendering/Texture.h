@@ -1,36 +1,87 @@
 #ifndef TEXTURE_H_INCLUDED
 #define TEXTURE_H_INCLUDED
 
-#include <GL/glew.h>
+#include <ostream>
+#include <string>
+
+#include <GLBackend.h>
 #include <stb_image.h>
+#include <MappedFile.h>
+
+// decoded images are cached next to the source as path + this
+#define TEXTURE_CACHE_EXTENSION ".texCache"
+#define TEXTURE_CACHE_VERSION   1
+
+// where the image came from and what each step cost, in milliseconds
+struct TextureLoadStats
+{
+    bool fromCache;
+    float cacheMs;    // mapping and validating the cache
+    float decodeMs;   // stb_image decode and mipmap generation on a miss
+    float saveMs;     // writing the cache on a miss
+    float uploadMs;
+    unsigned int numLevels;
+    unsigned long long bytes; // every level
+};
 
 class Texture
 {
 public:
-    
+
     Texture();
     Texture(const char* path);
     ~Texture();
 
+    // Decode + Upload
     void Load(const char* path);
+    // Reads the image and its mipmaps into CPU memory without a GL
+    // context, so it can run on a worker thread. The cache is mapped if
+    // it matches the source file; otherwise the image is decoded, its
+    // mipmaps are built and the cache is written for the next run.
+    bool Decode(const char* path);
+    // creates the GL texture on first use, uploads every decoded level
+    // and releases the CPU copy
+    void Upload();
+    inline bool IsDecoded() const { return pixels != nullptr; }
+
     void Set(unsigned int uniform, unsigned int texIndex);
     void Unset(unsigned int texIndex);
 
     unsigned int GetHandle() const { return id; }
+    inline const TextureLoadStats& GetLoadStats() const { return stats; }
 
 protected:
 
     unsigned int width;
     unsigned int height;
     unsigned int numChannels;
+    unsigned int numLevels;
     unsigned int id;
+    // every level, largest first, tightly packed RGBA8; points into
+    // cache when it was mapped, else owned
+    const unsigned char* pixels;
+    unsigned char* ownedPixels;
+    MappedFile cache;
+    TextureLoadStats stats;
+
+    bool LoadCache(const char* path, const std::string& cachePath);
+    bool DecodeImage(const char* path);
+    void SaveCache(const char* path, const std::string& cachePath);
+    void ReleasePixels();
 
 private:
-    
+
     // disallow copy/assignment
     Texture(const Texture&);
     Texture& operator=(const Texture&);
 };
 
-#endif // TEXTURE_H_INCLUDED
+// bytes of every level of a width x height RGBA8 image down to 1x1
+unsigned long long GetMipChainSize(unsigned int width, unsigned int height,
+                                   unsigned int* outNumLevels = nullptr);
+// box filters level 0 (already in chain) into the following levels
+void BuildMipChain(unsigned char* chain, unsigned int width, unsigned int height);
+
+std::ostream& operator<<(std::ostream& os, const TextureLoadStats& stats);
 
+#endif // TEXTURE_H_INCLUDED
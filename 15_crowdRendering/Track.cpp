@@ -1,4 +1,5 @@
 #include <Track.h>
+#include <TrackHelpers.h>
 #include <cstring>
 #include <iostream>
 
@@ -9,61 +10,22 @@ template class FastTrack<float, 1>;
 template class FastTrack<Vec3, 3>;
 template class FastTrack<Quat, 4>;
 
-namespace TrackHelpers
-{
-    // linear interpolation
-    inline float Interpolate(float a, float b, float t) {
-        return a + (b - a) * t;
-    }
-    inline Vec3 Interpolate(const Vec3& a, const Vec3& b, float t) {
-        return lerp(a, b, t);
-    }
-    inline Quat Interpolate(const Quat& a, const Quat& b, float t) {
-        Quat result = Mix(a, b, t);
-        // perform neighborhood check
-        if (dot(a, b) < 0) {
-            result = Mix(a, -b, t);
-        }
-        return normalized(result); // using nlerp
-    }
-
-    // normalization if necessary for each type specification
-    inline float AdjustHermiteResult(float f) {
-        return f;
-    }
-    inline Vec3 AdjustHermiteResult(const Vec3& v) {
-        return v;
-    }
-    inline Quat AdjustHermiteResult(const Quat& q) {
-        return normalized(q);
-    }
-
-    // neighborhooding if necessary for each type
-    inline void Neighborhood(const float& a, const float& b) {} // does nothing
-    inline void Neighborhood(const Vec3& a, const Vec3& b) {} // does nothing
-    inline void Neighborhood(const Quat& a, Quat& b) {
-        if (dot(a, b) < 0) {
-            b = -b;
-        }
-    }
-} // end TrackHelpers namespace
-
 template<typename T, int N>
 Track<T, N>::Track() {
     interpolation = Interpolation::Linear;
 }
 
 template<typename T, int N>
-inline float Track<T, N>::GetStartTime() {
+inline float Track<T, N>::GetStartTime() const {
     return frames[0].time;
 }
 template<typename T, int N>
-inline float Track<T, N>::GetEndTime() {
+inline float Track<T, N>::GetEndTime() const {
     return frames[frames.size()-1].time;
 }
 
 template<typename T, int N>
-T Track<T, N>::Sample(float time, bool looping)
+T Track<T, N>::Sample(float time, bool looping) const
 {
     if (interpolation == Interpolation::Constant) {
         return SampleConstant(time, looping);
@@ -78,18 +40,22 @@ template<typename T, int N>
 Frame<N>& Track<T,N>::operator[](unsigned int index) {
     return frames[index];
 }
+template<typename T, int N>
+const Frame<N>& Track<T,N>::operator[](unsigned int index) const {
+    return frames[index];
+}
 
 template<typename T, int N>
 inline void Track<T,N>::Resize(unsigned int size) {
     frames.resize(size);
 }
 template<typename T, int N>
-inline unsigned int Track<T,N>::GetSize() {
+inline unsigned int Track<T,N>::GetSize() const {
     return frames.size();
 }
 
 template<typename T, int N>
-inline Interpolation Track<T,N>::GetInterpolation() {
+inline Interpolation Track<T,N>::GetInterpolation() const {
     return interpolation;
 }
 template<typename T, int N>
@@ -99,24 +65,13 @@ inline void Track<T,N>::SetInterpolation(Interpolation interp) {
 
 
 template<typename T, int N>
-T Track<T,N>::Hermite(float t, const T& p1, const T& s1, const T& p2, const T& s2)
+T Track<T,N>::Hermite(float t, const T& p1, const T& s1, const T& p2, const T& s2) const
 {
-    float tt = t * t;
-    float ttt = tt * t;
-    T tmpP2 = p2;
-    TrackHelpers::Neighborhood(p1, tmpP2);
-
-    float h1 = 2.0f * ttt - 3.0f * tt + 1.0f;
-    float h2 = -2.0f * ttt + 3.0f * tt;
-    float h3 = ttt - 2.0f * tt + t;
-    float h4 = ttt - tt;
-
-    T result = p1 * h1 + tmpP2 * h2 + s1 * h3 + s2 * h4;
-    return TrackHelpers::AdjustHermiteResult(result);
+    return TrackHelpers::Hermite(t, p1, s1, p2, s2);
 }
 
 template<typename T, int N>
-int Track<T,N>::FrameIndex(float time, bool looping)
+int Track<T,N>::FrameIndex(float time, bool looping) const
 {
     // if the track has one frame or less, it is invalid
     unsigned int size = (unsigned int)frames.size();
@@ -158,7 +113,7 @@ int Track<T,N>::FrameIndex(float time, bool looping)
 }
 
 template<typename T, int N>
-float Track<T,N>::AdjustTimeToFitTrack(float t, bool loop) {
+float Track<T,N>::AdjustTimeToFitTrack(float t, bool loop) const {
     unsigned int size = (unsigned int)frames.size();
     if (size <= 1) {
         return 0.0f;
@@ -193,22 +148,22 @@ float Track<T,N>::AdjustTimeToFitTrack(float t, bool loop) {
 }
 
 template<>
-inline float Track<float, 1>::Cast(float* value) {
+inline float Track<float, 1>::Cast(const float* value) const {
     return value[0];
 }
 template<> 
-inline Vec3 Track<Vec3, 3>::Cast(float* value) {
+inline Vec3 Track<Vec3, 3>::Cast(const float* value) const {
     return Vec3(value[0], value[1], value[2]);
 }
 template<> 
-inline Quat Track<Quat, 4>::Cast(float* value) {
+inline Quat Track<Quat, 4>::Cast(const float* value) const {
     Quat q = Quat(value[0], value[1], value[2], value[3]);
     return normalized(q);
 }
 
 // no interpolation; results in immediate change in value (e.g. turn on/off)
 template<typename T, int N>
-T Track<T,N>::SampleConstant(float t, bool looping)
+T Track<T,N>::SampleConstant(float t, bool looping) const
 {
     int frame = FrameIndex(t, looping);
     if (frame < 0 || frame >= (int)frames.size()) {
@@ -221,12 +176,11 @@ T Track<T,N>::SampleConstant(float t, bool looping)
 
 // linearly interpolates between the current and next frame
 template<typename T, int N>
-T Track<T, N>::SampleLinear(float time, bool looping) 
+T Track<T, N>::SampleLinear(float time, bool looping) const
 {
     int thisFrame = FrameIndex(time, looping);
     if (thisFrame < 0 || thisFrame >= frames.size() - 1) {
-        // TODO error
-        std::cout << "Sample linear this frame error, returning default" << std::endl;
+        // no logging here; sampling runs on many threads at once
         return T();
     }
 
@@ -235,7 +189,6 @@ T Track<T, N>::SampleLinear(float time, bool looping)
     float thisTime = frames[thisFrame].time;
     float frameDelta = frames[nextFrame].time - thisTime;
     if (frameDelta <= 0.0f) {
-        std::cout << "Frame default < 0, returning default" << std::endl;
         return T();
     }
 
@@ -247,7 +200,7 @@ T Track<T, N>::SampleLinear(float time, bool looping)
 
 // Cubic track sampling using Hermite
 template<typename T, int N>
-T Track<T,N>::SampleCubic(float time, bool looping)
+T Track<T,N>::SampleCubic(float time, bool looping) const
 {
     int thisFrame = FrameIndex(time, looping);
     if (thisFrame < 0 || thisFrame >= frames.size() - 1) {
@@ -315,7 +268,7 @@ void FastTrack<T,N>::UpdateIndexLookupTable()
 }
 
 template<typename T, int N>
-int FastTrack<T,N>::FrameIndex(float time, bool loop)
+int FastTrack<T,N>::FrameIndex(float time, bool loop) const
 {
     unsigned int size = this->frames.size();
     if (size <= 1) {
@@ -8,7 +8,9 @@
 #include <Frame.h>
 #include <Interpolation.h>
 
-// a track is a collection of frames which can be interpolated between
+// a track is a collection of frames which can be interpolated between;
+// the const functions don't modify the track, so one track can be
+// sampled from many threads at once
 template<typename T, int N>
 class Track
 {
@@ -16,33 +18,34 @@ public:
     Track();
 
     void Resize(unsigned int size);
-    unsigned int GetSize();
-    Interpolation GetInterpolation();
+    unsigned int GetSize() const;
+    Interpolation GetInterpolation() const;
     void SetInterpolation(Interpolation interp);
-    float GetStartTime();
-    float GetEndTime();
+    float GetStartTime() const;
+    float GetEndTime() const;
 
-    T Sample(float time, bool looping);
+    T Sample(float time, bool looping) const;
     Frame<N>& operator[](unsigned int index);
+    const Frame<N>& operator[](unsigned int index) const;
 
-    T Hermite(float time, const T& p1, const T& s1, const T& p2, const T& s2);
+    T Hermite(float time, const T& p1, const T& s1, const T& p2, const T& s2) const;
     
     // returns the last frame before the requested time
-    virtual int FrameIndex(float time, bool looping);
+    virtual int FrameIndex(float time, bool looping) const;
 
     // maps time to within input range
-    float AdjustTimeToFitTrack(float t, bool loop);
+    float AdjustTimeToFitTrack(float t, bool loop) const;
 
     // will be specialized based on template implementation
-    T Cast(float* value);
+    T Cast(const float* value) const;
 
 protected:
     std::vector<Frame<N>> frames;
     Interpolation interpolation;
 
-    T SampleConstant(float time, bool looping);
-    T SampleLinear(float time, bool looping);
-    T SampleCubic(float time, bool looping);
+    T SampleConstant(float time, bool looping) const;
+    T SampleLinear(float time, bool looping) const;
+    T SampleCubic(float time, bool looping) const;
 
 };
 
@@ -53,7 +56,7 @@ class FastTrack : public Track<T,N>
 protected:
     std::vector<unsigned int> sampledFrames;
 public:
-    virtual int FrameIndex(float time, bool looping);
+    virtual int FrameIndex(float time, bool looping) const;
     void UpdateIndexLookupTable();
 };
 
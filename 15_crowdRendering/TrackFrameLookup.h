@@ -0,0 +1,139 @@
+#ifndef TRACK_FRAME_LOOKUP_H_INCLUDED
+#define TRACK_FRAME_LOOKUP_H_INCLUDED
+
+#include <vector>
+#include <cmath>
+
+// where a time falls on a track; found once per time array and shared
+// by every track keyed at those times
+struct TrackCursor
+{
+    unsigned int frame; // the segment starts at this frame
+    float t;            // 0..1 within the segment
+    float frameDelta;   // seconds from frame to frame + 1
+};
+
+// The key times of one or more tracks and the table that finds a
+// segment for a time. glTF samplers usually share a time accessor across
+// channels, so TypedClip keeps one lookup per distinct time array and
+// finds the cursor once for all of the tracks that use it.
+class TrackFrameLookup
+{
+public:
+    inline TrackFrameLookup() { samplesPerSecond = 0.0f; }
+
+    // times must be sorted; builds the same 60 per second table as FastTrack
+    void Set(const std::vector<float>& inTimes);
+
+    inline const std::vector<float>& GetTimes() const { return times; }
+    inline unsigned int GetSize() const { return (unsigned int)times.size(); }
+    inline float GetStartTime() const   { return times[0]; }
+    inline float GetEndTime() const     { return times[times.size() - 1]; }
+
+    // maps time to within the track, like Track::AdjustTimeToFitTrack
+    float FitTime(float time, bool looping) const;
+    // returns the last frame at or before time, at most size - 2; time
+    // must already be fit to the track
+    unsigned int FrameIndex(float time) const;
+    // FitTime and FrameIndex; needs at least two times
+    TrackCursor Find(float time, bool looping) const;
+
+protected:
+    std::vector<float> times;
+    // 1 / (times[i + 1] - times[i]), 0 for empty segments
+    std::vector<float> invFrameDeltas;
+    // first frame of each sample
+    std::vector<unsigned int> sampledFrames;
+    float samplesPerSecond; // numSamples - 1 over the duration
+};
+
+inline void TrackFrameLookup::Set(const std::vector<float>& inTimes)
+{
+    times = inTimes;
+    sampledFrames.clear();
+    samplesPerSecond = 0.0f;
+    unsigned int numFrames = (unsigned int)times.size();
+    invFrameDeltas.resize(numFrames > 1 ? numFrames - 1 : 0);
+    for (unsigned int i = 0; i + 1 < numFrames; ++i) {
+        float frameDelta = times[i + 1] - times[i];
+        invFrameDeltas[i] = frameDelta > 0.0f ? 1.0f / frameDelta : 0.0f;
+    }
+    float duration = numFrames > 1 ? GetEndTime() - GetStartTime() : 0.0f;
+    if (duration <= 0.0f) {
+        return;
+    }
+
+    // assumes 60 frames per second is enough
+    unsigned int numSamples = (unsigned int)(duration * 60.0f);
+    if (numSamples < 2) {
+        numSamples = 2;
+    }
+    sampledFrames.resize(numSamples);
+    samplesPerSecond = (float)(numSamples - 1) / duration;
+    unsigned int frameIndex = 0;
+    for (unsigned int i = 0; i < numSamples; ++i) {
+        float time = GetStartTime() + (float)i / samplesPerSecond;
+        while (frameIndex + 2 < numFrames && time >= times[frameIndex + 1]) {
+            ++frameIndex;
+        }
+        sampledFrames[i] = frameIndex;
+    }
+}
+
+inline float TrackFrameLookup::FitTime(float time, bool looping) const
+{
+    float startTime = times[0];
+    float endTime = times[times.size() - 1];
+    float duration = endTime - startTime;
+    if (looping) {
+        if (duration > 0.0f) {
+            time = fmodf(time - startTime, duration);
+            if (time < 0.0f) {
+                time += duration;
+            }
+            time = time + startTime;
+        }
+    } else {
+        if (time <= startTime) {
+            time = startTime;
+        }
+        if (time >= endTime) {
+            time = endTime;
+        }
+    }
+    return time;
+}
+
+inline unsigned int TrackFrameLookup::FrameIndex(float time) const
+{
+    unsigned int size = (unsigned int)times.size();
+    unsigned int index = 0;
+    if (!sampledFrames.empty()) {
+        unsigned int sample = (unsigned int)((time - times[0]) * samplesPerSecond);
+        if (sample >= sampledFrames.size()) {
+            sample = (unsigned int)sampledFrames.size() - 1;
+        }
+        index = sampledFrames[sample];
+    }
+    // the table can be a frame off between samples
+    while (index + 2 < size && time >= times[index + 1]) {
+        ++index;
+    }
+    while (index > 0 && time < times[index]) {
+        --index;
+    }
+    return index;
+}
+
+inline TrackCursor TrackFrameLookup::Find(float time, bool looping) const
+{
+    TrackCursor cursor;
+    time = FitTime(time, looping);
+    cursor.frame = FrameIndex(time);
+    float thisTime = times[cursor.frame];
+    cursor.frameDelta = times[cursor.frame + 1] - thisTime;
+    cursor.t = (time - thisTime) * invFrameDeltas[cursor.frame];
+    return cursor;
+}
+
+#endif // TRACK_FRAME_LOOKUP_H_INCLUDED
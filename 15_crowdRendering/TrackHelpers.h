@@ -0,0 +1,99 @@
+#ifndef TRACK_HELPERS_H_INCLUDED
+#define TRACK_HELPERS_H_INCLUDED
+
+#include <Vec3.h>
+#include <Quat.h>
+
+// per type helpers shared by Track and TypedTrack
+namespace TrackHelpers
+{
+    // linear interpolation
+    inline float Interpolate(float a, float b, float t) {
+        return a + (b - a) * t;
+    }
+    inline Vec3 Interpolate(const Vec3& a, const Vec3& b, float t) {
+        return lerp(a, b, t);
+    }
+    inline Quat Interpolate(const Quat& a, const Quat& b, float t) {
+        Quat result = Mix(a, b, t);
+        // perform neighborhood check
+        if (dot(a, b) < 0) {
+            result = Mix(a, -b, t);
+        }
+        return normalized(result); // using nlerp
+    }
+
+    // normalization if necessary for each type specification
+    inline float AdjustHermiteResult(float f) {
+        return f;
+    }
+    inline Vec3 AdjustHermiteResult(const Vec3& v) {
+        return v;
+    }
+    inline Quat AdjustHermiteResult(const Quat& q) {
+        return normalized(q);
+    }
+
+    // neighborhooding if necessary for each type
+    inline void Neighborhood(const float& a, const float& b) {} // does nothing
+    inline void Neighborhood(const Vec3& a, const Vec3& b) {} // does nothing
+    inline void Neighborhood(const Quat& a, Quat& b) {
+        if (dot(a, b) < 0) {
+            b = -b;
+        }
+    }
+
+    template<typename T>
+    inline T Hermite(float t, const T& p1, const T& s1, const T& p2, const T& s2)
+    {
+        float tt = t * t;
+        float ttt = tt * t;
+        T tmpP2 = p2;
+        Neighborhood(p1, tmpP2);
+
+        float h1 = 2.0f * ttt - 3.0f * tt + 1.0f;
+        float h2 = -2.0f * ttt + 3.0f * tt;
+        float h3 = ttt - 2.0f * tt + t;
+        float h4 = ttt - tt;
+
+        T result = p1 * h1 + tmpP2 * h2 + s1 * h3 + s2 * h4;
+        return AdjustHermiteResult(result);
+    }
+
+    // frame values to T, like Track::Cast; rotations are normalized
+    template<typename T> T Cast(const float* value);
+    template<> inline float Cast<float>(const float* value) {
+        return value[0];
+    }
+    template<> inline Vec3 Cast<Vec3>(const float* value) {
+        return Vec3(value[0], value[1], value[2]);
+    }
+    template<> inline Quat Cast<Quat>(const float* value) {
+        return normalized(Quat(value[0], value[1], value[2], value[3]));
+    }
+
+    // tangents are read as is, never normalized
+    template<typename T> T CastTangent(const float* value);
+    template<> inline float CastTangent<float>(const float* value) {
+        return value[0];
+    }
+    template<> inline Vec3 CastTangent<Vec3>(const float* value) {
+        return Vec3(value[0], value[1], value[2]);
+    }
+    template<> inline Quat CastTangent<Quat>(const float* value) {
+        return Quat(value[0], value[1], value[2], value[3]);
+    }
+
+    // T to its components, the inverse of CastTangent
+    inline void Store(float f, float* out) {
+        out[0] = f;
+    }
+    inline void Store(const Vec3& v, float* out) {
+        out[0] = v.x; out[1] = v.y; out[2] = v.z;
+    }
+    inline void Store(const Quat& q, float* out) {
+        out[0] = q.x; out[1] = q.y; out[2] = q.z; out[3] = q.w;
+    }
+} // end TrackHelpers namespace
+
+#endif // TRACK_HELPERS_H_INCLUDED
@@ -12,7 +12,7 @@ TTransformTrack<VTRACK,QTRACK>::TTransformTrack()
 }
 
 template<typename VTRACK, typename QTRACK>
-bool TTransformTrack<VTRACK,QTRACK>::IsValid()
+bool TTransformTrack<VTRACK,QTRACK>::IsValid() const
 {
     return (position.GetSize() > 1 ||
            rotation.GetSize() > 1 ||
@@ -21,7 +21,7 @@ bool TTransformTrack<VTRACK,QTRACK>::IsValid()
 
 // returns the smallest start time of the 3 tracks
 template<typename VTRACK, typename QTRACK>
-float TTransformTrack<VTRACK,QTRACK>::GetStartTime()
+float TTransformTrack<VTRACK,QTRACK>::GetStartTime() const
 {
     float result = 0.0f;
     bool isSet = false;
@@ -51,7 +51,7 @@ float TTransformTrack<VTRACK,QTRACK>::GetStartTime()
 
 // returns the largest end time of the 3 tracks
 template<typename VTRACK, typename QTRACK>
-float TTransformTrack<VTRACK,QTRACK>::GetEndTime()
+float TTransformTrack<VTRACK,QTRACK>::GetEndTime() const
 {
     float result = 0.0f;
     bool isSet = false;
@@ -79,7 +79,7 @@ float TTransformTrack<VTRACK,QTRACK>::GetEndTime()
 }
 
 template<typename VTRACK, typename QTRACK>
-Transform TTransformTrack<VTRACK,QTRACK>::Sample(const Transform& ref, float time, bool looping)
+Transform TTransformTrack<VTRACK,QTRACK>::Sample(const Transform& ref, float time, bool looping) const
 {
     Transform result = ref; // default values
     if (position.GetSize() > 1) {
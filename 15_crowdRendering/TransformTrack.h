@@ -16,12 +16,15 @@ public:
     VTRACK& GetPositionTrack() { return position; }
     QTRACK& GetRotationTrack() { return rotation; }
     VTRACK& GetScaleTrack()    { return scale; }
+    const VTRACK& GetPositionTrack() const { return position; }
+    const QTRACK& GetRotationTrack() const { return rotation; }
+    const VTRACK& GetScaleTrack() const    { return scale; }
 
-    float GetStartTime();
-    float GetEndTime();
-    bool IsValid(); // true if any of the three tracks are valid
+    float GetStartTime() const;
+    float GetEndTime() const;
+    bool IsValid() const; // true if any of the three tracks are valid
 
-    Transform Sample(const Transform& ref, float time, bool looping);
+    Transform Sample(const Transform& ref, float time, bool looping) const;
 
 protected:
     unsigned int id; // bone/joint id this track is used for
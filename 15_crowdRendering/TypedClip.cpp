@@ -0,0 +1,244 @@
+#include <TypedClip.h>
+#include <TypedTrack.h>
+#include <PolynomialTrack.h>
+#include <cmath>
+
+enum class TrackTarget
+{
+    Position,
+    Rotation,
+    Scale
+};
+
+// writes a sampled value into its component of a transform
+template<TrackTarget TARGET>
+struct TrackTargetField;
+
+template<>
+struct TrackTargetField<TrackTarget::Position>
+{
+    static inline void Set(Transform& transform, const Vec3& value) { transform.position = value; }
+};
+template<>
+struct TrackTargetField<TrackTarget::Rotation>
+{
+    static inline void Set(Transform& transform, const Quat& value) { transform.rotation = value; }
+};
+template<>
+struct TrackTargetField<TrackTarget::Scale>
+{
+    static inline void Set(Transform& transform, const Vec3& value) { transform.scale = value; }
+};
+
+class TypedTrackGroup
+{
+public:
+    virtual ~TypedTrackGroup() {}
+    // cursors holds one cursor per timeline of the clip
+    virtual void Sample(Pose& outPose, const TrackCursor* cursors) const = 0;
+    virtual unsigned int GetSize() const = 0;
+};
+
+// TRACK is a TypedTrack or a PolynomialTrack
+template<typename TRACK, TrackTarget TARGET>
+class TTypedTrackGroup : public TypedTrackGroup
+{
+public:
+
+    template<typename T, int N>
+    void Add(unsigned int joint, unsigned int timeline, const Track<T, N>& input) {
+        joints.push_back(joint);
+        timelines.push_back(timeline);
+        tracks.push_back(TRACK());
+        tracks.back().Set(input);
+    }
+
+    virtual unsigned int GetSize() const { return (unsigned int)tracks.size(); }
+
+    virtual void Sample(Pose& outPose, const TrackCursor* cursors) const {
+        unsigned int size = (unsigned int)tracks.size();
+        for (unsigned int i = 0; i < size; ++i) {
+            unsigned int j = joints[i];
+            Transform local = outPose.GetLocalTransform(j);
+            TrackTargetField<TARGET>::Set(local, tracks[i].Sample(cursors[timelines[i]]));
+            outPose.SetLocalTransform(j, local);
+        }
+    }
+
+protected:
+
+    std::vector<unsigned int> joints;
+    std::vector<unsigned int> timelines; // index into TypedClip::timelines
+    std::vector<TRACK> tracks;
+};
+
+template<typename TRACK, Interpolation I, TrackTarget TARGET, typename T, int N>
+static void AddToGroup(TypedTrackGroup** groups, unsigned int joint, unsigned int timeline,
+                       const Track<T, N>& input)
+{
+    typedef TTypedTrackGroup<TRACK, TARGET> Group;
+    TypedTrackGroup*& group = groups[(int)TARGET * 3 + (int)I];
+    if (group == nullptr) {
+        group = new Group();
+    }
+    ((Group*)group)->Add(joint, timeline, input);
+}
+
+// returns the index of the timeline with the track's key times, adding
+// one if no other track had them
+template<typename T, int N>
+static unsigned int FindTimeline(std::vector<TrackFrameLookup>& timelines, const Track<T, N>& input)
+{
+    unsigned int size = input.GetSize();
+    std::vector<float> times(size);
+    for (unsigned int i = 0; i < size; ++i) {
+        times[i] = input[i].time;
+    }
+    for (unsigned int i = 0, numTimelines = (unsigned int)timelines.size(); i < numTimelines; ++i) {
+        if (timelines[i].GetTimes() == times) {
+            return i;
+        }
+    }
+    timelines.push_back(TrackFrameLookup());
+    timelines.back().Set(times);
+    return (unsigned int)timelines.size() - 1;
+}
+
+// the only runtime interpolation switch, once per track when the clip is set
+template<TrackTarget TARGET, typename T, int N>
+static void AddTrack(TypedTrackGroup** groups, std::vector<TrackFrameLookup>& timelines,
+                     unsigned int joint, const Track<T, N>& input, bool cubicToPolynomial)
+{
+    if (input.GetSize() <= 1) {
+        return;
+    }
+    unsigned int timeline = FindTimeline(timelines, input);
+    switch (input.GetInterpolation()) {
+        case Interpolation::Constant:
+            AddToGroup<TypedTrack<T, N, Interpolation::Constant>, Interpolation::Constant, TARGET>(groups, joint, timeline, input);
+            break;
+        case Interpolation::Linear:
+            AddToGroup<TypedTrack<T, N, Interpolation::Linear>, Interpolation::Linear, TARGET>(groups, joint, timeline, input);
+            break;
+        case Interpolation::Cubic:
+            // a clip holds one or the other, so they share a group
+            if (cubicToPolynomial) {
+                AddToGroup<PolynomialTrack<T, N>, Interpolation::Cubic, TARGET>(groups, joint, timeline, input);
+            } else {
+                AddToGroup<TypedTrack<T, N, Interpolation::Cubic>, Interpolation::Cubic, TARGET>(groups, joint, timeline, input);
+            }
+            break;
+    }
+}
+
+TypedClip::TypedClip()
+{
+    for (unsigned int i = 0; i < TYPED_CLIP_NUM_GROUPS; ++i) {
+        groups[i] = nullptr;
+    }
+    name = "No name given";
+    startTime = 0.0f;
+    endTime = 0.0f;
+    looping = true;
+}
+
+TypedClip::~TypedClip()
+{
+    Clear();
+}
+
+void TypedClip::Clear()
+{
+    for (unsigned int i = 0; i < TYPED_CLIP_NUM_GROUPS; ++i) {
+        delete groups[i];
+        groups[i] = nullptr;
+    }
+    timelines.clear();
+}
+
+void TypedClip::Set(const Clip& input, bool cubicToPolynomial)
+{
+    Clear();
+    unsigned int size = input.GetSize();
+    for (unsigned int i = 0; i < size; ++i) {
+        unsigned int joint = input.GetIdAtIndex(i);
+        const TransformTrack& track = input.GetTrackAtIndex(i);
+        AddTrack<TrackTarget::Position>(groups, timelines, joint, track.GetPositionTrack(), cubicToPolynomial);
+        AddTrack<TrackTarget::Rotation>(groups, timelines, joint, track.GetRotationTrack(), cubicToPolynomial);
+        AddTrack<TrackTarget::Scale>(groups, timelines, joint, track.GetScaleTrack(), cubicToPolynomial);
+    }
+    name = input.GetName();
+    startTime = input.GetStartTime();
+    endTime = input.GetEndTime();
+    looping = input.GetLooping();
+}
+
+float TypedClip::Sample(Pose& outPose, float inTime) const
+{
+    if (GetDuration() == 0.0f) {
+        return 0.0f;
+    }
+
+    inTime = AdjustTimeToFitRange(inTime);
+
+    // one search per distinct time array, shared by all of its tracks;
+    // per thread so a clip can be sampled from several threads at once
+    static thread_local std::vector<TrackCursor> cursors;
+    unsigned int numTimelines = (unsigned int)timelines.size();
+    if (numTimelines == 0) {
+        // no track has more than one key, so there are no groups either
+        return inTime;
+    }
+    if (cursors.size() < numTimelines) {
+        cursors.resize(numTimelines);
+    }
+    for (unsigned int i = 0; i < numTimelines; ++i) {
+        cursors[i] = timelines[i].Find(inTime, looping);
+    }
+
+    for (unsigned int i = 0; i < TYPED_CLIP_NUM_GROUPS; ++i) {
+        if (groups[i] != nullptr) {
+            groups[i]->Sample(outPose, &cursors[0]);
+        }
+    }
+    return inTime;
+}
+
+unsigned int TypedClip::GetNumTracks() const
+{
+    unsigned int result = 0;
+    for (unsigned int i = 0; i < TYPED_CLIP_NUM_GROUPS; ++i) {
+        if (groups[i] != nullptr) {
+            result += groups[i]->GetSize();
+        }
+    }
+    return result;
+}
+
+float TypedClip::AdjustTimeToFitRange(float inTime) const
+{
+    // modulate between start and end
+    if (looping) {
+        float duration = endTime - startTime;
+        if (duration <= 0.0f) {
+            return 0.0f;
+        }
+
+        inTime = fmodf(inTime - startTime, duration);
+        if (inTime < 0.0f) {
+            inTime += duration;
+        }
+        inTime = inTime + startTime;
+
+    // clamp between start and end
+    } else {
+        if (inTime < startTime) {
+            inTime = startTime;
+        }
+        if (inTime > endTime) {
+            inTime = endTime;
+        }
+    }
+
+    return inTime;
+}
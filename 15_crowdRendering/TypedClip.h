@@ -0,0 +1,71 @@
+#ifndef TYPED_CLIP_H_INCLUDED
+#define TYPED_CLIP_H_INCLUDED
+
+#include <string>
+#include <Clip.h>
+#include <Pose.h>
+#include <TrackFrameLookup.h>
+
+// position, rotation and scale times the three interpolation modes
+#define TYPED_CLIP_NUM_GROUPS 9
+
+// the tracks of one (target, interpolation) pair; defined in TypedClip.cpp
+class TypedTrackGroup;
+
+// A clip whose tracks are grouped by the transform component they animate
+// and their interpolation, which together fix the value type. Sampling
+// makes one virtual call per group; inside a group every track has the
+// same track type, so the loop has no per track dispatch. Tracks keyed
+// at the same times share one TrackFrameLookup, a timeline, so each
+// distinct time array is searched once per sample. Produces the same
+// poses as Clip::Sample to rounding: segment times are scaled by a
+// reciprocal precomputed per key, where Clip::Sample divides.
+class TypedClip
+{
+public:
+
+    TypedClip();
+    ~TypedClip();
+
+    // replaces the tracks with copies of input's; tracks with fewer than
+    // two frames are skipped, as Clip::Sample skips them. Cubic tracks
+    // are converted to PolynomialTrack unless cubicToPolynomial is false,
+    // which keeps Clip::Sample's Hermite evaluation.
+    void Set(const Clip& input, bool cubicToPolynomial = true);
+    void Clear();
+
+    // fills in outPose and returns the adjusted time for that pose
+    float Sample(Pose& outPose, float inTime) const;
+
+    unsigned int GetNumTracks() const;
+    inline unsigned int GetNumTimelines() const { return (unsigned int)timelines.size(); }
+
+    inline const std::string& GetName() const    { return name;                }
+    inline float              GetDuration() const  { return endTime - startTime; }
+    inline float              GetStartTime() const { return startTime;           }
+    inline float              GetEndTime() const   { return endTime;             }
+    inline bool               GetLooping() const   { return looping;             }
+    inline void               SetLooping(bool inLooping) { looping = inLooping;  }
+
+protected:
+
+    // null for pairs the clip doesn't use
+    TypedTrackGroup* groups[TYPED_CLIP_NUM_GROUPS];
+    // the distinct key time arrays of the tracks
+    std::vector<TrackFrameLookup> timelines;
+    std::string name;
+
+    float startTime;
+    float endTime;
+    bool looping;
+
+    float AdjustTimeToFitRange(float inTime) const;
+
+private:
+
+    // disallow copy/assignment
+    TypedClip(const TypedClip&);
+    TypedClip& operator=(const TypedClip&);
+};
+
+#endif // TYPED_CLIP_H_INCLUDED
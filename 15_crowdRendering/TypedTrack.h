@@ -0,0 +1,87 @@
+#ifndef TYPED_TRACK_H_INCLUDED
+#define TYPED_TRACK_H_INCLUDED
+
+#include <vector>
+
+#include <Vec3.h>
+#include <Quat.h>
+#include <Frame.h>
+#include <Interpolation.h>
+#include <Track.h>
+#include <TrackHelpers.h>
+#include <TrackFrameLookup.h>
+
+// interpolates between two neighboring frames; one specialization per
+// interpolation mode so the choice is made at compile time
+template<typename T, int N, Interpolation I>
+struct TrackSampler;
+
+template<typename T, int N>
+struct TrackSampler<T, N, Interpolation::Constant>
+{
+    static inline T Sample(const Frame<N>& thisFrame, const Frame<N>&, const TrackCursor&) {
+        return TrackHelpers::Cast<T>(thisFrame.value);
+    }
+};
+
+template<typename T, int N>
+struct TrackSampler<T, N, Interpolation::Linear>
+{
+    static inline T Sample(const Frame<N>& thisFrame, const Frame<N>& nextFrame, const TrackCursor& cursor) {
+        if (cursor.frameDelta <= 0.0f) {
+            return T();
+        }
+        return TrackHelpers::Interpolate(TrackHelpers::Cast<T>(thisFrame.value),
+                                         TrackHelpers::Cast<T>(nextFrame.value), cursor.t);
+    }
+};
+
+template<typename T, int N>
+struct TrackSampler<T, N, Interpolation::Cubic>
+{
+    static inline T Sample(const Frame<N>& thisFrame, const Frame<N>& nextFrame, const TrackCursor& cursor) {
+        if (cursor.frameDelta <= 0.0f) {
+            return T();
+        }
+        // tangents are read straight from the frames, no memcpy
+        T slope1 = TrackHelpers::CastTangent<T>(thisFrame.out) * cursor.frameDelta;
+        T slope2 = TrackHelpers::CastTangent<T>(nextFrame.in) * cursor.frameDelta;
+        return TrackHelpers::Hermite(cursor.t, TrackHelpers::Cast<T>(thisFrame.value), slope1,
+                                     TrackHelpers::Cast<T>(nextFrame.value), slope2);
+    }
+};
+
+// A track with its interpolation fixed by the type. Track::Sample checks
+// the interpolation on every call; this one compiles to a single path
+// that inlines into the caller's loop. The frame is found by the
+// TrackFrameLookup of the track's key times, which tracks keyed at the
+// same times share. Same results as Track::Sample.
+template<typename T, int N, Interpolation I>
+class TypedTrack
+{
+public:
+    inline unsigned int GetSize() const { return (unsigned int)frames.size(); }
+
+    // copies the frames; input must already use interpolation I
+    void Set(const Track<T, N>& input);
+
+    // cursor is from the lookup of this track's key times
+    inline T Sample(const TrackCursor& cursor) const {
+        return TrackSampler<T, N, I>::Sample(frames[cursor.frame], frames[cursor.frame + 1], cursor);
+    }
+
+protected:
+    std::vector<Frame<N>> frames;
+};
+
+template<typename T, int N, Interpolation I>
+void TypedTrack<T, N, I>::Set(const Track<T, N>& input)
+{
+    unsigned int size = input.GetSize();
+    frames.resize(size);
+    for (unsigned int i = 0; i < size; ++i) {
+        frames[i] = input[i];
+    }
+}
+
+#endif // TYPED_TRACK_H_INCLUDED
@@ -9,6 +9,7 @@ template class Uniform<iVec2>;
 template class Uniform<iVec4>;
 template class Uniform<Quat>;
 template class Uniform<Mat4>;
+template class Uniform<Affine3x4>;
 template class Uniform<DualQuaternion>;
 
 template<typename T>
@@ -49,6 +50,13 @@ void Uniform<Mat4>::Set(unsigned int slot, const Mat4* data, unsigned int length
     glUniformMatrix4fv(slot, (GLsizei)length, false, (float*)&data[0]);
 }
 
+// three rows per matrix; declared as mat3x4 in the shader
+template<>
+void Uniform<Affine3x4>::Set(unsigned int slot, const Affine3x4* data, unsigned int length)
+{
+    glUniformMatrix3x4fv(slot, (GLsizei)length, false, (float*)&data[0]);
+}
+
 template<>
 void Uniform<DualQuaternion>::Set(unsigned int slot, const DualQuaternion* data, unsigned int length)
 {
@@ -9,6 +9,7 @@
 #include <Vec3.h>
 #include <Vec4.h>
 #include <Mat4.h>
+#include <Affine3x4.h>
 #include <Quat.h>
 #include <DualQuaternion.h>
 
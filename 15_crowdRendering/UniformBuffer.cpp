@@ -0,0 +1,58 @@
+#include <UniformBuffer.h>
+#include <iostream>
+
+UniformBuffer::UniformBuffer()
+{
+    id = 0;
+    size = 0;
+    bytesUploaded = 0;
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    if (id != 0) {
+        glDeleteBuffers(1, &id);
+    }
+}
+
+void UniformBuffer::Set(const void* data, unsigned int bytes)
+{
+    if (id == 0) {
+        glGenBuffers(1, &id);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, id);
+    if (bytes != size) {
+        glBufferData(GL_UNIFORM_BUFFER, bytes, data, GL_DYNAMIC_DRAW);
+        size = bytes;
+    } else {
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, bytes, data);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    bytesUploaded += bytes;
+}
+
+void UniformBuffer::BindTo(unsigned int index)
+{
+    if (id == 0) {
+        std::cout << __func__ << ": uniform buffer was never set" << std::endl;
+        return;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, index, id);
+}
+
+void SetSkeletonBlock(UniformBuffer& buffer, Skeleton& skeleton)
+{
+    std::vector<Mat4>& invBindPose = skeleton.GetInvBindPose();
+    unsigned int numJoints = (unsigned int)invBindPose.size();
+    if (numJoints > UNIFORM_BUFFER_MAX_BONES) {
+        std::cout << __func__ << ": " << numJoints << " joints, only "
+                  << UNIFORM_BUFFER_MAX_BONES << " fit the block" << std::endl;
+        numJoints = UNIFORM_BUFFER_MAX_BONES;
+    }
+
+    SkeletonUniformBlock block;
+    for (unsigned int i = 0; i < numJoints; ++i) {
+        block.invBindPose[i] = mat4ToAffine(invBindPose[i]);
+    }
+    buffer.Set(block);
+}
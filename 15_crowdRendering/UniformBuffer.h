@@ -0,0 +1,64 @@
+#ifndef UNIFORM_BUFFER_H_INCLUDED
+#define UNIFORM_BUFFER_H_INCLUDED
+
+#include <GL/glew.h>
+
+#include <Vec4.h>
+#include <Mat4.h>
+#include <Affine3x4.h>
+#include <Skeleton.h>
+
+#define UNIFORM_BUFFER_MAX_BONES 60
+
+// std140 layout of the FrameData block; uploaded once per frame and
+// shared by every shader
+struct FrameUniformBlock
+{
+    Mat4 view;
+    Mat4 projection;
+    Vec4 light; // xyz direction
+};
+
+// std140 layout of the SkeletonData block; constant for a skeleton, so
+// it's uploaded once when the skeleton is loaded. Rows only: a mat3x4
+// array is three vec4s per element in std140, a quarter less than mat4
+struct SkeletonUniformBlock
+{
+    Affine3x4 invBindPose[UNIFORM_BUFFER_MAX_BONES];
+};
+
+// Buffer backing a uniform block. Shaders find it by binding index
+// (see SHADER_BLOCK_* in Shader.h) instead of one glUniform call per value.
+class UniformBuffer
+{
+public:
+
+    UniformBuffer();
+    ~UniformBuffer();
+
+    // the GL buffer is created on the first Set
+    void Set(const void* data, unsigned int bytes);
+    template<typename T>
+    void Set(const T& block) { Set(&block, sizeof(T)); }
+
+    void BindTo(unsigned int index);
+
+    unsigned int GetHandle() const { return id; }
+    unsigned long long GetBytesUploaded() const { return bytesUploaded; }
+    void ResetCounters() { bytesUploaded = 0; }
+
+private:
+
+    unsigned int id;
+    unsigned int size;
+    unsigned long long bytesUploaded;
+
+    // disallow copy/assignment
+    UniformBuffer(const UniformBuffer&);
+    UniformBuffer& operator=(const UniformBuffer&);
+};
+
+// uploads the skeleton's inverse bind pose as a SkeletonData block
+void SetSkeletonBlock(UniformBuffer& buffer, Skeleton& skeleton);
+
+#endif // UNIFORM_BUFFER_H_INCLUDED
@@ -0,0 +1,106 @@
+#include <UpdateScheduler.h>
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+
+static float MillisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count();
+}
+
+UpdateScheduler::UpdateScheduler() :
+    time(0.0f),
+    averageUpdateMs(0.0f),
+    budgetMs(UPDATE_SCHEDULER_DEFAULT_BUDGET_MS)
+{
+    stats.budgetMs = budgetMs;
+    stats.usedMs = 0.0f;
+    stats.numCharacters = 0;
+    stats.numUpdated = 0;
+    stats.numWaiting = 0;
+    stats.oldestPoseMs = 0.0f;
+}
+
+unsigned int UpdateScheduler::Add(const UpdateTask& update, float importance)
+{
+    Character character;
+    character.update = update;
+    character.importance = importance;
+    character.numUpdates = 0;
+    character.lastTime = time;
+    character.averageMs = 0.0f;
+    characters.push_back(character);
+    return (unsigned int)characters.size() - 1;
+}
+
+float UpdateScheduler::GetPriority(const Character& character) const
+{
+    if (character.numUpdates == 0) {
+        return FLT_MAX;
+    }
+    return (time - character.lastTime) * character.importance;
+}
+
+void UpdateScheduler::Update(float dt)
+{
+    std::chrono::high_resolution_clock::time_point frameStart = std::chrono::high_resolution_clock::now();
+    time += dt;
+    unsigned int numCharacters = (unsigned int)characters.size();
+    stats.budgetMs = budgetMs;
+    stats.numCharacters = numCharacters;
+    stats.numUpdated = 0;
+    stats.numWaiting = 0;
+    stats.oldestPoseMs = 0.0f;
+
+    order.resize(numCharacters);
+    for (unsigned int i = 0; i < numCharacters; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) {
+        return GetPriority(characters[a]) > GetPriority(characters[b]);
+    });
+
+    // stalest first, while the expected cost fits in what the frame has
+    // left; the clock runs from the start so sorting counts too
+    for (unsigned int i = 0; i < numCharacters; ++i) {
+        Character& character = characters[order[i]];
+        // a new character is expected to cost what everyone does
+        float expectedMs = (character.numUpdates > 0) ? character.averageMs : averageUpdateMs;
+        if (stats.numUpdated > 0 && MillisecondsSince(frameStart) + expectedMs > budgetMs) {
+            continue;
+        }
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        float elapsed = (character.numUpdates > 0) ? time - character.lastTime : 0.0f;
+        character.update(elapsed, character.palette);
+        float ms = MillisecondsSince(start);
+
+        character.averageMs = (character.numUpdates > 0) ? character.averageMs * 0.9f + ms * 0.1f : ms;
+        averageUpdateMs = (averageUpdateMs > 0.0f) ? averageUpdateMs * 0.9f + ms * 0.1f : ms;
+        character.lastTime = time;
+        ++character.numUpdates;
+        ++stats.numUpdated;
+    }
+
+    for (unsigned int i = 0; i < numCharacters; ++i) {
+        Character& character = characters[i];
+        if (character.numUpdates == 0) {
+            ++stats.numWaiting;
+            continue;
+        }
+        float ageMs = (time - character.lastTime) * 1000.0f;
+        if (ageMs > stats.oldestPoseMs) {
+            stats.oldestPoseMs = ageMs;
+        }
+    }
+    stats.usedMs = MillisecondsSince(frameStart);
+}
+
+std::ostream& operator<<(std::ostream& os, const UpdateSchedulerStats& stats)
+{
+    os << "budget " << stats.budgetMs << " ms, used " << stats.usedMs << " ms, "
+       << stats.numUpdated << " of " << stats.numCharacters << " updated, "
+       << stats.numWaiting << " waiting, oldest pose " << stats.oldestPoseMs << " ms";
+    return os;
+}
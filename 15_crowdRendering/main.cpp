@@ -20,6 +20,7 @@
 #include <Track.h>
 #include <TransformTrack.h>
 #include <DebugDraw.h>
+#include <DebugRenderer.h>
 #include <Pose.h>
 #include <Clip.h>
 #include <Skeleton.h>
@@ -28,8 +29,29 @@
 #include <CrossFadeController.h>
 #include <Blending.h>
 #include <CCDSolver.h>
+#include <FABRIKSolver.h>
+#include <IKBatchSolver.h>
 #include <DualQuaternion.h>
 #include <Crowd.h>
+#include <GLRecorder.h>
+#include <JobSystem.h>
+#include <CharacterAnimator.h>
+#include <AnimationWorld.h>
+#include <UpdateScheduler.h>
+#include <AnimBaker.h>
+#include <ClipManager.h>
+#include <MeshOptimizer.h>
+#include <TypedClip.h>
+#include <ResampledClip.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <sstream>
+#include <fstream>
 
 #ifdef __WIN32
     #undef main
@@ -43,6 +65,1327 @@ static void quit() {
     exit(EXIT_SUCCESS);
 }
 
+// runs numFrames rendered frames against GLRecorder at a fixed 60 Hz
+// step and prints what each one would have cost; needs no GPU or window
+static void record(unsigned int numFrames, float aspect)
+{
+    const unsigned int maxIdleFrames = 3000; // frames waiting for assets
+    unsigned int idleFrames = 0;
+    unsigned int frame = 0;
+    while (frame < numFrames && !gApplication->ShouldQuit()) {
+        GLRecorder::ResetStats();
+        gApplication->Render(aspect);
+        const GLRecorderStats& stats = GLRecorder::GetStats();
+        if (stats.drawCalls > 0) {
+            std::cout << "frame " << frame << ": " << stats << std::endl;
+            ++frame;
+        } else if (++idleFrames > maxIdleFrames) {
+            std::cout << __func__ << ": nothing was drawn, giving up" << std::endl;
+            break;
+        } else {
+            // assets are still loading on worker threads
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        gApplication->Update(1.0f / 60.0f);
+    }
+}
+
+static float millisecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+    std::chrono::duration<float, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count();
+}
+
+static const Clip* findClip(const std::vector<Clip>& clips, const char* name)
+{
+    for (unsigned int i = 0; i < clips.size(); ++i) {
+        if (clips[i].GetName() == name) {
+            return &clips[i];
+        }
+    }
+    return nullptr;
+}
+
+// loads Assets/Woman.gltf and sets rig up to walk and lean left; rig
+// points into meshes and clips
+static bool loadWomanRig(Skeleton& skeleton, std::vector<Mesh>& meshes,
+                         std::vector<Clip>& clips, CharacterRig& rig)
+{
+    cgltf_data* gltf = LoadGLTFFile("Assets/Woman.gltf");
+    if (gltf == nullptr) {
+        std::cout << __func__ << ": can't load Assets/Woman.gltf" << std::endl;
+        return false;
+    }
+    skeleton = LoadSkeleton(gltf);
+    meshes = LoadMeshes(gltf, false);
+    clips = LoadAnimationClips(gltf);
+    FreeGLTFFile(gltf);
+
+    const Clip* walk = findClip(clips, "Walking");
+    const Clip* lean = findClip(clips, "Lean_Left");
+    if (meshes.size() == 0 || walk == nullptr || lean == nullptr) {
+        std::cout << __func__ << ": Assets/Woman.gltf is missing its mesh or clips" << std::endl;
+        return false;
+    }
+    rig.Set(skeleton, meshes[0], *walk, *lean);
+    return true;
+}
+
+// spreads characters along the walk so they don't all sample the same time
+static void setCharacter(CharacterAnimator& character, CharacterRig& rig, unsigned int index)
+{
+    Transform model(Vec3((float)(index % 32) * 2.0f, 0.0f, (float)(index / 32) * 2.0f), Quat(), Vec3(1, 1, 1));
+    float start = rig.clip->GetStartTime() + rig.clip->GetDuration() * (float)(index % 17) / 17.0f;
+    character.Set(rig, model, start);
+}
+
+// animates numCharacters (sample, additive blend, leg IK, palette, CPU
+// skinning) on one thread, then as jobs on 2 to maxThreads threads, and
+// prints the time per frame and of a 512 column skin matrix bake
+static void benchmarkJobs(unsigned int numCharacters, unsigned int maxThreads)
+{
+    const unsigned int numFrames = 60;
+    const float dt = 1.0f / 60.0f;
+
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return;
+    }
+    const Clip* walk = rig.clip;
+    std::vector<CharacterAnimator> characters(numCharacters);
+    for (unsigned int i = 0; i < numCharacters; ++i) {
+        setCharacter(characters[i], rig, i);
+    }
+    AnimTexture bakeTexture;
+    bakeTexture.Resize(512);
+
+    std::cout << numCharacters << " characters, " << meshes[0].GetVertexCount()
+              << " vertices, " << skeleton.GetRestPose().GetSize() << " joints" << std::endl;
+
+    // one warm up frame, then the average of numFrames
+    for (unsigned int c = 0; c < numCharacters; ++c) {
+        characters[c].Update(dt);
+    }
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (unsigned int f = 0; f < numFrames; ++f) {
+        for (unsigned int c = 0; c < numCharacters; ++c) {
+            characters[c].Update(dt);
+        }
+    }
+    float serialMs = millisecondsSince(start) / (float)numFrames;
+    start = std::chrono::high_resolution_clock::now();
+    BakeSkinMatrixData(skeleton, *walk, bakeTexture);
+    float serialBakeMs = millisecondsSince(start);
+    std::cout << "1 thread: " << serialMs << " ms per frame, bake "
+              << serialBakeMs << " ms" << std::endl;
+
+    for (unsigned int numThreads = 2; numThreads <= maxThreads; ++numThreads)
+    {
+        JobSystem jobs(numThreads - 1);
+        for (unsigned int c = 0; c < numCharacters; ++c) {
+            characters[c].Schedule(jobs, dt);
+        }
+        jobs.WaitAll();
+        jobs.ResetStats();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (unsigned int f = 0; f < numFrames; ++f) {
+            for (unsigned int c = 0; c < numCharacters; ++c) {
+                characters[c].Schedule(jobs, dt);
+            }
+            jobs.WaitAll();
+        }
+        float frameMs = millisecondsSince(start) / (float)numFrames;
+        start = std::chrono::high_resolution_clock::now();
+        BakeSkinMatrixData(skeleton, *walk, bakeTexture, &jobs);
+        jobs.WaitAll();
+        float bakeMs = millisecondsSince(start);
+
+        std::cout << numThreads << " threads: " << frameMs << " ms per frame ("
+                  << serialMs / frameMs << "x), bake " << bakeMs << " ms ("
+                  << serialBakeMs / bakeMs << "x)" << std::endl;
+        if (numThreads == maxThreads) {
+            const std::vector<JobTiming>& timings = jobs.GetTimings();
+            for (unsigned int i = 0; i < timings.size(); ++i) {
+                std::cout << "    " << timings[i] << std::endl;
+            }
+            for (unsigned int i = 0; i < jobs.GetNumThreads(); ++i) {
+                std::cout << "    thread " << i << ": " << jobs.GetThreadStats(i) << std::endl;
+            }
+        }
+    }
+}
+
+// plays every clip of Assets/Woman.gltf on numCharacters, each fading to
+// the next clip every two seconds, through CrossFadeController objects
+// and then through an AnimationWorld, and prints the time per frame of
+// both including skin palettes
+static void benchmarkWorld(unsigned int numCharacters)
+{
+    const unsigned int numFrames = 240;
+    const unsigned int fadeInterval = 120;
+    const float fadeTime = 0.5f;
+    const float dt = 1.0f / 60.0f;
+
+    cgltf_data* gltf = LoadGLTFFile("Assets/Woman.gltf");
+    if (gltf == nullptr) {
+        std::cout << __func__ << ": can't load Assets/Woman.gltf" << std::endl;
+        return;
+    }
+    Skeleton skeleton = LoadSkeleton(gltf);
+    std::vector<Clip> clips = LoadAnimationClips(gltf);
+    FreeGLTFFile(gltf);
+    unsigned int numClips = (unsigned int)clips.size();
+    if (numClips == 0) {
+        std::cout << __func__ << ": Assets/Woman.gltf has no clips" << std::endl;
+        return;
+    }
+    std::vector<Affine3x4> invBindPose;
+    skeleton.GetInvBindPose(invBindPose);
+    unsigned int numJoints = (unsigned int)invBindPose.size();
+
+    // one object per character, as the samples do it
+    std::vector<CrossFadeController*> controllers(numCharacters);
+    std::vector<std::vector<Affine3x4> > palettes(numCharacters);
+    std::vector<unsigned int> playing(numCharacters);
+    for (unsigned int c = 0; c < numCharacters; ++c) {
+        controllers[c] = new CrossFadeController(skeleton);
+        playing[c] = c % numClips;
+        controllers[c]->Play(&clips[playing[c]]);
+    }
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (unsigned int f = 0; f < numFrames; ++f) {
+        for (unsigned int c = 0; c < numCharacters; ++c) {
+            if ((f + c) % fadeInterval == 0) {
+                playing[c] = (playing[c] + 1) % numClips;
+                controllers[c]->FadeTo(&clips[playing[c]], fadeTime);
+            }
+            controllers[c]->Update(dt);
+            controllers[c]->GetCurrentPose().GetAffinePalette(palettes[c]);
+            for (unsigned int j = 0; j < numJoints; ++j) {
+                palettes[c][j] = palettes[c][j] * invBindPose[j];
+            }
+        }
+    }
+    float objectMs = millisecondsSince(start) / (float)numFrames;
+    for (unsigned int c = 0; c < numCharacters; ++c) {
+        delete controllers[c];
+    }
+
+    AnimationWorld world;
+    world.SetSkeleton(skeleton);
+    for (unsigned int i = 0; i < numClips; ++i) {
+        world.AddClip(clips[i]);
+    }
+    for (unsigned int c = 0; c < numCharacters; ++c) {
+        playing[c] = c % numClips;
+        world.AddCharacter(playing[c], world.GetClip(playing[c]).GetStartTime());
+    }
+    AnimationWorldStats total = world.GetStats();
+    start = std::chrono::high_resolution_clock::now();
+    for (unsigned int f = 0; f < numFrames; ++f) {
+        for (unsigned int c = 0; c < numCharacters; ++c) {
+            if ((f + c) % fadeInterval == 0) {
+                playing[c] = (playing[c] + 1) % numClips;
+                world.FadeTo(c, playing[c], fadeTime);
+            }
+        }
+        world.Update(dt);
+        const AnimationWorldStats& stats = world.GetStats();
+        total.numFading += stats.numFading;
+        total.advanceMs += stats.advanceMs;
+        total.sampleMs += stats.sampleMs;
+        total.blendMs += stats.blendMs;
+        total.globalMs += stats.globalMs;
+        total.paletteMs += stats.paletteMs;
+    }
+    float worldMs = millisecondsSince(start) / (float)numFrames;
+
+    AnimationWorldStats average = total;
+    average.numCharacters = numCharacters;
+    average.numFading = total.numFading / numFrames;
+    average.advanceMs /= (float)numFrames;
+    average.sampleMs /= (float)numFrames;
+    average.blendMs /= (float)numFrames;
+    average.globalMs /= (float)numFrames;
+    average.paletteMs /= (float)numFrames;
+
+    std::cout << numCharacters << " characters, " << numJoints << " joints, "
+              << numClips << " clips" << std::endl;
+    std::cout << "CrossFadeController: " << objectMs << " ms per frame" << std::endl;
+    std::cout << "AnimationWorld: " << worldMs << " ms per frame ("
+              << objectMs / worldMs << "x)" << std::endl;
+    std::cout << "    average " << average << std::endl;
+}
+
+// starts with a quarter of numCharacters and activates the rest at once
+// a second in; every character's sampling, leg IK and palette runs
+// through an UpdateScheduler with budgetMs per frame. Prints what the
+// scheduler did on some of the frames and the cost of updating everyone
+static void benchmarkSchedule(unsigned int numCharacters, float budgetMs)
+{
+    const unsigned int numFrames = 180;
+    const unsigned int activateFrame = 60;
+    const float dt = 1.0f / 60.0f;
+
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return;
+    }
+    std::vector<CharacterAnimator> characters(numCharacters);
+    for (unsigned int i = 0; i < numCharacters; ++i) {
+        setCharacter(characters[i], rig, i);
+    }
+
+    UpdateScheduler scheduler;
+    scheduler.SetBudget(budgetMs);
+    unsigned int numActive = numCharacters / 4;
+    float maxUsedMs = 0.0f;
+    float totalUsedMs = 0.0f;
+    for (unsigned int f = 0; f < numFrames; ++f) {
+        unsigned int numWanted = (f < activateFrame) ? numActive : numCharacters;
+        while (scheduler.GetSize() < numWanted) {
+            CharacterAnimator* character = &characters[scheduler.GetSize()];
+            scheduler.Add([character](float elapsed, std::vector<Affine3x4>& outPalette) {
+                character->SampleBase(elapsed);
+                character->SampleAdditive(elapsed);
+                character->Blend();
+                character->SolveLegs();
+                character->BuildPalette();
+                outPalette = character->GetPalette();
+            });
+        }
+
+        scheduler.Update(dt);
+        const UpdateSchedulerStats& stats = scheduler.GetStats();
+        if (f % 30 == 0 || (f >= activateFrame && f < activateFrame + 3)) {
+            std::cout << "frame " << f << ": " << stats << std::endl;
+        }
+        float usedMs = stats.usedMs;
+        totalUsedMs += usedMs;
+        if (usedMs > maxUsedMs) {
+            maxUsedMs = usedMs;
+        }
+    }
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (unsigned int c = 0; c < numCharacters; ++c) {
+        characters[c].SampleBase(dt);
+        characters[c].SampleAdditive(dt);
+        characters[c].Blend();
+        characters[c].SolveLegs();
+        characters[c].BuildPalette();
+    }
+    float everyoneMs = millisecondsSince(start);
+    std::cout << "scheduled: " << totalUsedMs / (float)numFrames << " ms per frame on average, "
+              << maxUsedMs << " ms at most; updating all " << numCharacters
+              << " characters takes " << everyoneMs << " ms" << std::endl;
+}
+
+static float randomFloat(float min, float max)
+{
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+static Quat randomRotation()
+{
+    Vec3 axis(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f));
+    if (lenSq(axis) < 0.0001f) {
+        axis = Vec3(0, 1, 0);
+    }
+    return angleAxis(randomFloat(-3.14159f, 3.14159f), normalized(axis));
+}
+
+// the buffer views and accessors of a glTF being written, one view per
+// accessor
+struct SyntheticBuffers
+{
+    std::ostringstream views;
+    std::ostringstream accessors;
+    std::vector<char> bin;
+    unsigned int numAccessors;
+
+    SyntheticBuffers() : numAccessors(0) {}
+
+    // appends data as count elements of type; returns the accessor
+    template <typename T>
+    unsigned int Add(const std::vector<T>& data, unsigned int count, const char* type,
+                     unsigned int componentType) {
+        unsigned int numBytes = (unsigned int)(data.size() * sizeof(T));
+        if (numAccessors > 0) {
+            views << ",";
+            accessors << ",";
+        }
+        views << "{\"buffer\":0,\"byteOffset\":" << bin.size() << ",\"byteLength\":" << numBytes << "}";
+        accessors << "{\"bufferView\":" << numAccessors << ",\"componentType\":" << componentType
+                  << ",\"count\":" << count << ",\"type\":\"" << type << "\"}";
+        const char* bytes = (const char*)&data[0];
+        bin.insert(bin.end(), bytes, bytes + numBytes);
+        // keeps every view four byte aligned
+        bin.resize((bin.size() + 3) & ~3u);
+        return numAccessors++;
+    }
+};
+
+// writes path and path.bin: a mesh of numVertices skinned vertices split
+// into 8 primitives, a 128 joint chain and 16 clips of 120 keys per joint
+static bool writeSyntheticGLTF(const std::string& path, unsigned int numVertices)
+{
+    const unsigned int numPrimitives = 8;
+    const unsigned int numJoints = 128;
+    const unsigned int numClips = 16;
+    const unsigned int numKeys = 120;
+    const unsigned int floatType = 5126;
+    const unsigned int ushortType = 5123;
+    const unsigned int uintType = 5125;
+
+    SyntheticBuffers buffers;
+    std::ostringstream primitives;
+
+    unsigned int perPrimitive = (numVertices / numPrimitives) / 3 * 3;
+    std::vector<float> positions(perPrimitive * 3);
+    std::vector<float> normals(perPrimitive * 3);
+    std::vector<float> texCoords(perPrimitive * 2);
+    std::vector<unsigned short> joints(perPrimitive * 4);
+    std::vector<float> weights(perPrimitive * 4);
+    std::vector<unsigned int> indices(perPrimitive);
+    for (unsigned int p = 0; p < numPrimitives; ++p) {
+        for (unsigned int v = 0; v < perPrimitive; ++v) {
+            float height = (float)v / (float)perPrimitive;
+            float angle = (float)v * 0.1f;
+            positions[v * 3 + 0] = cosf(angle) + (float)p;
+            positions[v * 3 + 1] = height * 10.0f;
+            positions[v * 3 + 2] = sinf(angle);
+            normals[v * 3 + 0] = cosf(angle);
+            normals[v * 3 + 1] = 0.0f;
+            normals[v * 3 + 2] = sinf(angle);
+            texCoords[v * 2 + 0] = angle;
+            texCoords[v * 2 + 1] = height;
+            unsigned int joint = (unsigned int)(height * (float)(numJoints - 2));
+            for (unsigned int i = 0; i < 4; ++i) {
+                joints[v * 4 + i] = (unsigned short)(joint + i / 2);
+                weights[v * 4 + i] = (i < 2) ? 0.5f : 0.0f;
+            }
+            indices[v] = v;
+        }
+        if (p > 0) {
+            primitives << ",";
+        }
+        primitives << "{\"attributes\":{"
+                   << "\"POSITION\":" << buffers.Add(positions, perPrimitive, "VEC3", floatType)
+                   << ",\"NORMAL\":" << buffers.Add(normals, perPrimitive, "VEC3", floatType)
+                   << ",\"TEXCOORD_0\":" << buffers.Add(texCoords, perPrimitive, "VEC2", floatType)
+                   << ",\"JOINTS_0\":" << buffers.Add(joints, perPrimitive, "VEC4", ushortType)
+                   << ",\"WEIGHTS_0\":" << buffers.Add(weights, perPrimitive, "VEC4", floatType)
+                   << "},\"indices\":" << buffers.Add(indices, perPrimitive, "SCALAR", uintType)
+                   << "}";
+    }
+
+    std::vector<float> times(numKeys);
+    for (unsigned int k = 0; k < numKeys; ++k) {
+        times[k] = (float)k / 30.0f;
+    }
+    unsigned int timeAccessor = buffers.Add(times, numKeys, "SCALAR", floatType);
+    std::ostringstream animations;
+    std::vector<float> rotations(numKeys * 4);
+    std::vector<float> translations(numKeys * 3);
+    for (unsigned int c = 0; c < numClips; ++c) {
+        std::ostringstream channels;
+        std::ostringstream samplers;
+        for (unsigned int j = 0; j < numJoints; ++j) {
+            for (unsigned int k = 0; k < numKeys; ++k) {
+                float angle = sinf((float)(k + j + c) * 0.1f) * 0.2f;
+                rotations[k * 4 + 0] = sinf(angle);
+                rotations[k * 4 + 1] = 0.0f;
+                rotations[k * 4 + 2] = 0.0f;
+                rotations[k * 4 + 3] = cosf(angle);
+                translations[k * 3 + 0] = 0.0f;
+                translations[k * 3 + 1] = (j == 0) ? 0.0f : 10.0f / (float)numJoints;
+                translations[k * 3 + 2] = angle * 0.01f;
+            }
+            unsigned int rotation = buffers.Add(rotations, numKeys, "VEC4", floatType);
+            unsigned int translation = buffers.Add(translations, numKeys, "VEC3", floatType);
+            if (j > 0) {
+                channels << ",";
+                samplers << ",";
+            }
+            channels << "{\"sampler\":" << j * 2 << ",\"target\":{\"node\":" << j + 1 << ",\"path\":\"rotation\"}},"
+                     << "{\"sampler\":" << j * 2 + 1 << ",\"target\":{\"node\":" << j + 1 << ",\"path\":\"translation\"}}";
+            samplers << "{\"input\":" << timeAccessor << ",\"output\":" << rotation << "},"
+                     << "{\"input\":" << timeAccessor << ",\"output\":" << translation << "}";
+        }
+        if (c > 0) {
+            animations << ",";
+        }
+        animations << "{\"name\":\"Clip" << c << "\",\"channels\":[" << channels.str()
+                   << "],\"samplers\":[" << samplers.str() << "]}";
+    }
+
+    std::ostringstream nodes;
+    std::ostringstream skinJoints;
+    nodes << "{\"mesh\":0,\"skin\":0}";
+    for (unsigned int j = 0; j < numJoints; ++j) {
+        nodes << ",{\"name\":\"Joint" << j << "\"";
+        if (j + 1 < numJoints) {
+            nodes << ",\"children\":[" << j + 2 << "]";
+        }
+        nodes << "}";
+        skinJoints << ((j > 0) ? "," : "") << j + 1;
+    }
+
+    std::string binPath = path + ".bin";
+    std::string binName = binPath.substr(binPath.find_last_of("/\\") + 1);
+    std::ofstream binFile(binPath.c_str(), std::ios::binary);
+    binFile.write(&buffers.bin[0], buffers.bin.size());
+    std::ofstream file(path.c_str());
+    file << "{\"asset\":{\"version\":\"2.0\"},"
+         << "\"buffers\":[{\"uri\":\"" << binName << "\",\"byteLength\":" << buffers.bin.size() << "}],"
+         << "\"bufferViews\":[" << buffers.views.str() << "],"
+         << "\"accessors\":[" << buffers.accessors.str() << "],"
+         << "\"meshes\":[{\"primitives\":[" << primitives.str() << "]}],"
+         << "\"skins\":[{\"joints\":[" << skinJoints.str() << "]}],"
+         << "\"nodes\":[" << nodes.str() << "],"
+         << "\"animations\":[" << animations.str() << "]}";
+    if (!binFile || !file) {
+        std::cout << __func__ << ": can't write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// prints how long parsing path and importing its meshes and clips takes,
+// on the calling thread and split across jobs; averaged over a few runs
+static void timeLoad(const char* path, JobSystem& jobs)
+{
+    const unsigned int numRuns = 5;
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    cgltf_data* gltf = LoadGLTFFile(path);
+    float parseMs = millisecondsSince(start);
+    if (gltf == nullptr) {
+        return;
+    }
+
+    float meshMs = 0.0f;
+    float clipMs = 0.0f;
+    float jobMeshMs = 0.0f;
+    float jobClipMs = 0.0f;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    for (unsigned int i = 0; i < numRuns; ++i) {
+        start = std::chrono::high_resolution_clock::now();
+        meshes = LoadMeshes(gltf, false);
+        meshMs += millisecondsSince(start);
+        start = std::chrono::high_resolution_clock::now();
+        clips = LoadAnimationClips(gltf);
+        clipMs += millisecondsSince(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        meshes = LoadMeshes(gltf, false, &jobs);
+        jobs.WaitAll();
+        jobMeshMs += millisecondsSince(start);
+        start = std::chrono::high_resolution_clock::now();
+        clips = LoadAnimationClips(gltf, &jobs);
+        jobs.WaitAll();
+        jobClipMs += millisecondsSince(start);
+    }
+    FreeGLTFFile(gltf);
+
+    unsigned int numVertices = 0;
+    for (unsigned int i = 0; i < meshes.size(); ++i) {
+        numVertices += meshes[i].GetVertexCount();
+    }
+    std::cout << path << ": " << meshes.size() << " meshes, " << numVertices << " vertices, "
+              << clips.size() << " clips; parsed in " << parseMs << " ms" << std::endl;
+    std::cout << "    meshes " << meshMs / (float)numRuns << " ms, clips " << clipMs / (float)numRuns
+              << " ms on 1 thread; " << jobMeshMs / (float)numRuns << " ms and "
+              << jobClipMs / (float)numRuns << " ms on " << jobs.GetNumThreads() << " threads" << std::endl;
+}
+
+// the system's directory for temporary files, without a trailing slash
+static std::string temporaryDirectory()
+{
+    const char* variables[] = { "TMPDIR", "TEMP", "TMP" };
+    for (unsigned int i = 0; i < 3; ++i) {
+        const char* directory = getenv(variables[i]);
+        if (directory != nullptr && directory[0] != '\0') {
+            return directory;
+        }
+    }
+    return "/tmp";
+}
+
+// times loading Assets/Woman.gltf and a synthetic asset with numVertices
+// vertices, written to the temporary directory and removed afterwards
+static void benchmarkLoad(unsigned int numVertices)
+{
+    JobSystem jobs;
+    timeLoad("Assets/Woman.gltf", jobs);
+
+    std::string path = temporaryDirectory() + "/Synthetic.gltf";
+    if (writeSyntheticGLTF(path, numVertices)) {
+        timeLoad(path.c_str(), jobs);
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".bin").c_str());
+}
+
+// a triangle corner of skinned output: position and normal
+struct SkinnedCorner
+{
+    float v[6];
+
+    bool operator<(const SkinnedCorner& other) const {
+        return std::lexicographical_compare(v, v + 6, other.v, other.v + 6);
+    }
+    bool operator==(const SkinnedCorner& other) const {
+        return std::equal(v, v + 6, other.v);
+    }
+};
+
+// the triangles of indices as corner triples, each rotated so its
+// smallest corner comes first (which keeps the winding), sorted; equal
+// for two index lists that draw the same triangles in any order
+template <typename T, typename Corner>
+static std::vector<std::vector<T> > sortedTriangles(const std::vector<unsigned int>& indices, Corner corner)
+{
+    std::vector<std::vector<T> > triangles(indices.size() / 3);
+    for (unsigned int t = 0; t < triangles.size(); ++t) {
+        std::vector<T>& triangle = triangles[t];
+        for (unsigned int k = 0; k < 3; ++k) {
+            triangle.push_back(corner(indices[t * 3 + k]));
+        }
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static std::vector<std::vector<SkinnedCorner> > skinnedTriangles(const Mesh& mesh, const std::vector<unsigned int>& indices,
+                                                                 const std::vector<Affine3x4>& palette)
+{
+    unsigned int numVerts = mesh.GetVertexCount();
+    std::vector<Vec3> positions(numVerts);
+    std::vector<Vec3> normals(numVerts);
+    if (numVerts > 0) {
+        mesh.CPUSkin(palette, &positions[0], &normals[0]);
+    }
+    return sortedTriangles<SkinnedCorner>(indices, [&](unsigned int i) {
+        SkinnedCorner corner = { { positions[i].x, positions[i].y, positions[i].z,
+                                   normals[i].x, normals[i].y, normals[i].z } };
+        return corner;
+    });
+}
+
+// runs OptimizeVertexCache and OptimizeVertexFetch on a copy of indices
+// and checks the ACMR doesn't go up and both keep the triangles,
+// OptimizeVertexFetch's through its remap
+static bool checkIndexReorder(const std::vector<unsigned int>& original, unsigned int numVerts)
+{
+    auto same = [](unsigned int i) { return i; };
+    std::vector<std::vector<unsigned int> > triangles = sortedTriangles<unsigned int>(original, same);
+
+    std::vector<unsigned int> indices = original;
+    float acmrBefore = CalculateACMR(indices, numVerts);
+    OptimizeVertexCache(indices, numVerts);
+    float acmrAfter = CalculateACMR(indices, numVerts);
+    bool cacheKept = sortedTriangles<unsigned int>(indices, same) == triangles;
+
+    std::vector<unsigned int> remap = OptimizeVertexFetch(indices, numVerts);
+    std::vector<unsigned int> unmap(numVerts, numVerts);
+    for (unsigned int v = 0; v < remap.size(); ++v) {
+        if (remap[v] < numVerts) {
+            unmap[remap[v]] = v;
+        }
+    }
+    bool fetchKept = remap.size() == numVerts &&
+        std::find(unmap.begin(), unmap.end(), numVerts) == unmap.end() &&
+        sortedTriangles<unsigned int>(indices, [&](unsigned int i) { return unmap[i]; }) == triangles;
+
+    std::cout << "    OptimizeVertexCache: ACMR " << acmrBefore << " -> " << acmrAfter
+              << ((acmrAfter <= acmrBefore) ? "" : " INCREASED")
+              << ", triangles " << (cacheKept ? "kept" : "CHANGED") << std::endl;
+    std::cout << "    OptimizeVertexFetch: triangles " << (fetchKept ? "kept" : "CHANGED") << std::endl;
+    return acmrAfter <= acmrBefore && cacheKept && fetchKept;
+}
+
+// checks the MeshOptimizer steps on every mesh of Assets/Woman.gltf, and
+// CPU skinning the optimized mesh gives bit identical triangles on
+// numPoses poses. Woman.gltf shares no vertices, so the reorders are
+// also checked on a grid whose triangles are shuffled
+static bool checkMeshOptimizer(unsigned int numPoses)
+{
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return false;
+    }
+    std::vector<std::vector<Affine3x4> > palettes(numPoses);
+    for (unsigned int p = 0; p < numPoses; ++p) {
+        CharacterAnimator character;
+        setCharacter(character, rig, p);
+        character.Update(0.0f);
+        palettes[p] = character.GetPalette();
+    }
+
+    bool passed = true;
+    for (unsigned int m = 0; m < meshes.size(); ++m) {
+        Mesh& mesh = meshes[m];
+        unsigned int numVerts = mesh.GetVertexCount();
+        std::vector<unsigned int> original = mesh.GetIndices();
+        if (original.empty()) {
+            for (unsigned int i = 0; i < numVerts; ++i) {
+                original.push_back(i);
+            }
+        }
+
+        Mesh optimized = mesh;
+        MeshOptimizerReport report = OptimizeMesh(optimized);
+        std::cout << "Mesh " << m << ": " << report << std::endl;
+        passed = checkIndexReorder(original, numVerts) && passed;
+
+        unsigned int numSkinned = 0;
+        for (unsigned int p = 0; p < numPoses; ++p) {
+            if (skinnedTriangles(mesh, original, palettes[p]) ==
+                skinnedTriangles(optimized, optimized.GetIndices(), palettes[p])) {
+                ++numSkinned;
+            }
+        }
+        std::cout << "    CPUSkin: " << numSkinned << " of " << numPoses << " poses identical" << std::endl;
+        passed = passed && report.acmrAfter <= report.acmrBefore && numSkinned == numPoses;
+    }
+
+    const unsigned int gridSize = 64;
+    std::vector<unsigned int> grid;
+    for (unsigned int y = 0; y < gridSize; ++y) {
+        for (unsigned int x = 0; x < gridSize; ++x) {
+            unsigned int corner = y * (gridSize + 1) + x;
+            unsigned int quad[6] = { corner, corner + gridSize + 1, corner + 1,
+                                     corner + 1, corner + gridSize + 1, corner + gridSize + 2 };
+            grid.insert(grid.end(), quad, quad + 6);
+        }
+    }
+    for (unsigned int t = (unsigned int)grid.size() / 3 - 1; t > 0; --t) {
+        unsigned int other = (unsigned int)rand() % (t + 1);
+        std::swap_ranges(grid.begin() + t * 3, grid.begin() + t * 3 + 3, grid.begin() + other * 3);
+    }
+    std::cout << "Shuffled " << gridSize << "x" << gridSize << " grid:" << std::endl;
+    passed = checkIndexReorder(grid, (gridSize + 1) * (gridSize + 1)) && passed;
+
+    std::cout << (passed ? "passed" : "FAILED") << std::endl;
+    return passed;
+}
+
+// len() of Vec3 rounds anything under a millimeter down to 0
+static float distance(const Vec3& a, const Vec3& b)
+{
+    return sqrtf(lenSq(a - b));
+}
+
+// skins the first mesh of Assets/Woman.gltf with every clip baked into a
+// 512 column skin matrix texture, through SkinVertexBaked (what
+// Shaders/crowdSkinMatrix.vert does) and through Mesh::CPUSkin with the
+// clip sampled at the same time, on numColumns whole columns and halfway
+// between them, and prints how far apart the vertices are. Halfway, the
+// texture's linear blend of two frames is compared with a sampled pose
+static void checkBakedSkinning(unsigned int numColumns)
+{
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return;
+    }
+    const Mesh& mesh = meshes[0];
+    unsigned int numVerts = mesh.GetVertexCount();
+    std::vector<Vec3> positions(numVerts);
+    std::vector<Vec3> normals(numVerts);
+    std::vector<Affine3x4> palette;
+    Pose pose = skeleton.GetBindPose();
+
+    for (unsigned int c = 0; c < clips.size(); ++c) {
+        AnimTexture tex;
+        tex.Resize(512);
+        BakeSkinMatrixData(skeleton, clips[c], tex);
+        float last = (float)(tex.GetSize() - 1);
+
+        float maxError[2] = { 0.0f, 0.0f };
+        float maxNormalError[2] = { 0.0f, 0.0f };
+        for (unsigned int s = 0; s < numColumns; ++s) {
+            for (unsigned int half = 0; half < 2; ++half) {
+                float column = (float)(s * (tex.GetSize() - 1) / numColumns) + 0.5f * (float)half;
+                clips[c].Sample(pose, clips[c].GetStartTime() + clips[c].GetDuration() * column / last);
+                pose.GetAffinePalette(palette);
+                for (unsigned int j = 0; j < palette.size(); ++j) {
+                    palette[j] = palette[j] * rig.invBindPose[j];
+                }
+                mesh.CPUSkin(palette, &positions[0], &normals[0]);
+
+                for (unsigned int v = 0; v < numVerts; ++v) {
+                    Vec3 position, normal, bakedPosition, bakedNormal;
+                    Vec4 weights;
+                    iVec4 joints;
+                    mesh.GetSkinningInput(v, position, normal, weights, joints);
+                    SkinVertexBaked(tex, column, position, normal, weights, joints, bakedPosition, bakedNormal);
+                    maxError[half] = std::max(maxError[half], distance(bakedPosition, positions[v]));
+                    maxNormalError[half] = std::max(maxNormalError[half], distance(bakedNormal, normals[v]));
+                }
+            }
+        }
+        std::cout << clips[c].GetName() << ": max error " << maxError[0] << " (normal "
+                  << maxNormalError[0] << ") at whole columns, " << maxError[1] << " (normal "
+                  << maxNormalError[1] << ") halfway" << std::endl;
+    }
+}
+
+static Vec3 texelXYZ(AnimTexture& tex, unsigned int x, unsigned int y)
+{
+    Vec4 texel = tex.GetTexel(x, y);
+    return Vec3(texel.x, texel.y, texel.z);
+}
+
+// bakes a numFrames vertex animation texture of every Woman.gltf clip
+// twice, on one thread and as jobs, and compares the two; then compares
+// the texture (read the way Shaders/crowdVAT.vert does, halfway between
+// frames with the linear filter's blend) with Mesh::CPUSkin at the same
+// time. Returns false if the bakes differ or a whole frame is off
+static bool checkVertexAnimation(unsigned int numFrames)
+{
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return false;
+    }
+    Mesh& mesh = meshes[0];
+    unsigned int numVerts = mesh.GetVertexCount();
+    unsigned int texSize = GetVertexAnimationTextureSize(numVerts, numFrames);
+    if (texSize == 0) {
+        std::cout << __func__ << ": " << numVerts << " vertices of " << numFrames
+                  << " frames don't fit any texture" << std::endl;
+        return false;
+    }
+    std::cout << numVerts << " vertices, " << numFrames << " frames: " << texSize
+              << " x " << texSize << " texture" << std::endl;
+
+    const float tolerance = 0.0001f;
+    JobSystem jobs;
+    std::vector<Vec3> positions(numVerts);
+    std::vector<Vec3> normals(numVerts);
+    std::vector<Affine3x4> palette;
+    Pose pose = skeleton.GetBindPose();
+    bool passed = true;
+    for (unsigned int c = 0; c < clips.size(); ++c) {
+        AnimTexture tex, jobTex;
+        tex.Resize(texSize);
+        jobTex.Resize(texSize);
+        BakeVertexAnimationData(skeleton, clips[c], mesh, numFrames, tex);
+        BakeVertexAnimationData(skeleton, clips[c], mesh, numFrames, jobTex, &jobs);
+        bool same = memcmp(tex.GetData(), jobTex.GetData(),
+                           sizeof(float) * 4 * texSize * texSize) == 0;
+
+        float maxError[2] = { 0.0f, 0.0f };
+        float maxNormalError[2] = { 0.0f, 0.0f };
+        unsigned int vertsPerBlock = texSize / 2;
+        for (unsigned int f = 0; f < numFrames; ++f) {
+            // a looping clip wraps at its end, so the last frame is the first
+            // pose again; the stretch into it is the loop's seam, not a blend
+            for (unsigned int half = 0; half < 2 && f + half * 2 < numFrames; ++half) {
+                float frame = (float)f + 0.5f * (float)half;
+                float t = frame / (float)(numFrames - 1);
+                clips[c].Sample(pose, clips[c].GetStartTime() + clips[c].GetDuration() * t);
+                pose.GetAffinePalette(palette);
+                for (unsigned int j = 0; j < palette.size(); ++j) {
+                    palette[j] = palette[j] * rig.invBindPose[j];
+                }
+                mesh.CPUSkin(palette, &positions[0], &normals[0]);
+
+                for (unsigned int v = 0; v < numVerts; ++v) {
+                    unsigned int x = (v / vertsPerBlock) * numFrames + f;
+                    unsigned int y = (v % vertsPerBlock) * 2;
+                    Vec3 position = texelXYZ(tex, x, y);
+                    Vec3 normal = texelXYZ(tex, x, y + 1);
+                    if (half == 1) {
+                        position = (position + texelXYZ(tex, x + 1, y)) * 0.5f;
+                        normal = (normal + texelXYZ(tex, x + 1, y + 1)) * 0.5f;
+                    }
+                    maxError[half] = std::max(maxError[half], distance(position, positions[v]));
+                    maxNormalError[half] = std::max(maxNormalError[half], distance(normal, normals[v]));
+                }
+            }
+        }
+        std::cout << clips[c].GetName() << ": bakes " << (same ? "match" : "DIFFER")
+                  << ", max error " << maxError[0] << " (normal " << maxNormalError[0]
+                  << ") at whole frames, " << maxError[1] << " (normal "
+                  << maxNormalError[1] << ") halfway" << std::endl;
+        if (!same || maxError[0] > tolerance || maxNormalError[0] > tolerance) {
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+static void printIKComparison(const char* solver, const IKBatchSolver& batch,
+                              unsigned int batchConverged, float batchMs,
+                              const std::vector<Vec3>& positions,
+                              unsigned int converged, float ms,
+                              const std::vector<Vec3>& goals)
+{
+    unsigned int numChains = batch.GetNumChains();
+    unsigned int chainLength = batch.GetChainLength();
+    unsigned int last = chainLength - 1;
+    float maxDifference = 0.0f;
+    float totalDifference = 0.0f;
+    float residual = 0.0f;
+    float batchResidual = 0.0f;
+    for (unsigned int c = 0; c < numChains; ++c) {
+        for (unsigned int i = 0; i < chainLength; ++i) {
+            float difference = distance(batch.GetWorldPosition(c, i), positions[c * chainLength + i]);
+            totalDifference += difference;
+            if (difference > maxDifference) {
+                maxDifference = difference;
+            }
+        }
+        residual += distance(positions[c * chainLength + last], goals[c]);
+        batchResidual += distance(batch.GetWorldPosition(c, last), goals[c]);
+    }
+    std::cout << solver << ": " << converged << " of " << numChains << " converged, "
+              << residual / (float)numChains << " from the goal on average, in "
+              << ms << " ms" << std::endl;
+    std::cout << "    batched: " << batchConverged << " converged, " << batchResidual / (float)numChains
+              << " from the goal on average, in " << batchMs << " ms (" << ms / batchMs << "x)" << std::endl;
+    std::cout << "    joints differ by " << totalDifference / (float)(numChains * chainLength)
+              << " on average, " << maxDifference << " at most" << std::endl;
+}
+
+// compares the manager's counters since the last check with what the
+// step should have done, prints both and resets them
+static bool expectClipStats(ClipManager& manager, const char* step, unsigned int hits,
+                            unsigned int misses, unsigned int evictions)
+{
+    ClipManagerStats stats = manager.GetStats();
+    manager.ResetStats();
+    bool passed = stats.hits == hits && stats.misses == misses && stats.evictions == evictions;
+    std::cout << step << ": " << stats.hits << " hits, " << stats.misses << " misses, "
+              << stats.evictions << " evictions, " << stats.numResident << " resident";
+    if (!passed) {
+        std::cout << " (expected " << hits << ", " << misses << ", " << evictions << ")";
+    }
+    std::cout << std::endl;
+    return passed;
+}
+
+// Runs the clips of Assets/Woman.gltf through a ClipManager under budgets
+// that only fit some of them and checks the hit, miss and eviction counts
+// of every step, ending with numRounds passes over every clip under a
+// budget no clip fits in. Returns false if any count is off
+static bool checkClipManager(unsigned int numRounds)
+{
+    ClipManager manager;
+    manager.Register(LoadGLTFFile("Assets/Woman.gltf"));
+    unsigned int numClips = manager.GetNumClips();
+    if (numClips < 3) {
+        std::cout << __func__ << ": Assets/Woman.gltf needs at least 3 clips" << std::endl;
+        return false;
+    }
+    bool passed = true;
+
+    // everything fits: each clip loads once and stays
+    manager.SetMemoryBudget((size_t)-1);
+    std::vector<size_t> bytes(numClips);
+    for (unsigned int i = 0; i < numClips; ++i) {
+        size_t before = manager.GetStats().bytesResident;
+        manager.Release(manager.Acquire(i));
+        bytes[i] = manager.GetStats().bytesResident - before;
+    }
+    passed &= expectClipStats(manager, "first use", 0, numClips, 0);
+    for (unsigned int i = 0; i < numClips; ++i) {
+        manager.Release(manager.Acquire(i));
+    }
+    passed &= expectClipStats(manager, "second use", numClips, 0, 0);
+
+    // a pinned clip survives a budget of nothing until it is released
+    const Clip* pinned = manager.Acquire(0u);
+    manager.SetMemoryBudget(0);
+    passed &= expectClipStats(manager, "budget 0, clip 0 pinned", 1, 0, numClips - 1);
+    manager.Release(manager.Acquire(0u));
+    manager.Release(pinned);
+    passed &= expectClipStats(manager, "clip 0 released", 1, 0, 1);
+
+    // room for clip 0 and the largest other clip; after using clip 0 again,
+    // a third clip evicts the least recently used one, which isn't clip 0
+    unsigned int large = 1;
+    for (unsigned int i = 2; i < numClips; ++i) {
+        if (bytes[i] > bytes[large]) {
+            large = i;
+        }
+    }
+    unsigned int other = (large == 1) ? 2 : 1;
+    manager.SetMemoryBudget(bytes[0] + bytes[large]);
+    manager.Release(manager.Acquire(0u));
+    manager.Release(manager.Acquire(large));
+    manager.Release(manager.Acquire(0u));
+    passed &= expectClipStats(manager, "two clips that fit", 1, 2, 0);
+    manager.Release(manager.Acquire(other));
+    passed &= expectClipStats(manager, "a third clip", 0, 1, 1);
+    manager.Release(manager.Acquire(0u));
+    manager.Release(manager.Acquire(large));
+    passed &= expectClipStats(manager, "clip 0 kept, the other reloaded", 1, 1, 1);
+
+    // nothing fits: every use loads the clip and every release evicts it
+    manager.SetMemoryBudget(0);
+    manager.ResetStats();
+    for (unsigned int r = 0; r < numRounds; ++r) {
+        for (unsigned int i = 0; i < numClips; ++i) {
+            manager.Release(manager.Acquire(i));
+        }
+    }
+    passed &= expectClipStats(manager, "budget 0", 0, numRounds * numClips, numRounds * numClips);
+    return passed;
+}
+
+// solves numChains random four joint chains towards goals they can reach
+// with IKBatchSolver and with one FABRIKSolver and CCDSolver per chain,
+// and prints how far apart the solved joints are and what both took
+static void compareIK(unsigned int numChains)
+{
+    const unsigned int chainLength = 4;
+    srand(1);
+    std::vector<std::vector<Transform> > chains(numChains);
+    std::vector<Vec3> goals(numChains);
+    for (unsigned int c = 0; c < numChains; ++c) {
+        chains[c].resize(chainLength);
+        Transform world;
+        for (unsigned int i = 0; i < chainLength; ++i) {
+            Transform& local = chains[c][i];
+            local.rotation = randomRotation();
+            if (i == 0) {
+                local.position = Vec3(randomFloat(-10.0f, 10.0f), randomFloat(0.0f, 2.0f), randomFloat(-10.0f, 10.0f));
+            } else {
+                local.position = Vec3(0.0f, randomFloat(0.2f, 0.5f), 0.0f);
+            }
+            // the goal is where the same bones end when bent another way
+            Transform bent = local;
+            bent.rotation = randomRotation();
+            world = (i == 0) ? bent : combine(world, bent);
+        }
+        goals[c] = world.position;
+    }
+
+    IKBatchSolver batch;
+    batch.Resize(numChains, chainLength);
+    for (unsigned int c = 0; c < numChains; ++c) {
+        batch.SetChain(c, chains[c]);
+        batch.SetGoal(c, goals[c]);
+    }
+    std::vector<Vec3> positions(numChains * chainLength);
+
+    FABRIKSolver fabrik;
+    fabrik.Resize(chainLength);
+    unsigned int converged = 0;
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for (unsigned int c = 0; c < numChains; ++c) {
+        for (unsigned int i = 0; i < chainLength; ++i) {
+            fabrik[i] = chains[c][i];
+        }
+        converged += fabrik.Solve(Transform(goals[c], Quat(), Vec3(1, 1, 1))) ? 1 : 0;
+        for (unsigned int i = 0; i < chainLength; ++i) {
+            positions[c * chainLength + i] = fabrik.GetGlobalTransform(i).position;
+        }
+    }
+    float ms = millisecondsSince(start);
+    start = std::chrono::high_resolution_clock::now();
+    unsigned int batchConverged = batch.SolveFABRIK();
+    float batchMs = millisecondsSince(start);
+    printIKComparison("FABRIKSolver", batch, batchConverged, batchMs, positions, converged, ms, goals);
+
+    CCDSolver ccd;
+    ccd.Resize(chainLength);
+    converged = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (unsigned int c = 0; c < numChains; ++c) {
+        for (unsigned int i = 0; i < chainLength; ++i) {
+            ccd[i] = chains[c][i];
+        }
+        converged += ccd.Solve(Transform(goals[c], Quat(), Vec3(1, 1, 1))) ? 1 : 0;
+        for (unsigned int i = 0; i < chainLength; ++i) {
+            positions[c * chainLength + i] = ccd.GetGlobalTransform(i).position;
+        }
+    }
+    ms = millisecondsSince(start);
+    start = std::chrono::high_resolution_clock::now();
+    batchConverged = batch.SolveCCD();
+    batchMs = millisecondsSince(start);
+    printIKComparison("CCDSolver", batch, batchConverged, batchMs, positions, converged, ms, goals);
+}
+
+// signed knee bend of a solved leg around the rig's knee axis, in degrees;
+// negative means the knee bent backwards
+static float kneeBend(const Pose& pose, IKLeg& leg, const CharacterRig& rig)
+{
+    Transform hip = pose.GetGlobalTransform(leg.Hip());
+    Transform knee = pose.GetGlobalTransform(leg.Knee());
+    Transform ankle = pose.GetGlobalTransform(leg.Ankle());
+    Vec3 thigh = normalized(knee.position - hip.position);
+    Vec3 shin = normalized(ankle.position - knee.position);
+    Vec3 axis = knee.rotation * rig.kneeAxis;
+    return atan2f(dot(cross(thigh, shin), axis), dot(thigh, shin)) * 57.2958f;
+}
+
+// solves numLegs Woman.gltf legs, each starting from a random pose of a
+// random clip, towards where the ankle of another clip's pose is, with
+// and without the rig's knee hinge. Every goal is one the knee reaches
+// inside its range; returns false if the hinge leaves more legs short
+// of their goal than the free knees or lets a knee bend backwards
+static bool checkKneeIK(unsigned int numLegs)
+{
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return false;
+    }
+    IKLeg legs[2] = {
+        IKLeg(skeleton, rig.leftLeg[0], rig.leftLeg[1], rig.leftLeg[2], rig.leftLeg[3]),
+        IKLeg(skeleton, rig.rightLeg[0], rig.rightLeg[1], rig.rightLeg[2], rig.rightLeg[3])
+    };
+    IKLeg hinged[2] = { legs[0], legs[1] };
+    for (unsigned int l = 0; l < 2; ++l) {
+        hinged[l].SetKneeConstraint(rig.kneeAxis, rig.kneeMinAngle, rig.kneeMaxAngle);
+    }
+
+    srand(1);
+    const float tolerance = 0.01f;
+    Pose start = skeleton.GetRestPose();
+    Pose other = start;
+    unsigned int converged[2] = { 0, 0 };
+    unsigned int backwards[2] = { 0, 0 };
+    float residual[2] = { 0.0f, 0.0f };
+    float maxResidual[2] = { 0.0f, 0.0f };
+    for (unsigned int n = 0; n < numLegs; ++n) {
+        const Clip& startClip = clips[rand() % clips.size()];
+        const Clip& goalClip = clips[rand() % clips.size()];
+        startClip.Sample(start, startClip.GetStartTime() + randomFloat(0.0f, startClip.GetDuration()));
+        goalClip.Sample(other, goalClip.GetStartTime() + randomFloat(0.0f, goalClip.GetDuration()));
+        unsigned int l = n % 2;
+
+        // the start pose with the other pose's leg: its ankle is the goal
+        Pose goalPose = start;
+        goalPose.SetLocalTransform(legs[l].Hip(), other.GetLocalTransform(legs[l].Hip()));
+        goalPose.SetLocalTransform(legs[l].Knee(), other.GetLocalTransform(legs[l].Knee()));
+        goalPose.SetLocalTransform(legs[l].Ankle(), other.GetLocalTransform(legs[l].Ankle()));
+        Vec3 goal = goalPose.GetGlobalTransform(legs[l].Ankle()).position;
+
+        for (unsigned int h = 0; h < 2; ++h) {
+            IKLeg& leg = (h == 0) ? legs[l] : hinged[l];
+            leg.SolveForLeg(Transform(), start, goal);
+            const Pose& solved = leg.GetAdjustedPose();
+            float r = distance(solved.GetGlobalTransform(leg.Ankle()).position, goal);
+            converged[h] += (r < tolerance) ? 1 : 0;
+            backwards[h] += (kneeBend(solved, leg, rig) < rig.kneeMinAngle - 1.0f) ? 1 : 0;
+            residual[h] += r;
+            maxResidual[h] = std::max(maxResidual[h], r);
+        }
+    }
+    for (unsigned int h = 0; h < 2; ++h) {
+        std::cout << ((h == 0) ? "free knees: " : "hinged knees: ") << converged[h] << " of "
+                  << numLegs << " legs within " << tolerance << ", " << residual[h] / (float)numLegs
+                  << " from the goal on average, " << maxResidual[h] << " at most, "
+                  << backwards[h] << " knees bent backwards" << std::endl;
+    }
+    return converged[1] >= converged[0] && backwards[1] == 0;
+}
+
+// every local transform of a and b is bit for bit the same
+static bool samePose(const Pose& a, const Pose& b)
+{
+    if (a.GetSize() != b.GetSize()) {
+        return false;
+    }
+    for (unsigned int j = 0, size = a.GetSize(); j < size; ++j) {
+        Transform ta = a.GetLocalTransform(j);
+        Transform tb = b.GetLocalTransform(j);
+        if (ta.position.x != tb.position.x || ta.position.y != tb.position.y || ta.position.z != tb.position.z ||
+            ta.rotation.x != tb.rotation.x || ta.rotation.y != tb.rotation.y ||
+            ta.rotation.z != tb.rotation.z || ta.rotation.w != tb.rotation.w ||
+            ta.scale.x != tb.scale.x || ta.scale.y != tb.scale.y || ta.scale.z != tb.scale.z) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// samples numSamples times spread over (and past, to loop) a clip from
+// numThreads threads at once, each from a rest pose and starting at a
+// different sample, and counts the poses that differ from the ones
+// sampled on this thread first
+static unsigned int stressSampler(const std::function<void(Pose&, float)>& sample, const Pose& restPose,
+                                  float startTime, float duration,
+                                  unsigned int numSamples, unsigned int numThreads)
+{
+    std::vector<Pose> expected(numSamples, restPose);
+    for (unsigned int s = 0; s < numSamples; ++s) {
+        sample(expected[s], startTime + duration * 1.5f * (float)s / (float)numSamples);
+    }
+
+    std::atomic<bool> start(false);
+    std::atomic<unsigned int> numDifferent(0);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            while (!start) {
+                std::this_thread::yield();
+            }
+            Pose pose;
+            for (unsigned int i = 0; i < numSamples; ++i) {
+                unsigned int s = (i + t * numSamples / numThreads) % numSamples;
+                pose = restPose;
+                sample(pose, startTime + duration * 1.5f * (float)s / (float)numSamples);
+                if (!samePose(pose, expected[s])) {
+                    ++numDifferent;
+                }
+            }
+        }));
+    }
+    start = true;
+    for (unsigned int t = 0; t < numThreads; ++t) {
+        threads[t].join();
+    }
+    return numDifferent;
+}
+
+// samples one shared Clip, FastClip, TypedClip and ResampledClip of
+// Assets/Woman.gltf numSamples times on each of numThreads threads and
+// compares every pose with a single threaded reference. Build with
+// -fsanitize=thread (see the Makefile) to have races reported too
+static bool stressSampling(unsigned int numSamples, unsigned int numThreads)
+{
+    Skeleton skeleton;
+    std::vector<Mesh> meshes;
+    std::vector<Clip> clips;
+    CharacterRig rig;
+    if (!loadWomanRig(skeleton, meshes, clips, rig)) {
+        return false;
+    }
+    // OptimizeClip takes a clip it can change
+    Clip clip = *rig.clip;
+    FastClip fastClip = OptimizeClip(clip);
+    TypedClip typedClip;
+    typedClip.Set(clip);
+    ResampledClip resampledClip;
+    resampledClip.Set(clip);
+    const Pose& restPose = skeleton.GetRestPose();
+    if (numThreads < 2) {
+        numThreads = 2;
+    }
+
+    const char* names[] = { "Clip", "FastClip", "TypedClip", "ResampledClip" };
+    std::function<void(Pose&, float)> samplers[] = {
+        [&](Pose& pose, float time) { clip.Sample(pose, time); },
+        [&](Pose& pose, float time) { fastClip.Sample(pose, time); },
+        [&](Pose& pose, float time) { typedClip.Sample(pose, time); },
+        [&](Pose& pose, float time) { resampledClip.Sample(pose, time); }
+    };
+    bool passed = true;
+    for (unsigned int i = 0; i < 4; ++i) {
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        unsigned int numDifferent = stressSampler(samplers[i], restPose, clip.GetStartTime(), clip.GetDuration(),
+                                                  numSamples, numThreads);
+        std::cout << names[i] << ": " << numDifferent << " of " << numSamples * numThreads
+                  << " poses differ from the single threaded ones, on " << numThreads << " threads in "
+                  << millisecondsSince(start) << " ms" << std::endl;
+        passed = passed && numDifferent == 0;
+    }
+    std::cout << (passed ? "passed" : "FAILED") << std::endl;
+    return passed;
+}
+
+// pushes lines and points for numItems items from the numThreads threads
+// of a JobSystem, item i drawing i % 3 lines and a point when i is even,
+// then Collects and checks that every item's lines and points arrived and
+// that the thread batches are empty afterwards, for two frames. Returns
+// false otherwise
+static bool checkDebugRenderer(unsigned int numItems, unsigned int numThreads)
+{
+    if (numThreads < 2) {
+        numThreads = 2;
+    }
+    JobSystem jobs(numThreads - 1);
+    DebugRenderer renderer;
+    bool passed = true;
+    for (unsigned int frame = 0; frame < 2; ++frame) {
+        std::vector<std::thread::id> pushedBy(numItems);
+        jobs.ParallelFor("DebugPush", numItems, 0, [&](unsigned int begin, unsigned int end) {
+            for (unsigned int i = begin; i < end; ++i) {
+                Vec3 color((float)frame, 0.0f, 0.0f);
+                for (unsigned int l = 0; l < i % 3; ++l) {
+                    renderer.Line(Vec3((float)i, (float)l, 0.0f), Vec3((float)i, (float)l, 1.0f), color);
+                }
+                if (i % 2 == 0) {
+                    renderer.Point(Vec3((float)i, 0.0f, 0.0f), color);
+                }
+                pushedBy[i] = std::this_thread::get_id();
+            }
+        });
+        jobs.WaitAll();
+
+        DebugBatch batch;
+        renderer.Collect(batch);
+        const std::vector<DebugVertex>& lines = batch.GetLines();
+        const std::vector<DebugVertex>& points = batch.GetPoints();
+        std::vector<unsigned int> numLines(numItems, 0);
+        std::vector<unsigned int> numPoints(numItems, 0);
+        for (unsigned int v = 0; v + 1 < lines.size(); v += 2) {
+            unsigned int i = (unsigned int)lines[v].position.x;
+            if (i < numItems && lines[v + 1].position.x == (float)i && lines[v].color.x == (float)frame) {
+                ++numLines[i];
+            }
+        }
+        for (unsigned int v = 0; v < points.size(); ++v) {
+            unsigned int i = (unsigned int)points[v].position.x;
+            if (i < numItems && points[v].color.x == (float)frame) {
+                ++numPoints[i];
+            }
+        }
+        unsigned int expectedLines = 0;
+        unsigned int expectedPoints = 0;
+        unsigned int wrongItems = 0;
+        for (unsigned int i = 0; i < numItems; ++i) {
+            expectedLines += i % 3;
+            expectedPoints += (i % 2 == 0) ? 1 : 0;
+            if (numLines[i] != i % 3 || numPoints[i] != ((i % 2 == 0) ? 1u : 0u)) {
+                ++wrongItems;
+            }
+        }
+        std::sort(pushedBy.begin(), pushedBy.end());
+        unsigned int numPushers = (unsigned int)(std::unique(pushedBy.begin(), pushedBy.end()) - pushedBy.begin());
+
+        DebugBatch leftover;
+        renderer.Collect(leftover);
+        bool empty = leftover.GetLines().empty() && leftover.GetPoints().empty();
+
+        std::cout << "frame " << frame << ": " << lines.size() / 2 << " lines, " << points.size()
+                  << " points from " << numPushers << " threads (expected " << expectedLines
+                  << " and " << expectedPoints << "), " << wrongItems << " items wrong, batches "
+                  << (empty ? "empty" : "NOT empty") << " after Collect" << std::endl;
+        if (lines.size() != expectedLines * 2 || points.size() != expectedPoints ||
+            wrongItems != 0 || !empty) {
+            passed = false;
+        }
+    }
+    return passed;
+}
+
 int main(int argc, char* argv[])
 {
     const int appWidth = 640;
@@ -50,9 +1393,127 @@ int main(int argc, char* argv[])
     const float appAspect = (float)appWidth / (float)appHeight;
     const bool vsyncEnabled = true;
     
+    // --record N: headless, prints the GL cost of N frames
+    // --jobs N [--threads T]: headless, times N characters animated on
+    // 1 to T threads (defaults to the number of cores)
+    // --world N: headless, times N characters in an AnimationWorld
+    // --schedule N [--budget ms]: headless, time slices N characters
+    // --ik N: headless, compares IKBatchSolver with the per chain solvers
+    // and solves N legs with knee hinges; exits with 1 if one fails
+    // --load N: headless, times importing Woman.gltf and an N vertex asset
+    // --meshopt N: headless, checks the mesh optimizer on Woman.gltf with
+    // N skinned poses; exits with 1 if it fails
+    // --baked N: headless, compares baked and CPU skinning at N columns
+    // --vat N: headless, checks N frame vertex animation textures against
+    // CPU skinning; exits with 1 if it fails
+    // --debug N [--threads T]: headless, pushes debug lines and points for
+    // N items from T threads and checks what Collect gathers; exits with 1
+    // if anything is missing
+    // --clips N: headless, checks the ClipManager's hits, misses and
+    // evictions under small budgets, N rounds at the end; exits with 1
+    // if a count is off
+    // --stress N [--threads T]: headless, samples shared clips N times on
+    // each of T threads (at least 2) and compares with one thread; exits
+    // with 1 if any pose differs
+    unsigned int recordFrames = 0;
+    unsigned int jobCharacters = 0;
+    unsigned int worldCharacters = 0;
+    unsigned int scheduleCharacters = 0;
+    float scheduleBudget = UPDATE_SCHEDULER_DEFAULT_BUDGET_MS;
+    unsigned int ikChains = 0;
+    unsigned int loadVertices = 0;
+    unsigned int meshoptPoses = 0;
+    unsigned int bakedColumns = 0;
+    unsigned int vatFrames = 0;
+    unsigned int clipRounds = 0;
+    unsigned int debugItems = 0;
+    unsigned int stressSamples = 0;
+    unsigned int jobThreads = std::thread::hardware_concurrency();
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0) {
+            recordFrames = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--jobs") == 0) {
+            jobCharacters = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            jobThreads = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--world") == 0) {
+            worldCharacters = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--schedule") == 0) {
+            scheduleCharacters = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--budget") == 0) {
+            scheduleBudget = (float)atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--ik") == 0) {
+            ikChains = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--load") == 0) {
+            loadVertices = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--meshopt") == 0) {
+            meshoptPoses = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--baked") == 0) {
+            bakedColumns = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--vat") == 0) {
+            vatFrames = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--clips") == 0) {
+            clipRounds = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--debug") == 0) {
+            debugItems = (unsigned int)atoi(argv[i + 1]);
+        } else if (strcmp(argv[i], "--stress") == 0) {
+            stressSamples = (unsigned int)atoi(argv[i + 1]);
+        }
+    }
+
+    if (jobCharacters > 0) {
+        benchmarkJobs(jobCharacters, jobThreads);
+        return 0;
+    }
+    if (worldCharacters > 0) {
+        benchmarkWorld(worldCharacters);
+        return 0;
+    }
+    if (scheduleCharacters > 0) {
+        benchmarkSchedule(scheduleCharacters, scheduleBudget);
+        return 0;
+    }
+    if (ikChains > 0) {
+        compareIK(ikChains);
+        return checkKneeIK(ikChains) ? 0 : 1;
+    }
+    if (loadVertices > 0) {
+        benchmarkLoad(loadVertices);
+        return 0;
+    }
+    if (meshoptPoses > 0) {
+        return checkMeshOptimizer(meshoptPoses) ? 0 : 1;
+    }
+    if (bakedColumns > 0) {
+        checkBakedSkinning(bakedColumns);
+        return 0;
+    }
+    if (vatFrames > 0) {
+        return checkVertexAnimation(vatFrames) ? 0 : 1;
+    }
+    if (clipRounds > 0) {
+        return checkClipManager(clipRounds) ? 0 : 1;
+    }
+    if (debugItems > 0) {
+        return checkDebugRenderer(debugItems, jobThreads) ? 0 : 1;
+    }
+    if (stressSamples > 0) {
+        return stressSampling(stressSamples, jobThreads) ? 0 : 1;
+    }
+
     gApplication = new Sample();
+    if (recordFrames > 0) {
+        GLRecorder::Install();
+        gApplication->SetHeadless(true);
+    }
     if (!gApplication->Initialize("Hello World", appWidth, appHeight)) quit();
 
+    if (recordFrames > 0) {
+        record(recordFrames, appAspect);
+        gApplication->Shutdown();
+        quit();
+    }
+
     // OpenGL 3.3 core requires a VAO be bound for all draw calls
     glGenVertexArrays(1, &gVertexArrayObject);
     glBindVertexArray(gVertexArrayObject);